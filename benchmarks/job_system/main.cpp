@@ -0,0 +1,248 @@
+#include <algorithm> // std::min
+#include <atomic> // std::atomic
+#include <cstdio> // std::sscanf
+#include <fstream> // std::ofstream
+#include <functional> // std::function
+#include <iostream> // std::cerr, std::cout
+#include <sstream> // std::ostringstream
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <System/JobSystem.hpp> // System::JobSystem
+#include <System/Timer.hpp> // System::Timer
+
+/*
+ * Stress test and throughput of System::JobSystem
+ *
+ * Usage:
+ * planet_job_system [--threads THREADS] [--affinity 0|1] [--depth DEPTH] [--callers CALLERS] [--runs RUNS] [--out FILE]
+ *
+ * The stress runs trees of jobs spawning 4 children down to DEPTH, and CALLERS threads calling parallelFor
+ * at the same time with nested parallelFor in the jobs, and checks that every job ran once
+ * The throughput is the number of parallelFor indices per second for several grain sizes, the best run is reported
+ * The report is written in JSON, on the standard output or in the --out file, the exit code is 1 if a check failed
+*/
+
+struct Options {
+    // 0 uses one thread per core
+    uint32_t threadsNb = 0;
+    uint32_t affinity = 0;
+    uint32_t depth = 7;
+    uint32_t callersNb = 4;
+    uint32_t runsNb = 5;
+    std::string output;
+};
+
+struct Throughput {
+    uint32_t grainSize;
+    // Indices per second
+    double speed;
+};
+
+static const uint32_t childrenNb = 4;
+static const uint32_t parallelForJobsNb = 1 << 20;
+
+static bool parseUint(const char* value, uint32_t& number) {
+    return std::sscanf(value, "%u", &number) == 1;
+}
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++i];
+        bool valid = true;
+
+        if (argument == "--threads") {
+            valid = parseUint(value, options.threadsNb);
+        }
+        else if (argument == "--affinity") {
+            valid = parseUint(value, options.affinity) && options.affinity <= 1;
+        }
+        else if (argument == "--depth") {
+            valid = parseUint(value, options.depth) && options.depth <= 10;
+        }
+        else if (argument == "--callers") {
+            valid = parseUint(value, options.callersNb) && options.callersNb > 0;
+        }
+        else if (argument == "--runs") {
+            valid = parseUint(value, options.runsNb) && options.runsNb > 0;
+        }
+        else if (argument == "--out") {
+            options.output = value;
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Job of a tree, its children use the counter of the root
+static void runTree(System::JobSystem& jobSystem, System::JobSystem::Counter& counter, uint32_t depth, std::atomic<uint64_t>& jobsNb) {
+    jobsNb.fetch_add(1, std::memory_order_relaxed);
+
+    if (depth == 0) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < childrenNb; ++i) {
+        jobSystem.run([&jobSystem, &counter, depth, &jobsNb]() {
+            runTree(jobSystem, counter, depth - 1, jobsNb);
+        }, counter);
+    }
+}
+
+static bool stressTrees(System::JobSystem& jobSystem, uint32_t depth, float& time) {
+    uint64_t expectedJobsNb = 0;
+    for (uint32_t level = 0, levelJobsNb = 1; level <= depth; ++level, levelJobsNb *= childrenNb) {
+        expectedJobsNb += levelJobsNb;
+    }
+
+    std::atomic<uint64_t> jobsNb{0};
+    System::Timer timer;
+
+    System::JobSystem::Counter counter;
+    jobSystem.run([&jobSystem, &counter, depth, &jobsNb]() {
+        runTree(jobSystem, counter, depth, jobsNb);
+    }, counter);
+    jobSystem.wait(counter);
+
+    time = timer.getElapsedTime();
+
+    if (jobsNb.load() != expectedJobsNb) {
+        std::cerr << "Trees: " << jobsNb.load() << " jobs ran, " << expectedJobsNb << " expected" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Each caller sums the indices of a parallelFor whose jobs run a smaller parallelFor
+static bool stressCallers(System::JobSystem& jobSystem, uint32_t callersNb, float& time) {
+    const uint32_t outerJobsNb = 256;
+    const uint32_t innerJobsNb = 64;
+
+    std::vector<uint64_t> sums(callersNb, 0);
+    System::Timer timer;
+
+    std::vector<std::thread> callers;
+    for (uint32_t caller = 0; caller < callersNb; ++caller) {
+        callers.emplace_back([&jobSystem, &sums, caller, outerJobsNb, innerJobsNb]() {
+            std::atomic<uint64_t> sum{0};
+
+            jobSystem.parallelFor(outerJobsNb, [&jobSystem, &sum, innerJobsNb](uint32_t i) {
+                jobSystem.parallelFor(innerJobsNb, [&sum, i, innerJobsNb](uint32_t j) {
+                    sum.fetch_add(i * innerJobsNb + j, std::memory_order_relaxed);
+                });
+            });
+
+            sums[caller] = sum.load();
+        });
+    }
+
+    for (auto& caller: callers) {
+        caller.join();
+    }
+
+    time = timer.getElapsedTime();
+
+    uint64_t indicesNb = static_cast<uint64_t>(outerJobsNb) * innerJobsNb;
+    uint64_t expectedSum = indicesNb * (indicesNb - 1) / 2;
+    for (uint32_t caller = 0; caller < callersNb; ++caller) {
+        if (sums[caller] != expectedSum) {
+            std::cerr << "Callers: caller " << caller << " sum is " << sums[caller] << ", " << expectedSum << " expected" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static double measureParallelFor(System::JobSystem& jobSystem, uint32_t grainSize, uint32_t runsNb) {
+    std::vector<uint32_t> values(parallelForJobsNb, 0);
+    float bestTime = 0.0f;
+
+    for (uint32_t run = 0; run < runsNb; ++run) {
+        System::Timer timer;
+        jobSystem.parallelFor(parallelForJobsNb, [&values](uint32_t i) {
+            values[i] += i & 7;
+        }, grainSize);
+        float time = timer.getElapsedTime();
+
+        bestTime = run == 0 ? time : std::min(bestTime, time);
+    }
+
+    return parallelForJobsNb / static_cast<double>(bestTime);
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    System::JobSystem::Options jobSystemOptions;
+    jobSystemOptions.threadsNb = options.threadsNb;
+    jobSystemOptions.affinity = options.affinity != 0;
+    System::JobSystem jobSystem(jobSystemOptions);
+
+    bool valid = true;
+    float treesTime = 0.0f;
+    float callersTime = 0.0f;
+
+    for (uint32_t run = 0; run < options.runsNb && valid; ++run) {
+        valid = stressTrees(jobSystem, options.depth, treesTime) && stressCallers(jobSystem, options.callersNb, callersTime);
+    }
+
+    std::vector<Throughput> throughputs;
+    for (uint32_t grainSize: {1u, 64u, 4096u}) {
+        throughputs.push_back({grainSize, measureParallelFor(jobSystem, grainSize, options.runsNb)});
+    }
+
+    std::ostringstream report;
+    report << "{" << std::endl;
+    report << "  \"threads\": " << jobSystem.getThreadsNb() << "," << std::endl;
+    report << "  \"valid\": " << (valid ? "true" : "false") << "," << std::endl;
+    // Seconds of the last run
+    report << "  \"treesTime\": " << treesTime << "," << std::endl;
+    report << "  \"callersTime\": " << callersTime << "," << std::endl;
+    report << "  \"parallelFor\": [" << std::endl;
+
+    for (size_t i = 0; i < throughputs.size(); ++i) {
+        report << "    {"
+            << "\"grain\": " << throughputs[i].grainSize << ", "
+            << "\"indicesPerSecond\": " << throughputs[i].speed << "}"
+            << (i + 1 < throughputs.size() ? "," : "") << std::endl;
+    }
+
+    report << "  ]" << std::endl << "}" << std::endl;
+
+    if (options.output.empty()) {
+        std::cout << report.str();
+        return valid ? 0 : 1;
+    }
+
+    std::ofstream file(options.output);
+    if (!file.good()) {
+        std::cerr << "Can't open \"" << options.output << "\"" << std::endl;
+        return 1;
+    }
+
+    file << report.str();
+
+    return file.good() && valid ? 0 : 1;
+}
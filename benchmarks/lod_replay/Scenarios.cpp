@@ -0,0 +1,181 @@
+#include <cmath> // std::cos, std::floor, std::sin, std::round
+
+#include <glm/geometric.hpp> // glm::normalize
+
+#include "Scenarios.hpp"
+
+namespace Benchmark {
+
+static const float pi = 3.14159265358979f;
+
+static uint32_t getFramesNb(float duration, float timestep) {
+    uint32_t framesNb = static_cast<uint32_t>(std::round(duration / timestep));
+    return framesNb ? framesNb : 1;
+}
+
+Scenario createOrbitScenario(float planetSize, float maxHeight, float duration, float timestep) {
+    Scenario scenario;
+    scenario.name = "orbit";
+
+    float radius = planetSize * 1.6f + maxHeight;
+    uint32_t framesNb = getFramesNb(duration, timestep);
+
+    for (uint32_t i = 0; i < framesNb; ++i) {
+        float time = i * timestep;
+        float angle = 2.0f * pi * time / duration;
+
+        scenario.path.addKeyFrame({
+            time,
+            glm::vec3(std::sin(angle), 0.3f, std::cos(angle)) * radius,
+            glm::vec3(0.0f)
+        });
+    }
+
+    return scenario;
+}
+
+Scenario createDiveScenario(float planetSize, float maxHeight, float duration, float timestep) {
+    Scenario scenario;
+    scenario.name = "dive";
+
+    glm::vec3 direction = glm::normalize(glm::vec3(0.3f, 0.4f, 1.0f));
+    float startDistance = planetSize * 5.0f;
+    float endDistance = planetSize + maxHeight * 1.2f;
+    uint32_t framesNb = getFramesNb(duration, timestep);
+
+    for (uint32_t i = 0; i < framesNb; ++i) {
+        float time = i * timestep;
+        // Slow down when getting close to the surface
+        float remaining = 1.0f - time / duration;
+        float distance = endDistance + (startDistance - endDistance) * remaining * remaining;
+
+        scenario.path.addKeyFrame({
+            time,
+            direction * distance,
+            glm::vec3(0.0f)
+        });
+    }
+
+    return scenario;
+}
+
+Scenario createSkimScenario(float planetSize, float maxHeight, float duration, float timestep) {
+    Scenario scenario;
+    scenario.name = "skim";
+
+    glm::vec3 u = {1.0f, 0.0f, 0.0f};
+    glm::vec3 v = glm::normalize(glm::vec3(0.0f, 0.5f, 1.0f));
+    float radius = planetSize + maxHeight * 1.5f;
+    uint32_t framesNb = getFramesNb(duration, timestep);
+
+    for (uint32_t i = 0; i < framesNb; ++i) {
+        float time = i * timestep;
+        // A quarter of the planet
+        float angle = 0.5f * pi * time / duration;
+        glm::vec3 pos = (u * std::cos(angle) + v * std::sin(angle)) * radius;
+        glm::vec3 tangent = v * std::cos(angle) - u * std::sin(angle);
+
+        scenario.path.addKeyFrame({
+            time,
+            pos,
+            pos + tangent * planetSize
+        });
+    }
+
+    return scenario;
+}
+
+Scenario createTeleportScenario(float planetSize, float maxHeight, float duration, float timestep) {
+    Scenario scenario;
+    scenario.name = "teleport";
+
+    const glm::vec3 viewPoints[] = {
+        glm::vec3(0.0f, 0.0f, 1.0f) * (planetSize * 1.5f),
+        glm::vec3(1.0f, 0.0f, 0.0f) * (planetSize + maxHeight * 2.0f),
+        glm::vec3(0.0f, -1.0f, 0.0f) * (planetSize * 3.0f),
+        glm::normalize(glm::vec3(-1.0f, 1.0f, -1.0f)) * (planetSize + maxHeight * 1.5f)
+    };
+    const uint32_t viewPointsNb = sizeof(viewPoints) / sizeof(viewPoints[0]);
+
+    // Each view point is visited twice
+    float viewPointDuration = duration / (viewPointsNb * 2);
+    uint32_t framesNb = getFramesNb(duration, timestep);
+
+    for (uint32_t i = 0; i < framesNb; ++i) {
+        float time = i * timestep;
+        uint32_t viewPoint = static_cast<uint32_t>(time / viewPointDuration) % viewPointsNb;
+
+        scenario.path.addKeyFrame({
+            time,
+            viewPoints[viewPoint],
+            glm::vec3(0.0f)
+        });
+    }
+
+    return scenario;
+}
+
+Scenario createBounceScenario(float planetSize, float maxHeight, float duration, float timestep) {
+    Scenario scenario;
+    scenario.name = "bounce";
+
+    glm::vec3 direction = glm::normalize(glm::vec3(-0.6f, 0.2f, 1.0f));
+    float topDistance = planetSize * 2.0f;
+    float surfaceDistance = planetSize + maxHeight * 1.2f;
+    const uint32_t bouncesNb = 6;
+    uint32_t framesNb = getFramesNb(duration, timestep);
+
+    for (uint32_t i = 0; i < framesNb; ++i) {
+        float time = i * timestep;
+        float bounce = time * bouncesNb / duration;
+        // The first dive is the deepest, the next ones turn back over the quadtrees it split
+        float bottomDistance = surfaceDistance + (topDistance - surfaceDistance) * 0.05f * std::floor(bounce);
+        float depth = 0.5f - 0.5f * std::cos(2.0f * pi * bounce);
+        float distance = topDistance + (bottomDistance - topDistance) * depth;
+
+        scenario.path.addKeyFrame({
+            time,
+            direction * distance,
+            glm::vec3(0.0f)
+        });
+    }
+
+    return scenario;
+}
+
+bool createScenarios(
+    const std::string& name,
+    float planetSize,
+    float maxHeight,
+    float duration,
+    float timestep,
+    std::vector<Scenario>& scenarios
+) {
+    bool all = name == "all";
+    bool found = false;
+
+    if (all || name == "orbit") {
+        scenarios.push_back(createOrbitScenario(planetSize, maxHeight, duration, timestep));
+        found = true;
+    }
+    if (all || name == "dive") {
+        scenarios.push_back(createDiveScenario(planetSize, maxHeight, duration, timestep));
+        found = true;
+    }
+    if (all || name == "skim") {
+        scenarios.push_back(createSkimScenario(planetSize, maxHeight, duration, timestep));
+        found = true;
+    }
+    if (all || name == "teleport") {
+        scenarios.push_back(createTeleportScenario(planetSize, maxHeight, duration, timestep));
+        found = true;
+    }
+    if (all || name == "bounce") {
+        scenarios.push_back(createBounceScenario(planetSize, maxHeight, duration, timestep));
+        found = true;
+    }
+
+    return found;
+}
+
+} // Namespace Benchmark
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <Core/CameraPath.hpp> // Core::CameraPath
+
+namespace Benchmark {
+
+struct Scenario {
+    std::string name;
+    Core::CameraPath path;
+};
+
+/*
+ * Scripted camera paths, with one key frame per timestep so they are replayed exactly
+ * - orbit: circle around the planet at a constant altitude
+ * - dive: from far away down to the surface
+ * - skim: low altitude flight along a great circle, looking at the horizon
+ * - teleport: jumps between distant points of view
+ * - bounce: dives of decreasing depth toward the same point, the prefetch takes the cached quadtrees and releases them when the camera turns back
+*/
+Scenario createOrbitScenario(float planetSize, float maxHeight, float duration, float timestep);
+Scenario createDiveScenario(float planetSize, float maxHeight, float duration, float timestep);
+Scenario createSkimScenario(float planetSize, float maxHeight, float duration, float timestep);
+Scenario createTeleportScenario(float planetSize, float maxHeight, float duration, float timestep);
+Scenario createBounceScenario(float planetSize, float maxHeight, float duration, float timestep);
+
+// Returns false if name is not a scripted scenario ("all" creates all of them)
+bool createScenarios(
+    const std::string& name,
+    float planetSize,
+    float maxHeight,
+    float duration,
+    float timestep,
+    std::vector<Scenario>& scenarios
+);
+
+} // Namespace Benchmark
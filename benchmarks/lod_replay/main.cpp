@@ -0,0 +1,528 @@
+#include <algorithm> // std::sort, std::min, std::max
+#include <atomic> // std::atomic
+#include <cmath> // std::ceil
+#include <cstdio> // std::snprintf, std::sscanf
+#include <cstring> // std::memcpy
+#include <fstream> // std::ofstream
+#include <iostream> // std::cerr, std::cout
+#include <memory> // std::unique_ptr
+#include <sstream> // std::ostringstream
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <Core/CameraPath.hpp> // Core::CameraPath
+#include <Core/LodGovernor.hpp> // Core::LodGovernor
+#include <Core/SphereQuadTree.hpp> // Core::SphereQuadTree
+#include <Graphics/Camera.hpp> // Graphics::Camera
+#include <System/Profiler.hpp> // System::Profiler
+#include <System/Timer.hpp> // System::Timer
+
+#include "Scenarios.hpp"
+
+/*
+ * Replays camera paths through the LOD pipeline at a fixed timestep, without OpenGL
+ *
+ * Usage:
+ * planet_lod_replay [--path orbit|dive|skim|teleport|bounce|all] [--path-file FILE]
+ *                   [--size SIZE] [--maxHeight HEIGHT] [--duration SECONDS] [--timestep SECONDS] [--out FILE]
+ *                   [--trace FILE] [--readers READERS] [--budget MILLISECONDS]
+ *                   [--coherence 0|1] [--prefetch UPDATES] [--cache KILOBYTES]
+ *                   [--maxNodes NODES] [--maxVertices KILOBYTES]
+ *
+ * Each frame is split in three steps, timed separately:
+ * - update: split and merge of the quadtrees (SphereQuadTree::updateQuadTrees)
+ * - emission: generation of the vertices and indices (SphereQuadTree::updateMeshes)
+ * - upload: copy of the mesh in a staging buffer, the CPU side of Graphics::Planet upload
+ *
+ * With --coherence 0, the updates evaluate all the quadtrees instead of keeping the decisions the camera can't change
+ * --prefetch is the number of updates the camera position is extrapolated by to prefetch the quadtrees, 0 disables it
+ * --cache is the memory of the merged quadtrees kept for the next splits, 0 disables the cache
+ * --maxNodes and --maxVertices are the limits of the planet budget (see Core::LodBudget), 0 is unlimited
+ * With --budget, a Core::LodGovernor scales the LOD to keep the time of the three steps close to the budget
+ * With --readers, READERS threads walk the quadtrees in loop while they are updated (SphereQuadTree::walk)
+ *
+ * The report is written in JSON, on the standard output or in the --out file
+ * With PLANET_PROFILER, --trace exports the profiler zones in the Chrome trace format
+*/
+
+struct Options {
+    std::string path = "all";
+    std::string pathFile;
+    float size = 100.0f;
+    float maxHeight = 20.0f;
+    float duration = 10.0f;
+    float timestep = 1.0f / 60.0f;
+    std::string output;
+    std::string trace;
+    uint32_t readersNb = 0;
+    // Milliseconds, 0 disables the LOD governor
+    float budget = 0.0f;
+    uint32_t coherence = 1;
+    uint32_t prefetch = Core::SphereQuadTree::PrefetchSettings().lookahead;
+    // Kilobytes, 0 disables the nodes cache
+    uint32_t cache = 1024;
+    // Limits of the planet budget, 0 is unlimited
+    uint32_t maxNodesNb = 0;
+    // Kilobytes
+    uint32_t maxVerticesSize = 0;
+};
+
+struct FrameStats {
+    float updateTime;
+    float emissionTime;
+    float uploadTime;
+    uint32_t nodesNb;
+    uint32_t evaluatedNodesNb;
+    uint32_t verticesNb;
+    uint32_t trianglesNb;
+    uint32_t retiredNodesNb;
+    float lodScale;
+    uint32_t splitsNb;
+    uint32_t prefetchedNodesNb;
+    uint32_t cachedNodesNb;
+    uint32_t deferredSplitsNb;
+    float budgetScale;
+};
+
+struct ScenarioStats {
+    std::vector<FrameStats> frames;
+    // Walks of the --readers threads
+    uint64_t walksNb = 0;
+    uint64_t walkedNodesNb = 0;
+    // Splits which used the prefetched children
+    uint64_t prefetchedSplitsNb = 0;
+    // Children looked up in the nodes cache
+    uint64_t cacheHitsNb = 0;
+    uint64_t cacheMissesNb = 0;
+};
+
+static bool parseFloat(const char* value, float& number) {
+    return std::sscanf(value, "%f", &number) == 1;
+}
+
+static bool parseUint(const char* value, uint32_t& number) {
+    return std::sscanf(value, "%u", &number) == 1;
+}
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++i];
+        bool valid = true;
+
+        if (argument == "--path") {
+            options.path = value;
+        }
+        else if (argument == "--path-file") {
+            options.pathFile = value;
+        }
+        else if (argument == "--size") {
+            valid = parseFloat(value, options.size) && options.size > 0.0f;
+        }
+        else if (argument == "--maxHeight") {
+            valid = parseFloat(value, options.maxHeight);
+        }
+        else if (argument == "--duration") {
+            valid = parseFloat(value, options.duration) && options.duration > 0.0f;
+        }
+        else if (argument == "--timestep") {
+            valid = parseFloat(value, options.timestep) && options.timestep > 0.0f;
+        }
+        else if (argument == "--out") {
+            options.output = value;
+        }
+        else if (argument == "--trace") {
+#if defined(PLANET_PROFILER)
+            options.trace = value;
+#else
+            std::cerr << "--trace needs the profiler, build with -DPLANET_PROFILER=ON" << std::endl;
+            return false;
+#endif
+        }
+        else if (argument == "--budget") {
+            valid = parseFloat(value, options.budget) && options.budget >= 0.0f;
+        }
+        else if (argument == "--coherence") {
+            valid = parseUint(value, options.coherence) && options.coherence <= 1;
+        }
+        else if (argument == "--prefetch") {
+            valid = parseUint(value, options.prefetch);
+        }
+        else if (argument == "--cache") {
+            valid = parseUint(value, options.cache);
+        }
+        else if (argument == "--maxNodes") {
+            valid = parseUint(value, options.maxNodesNb);
+        }
+        else if (argument == "--maxVertices") {
+            valid = parseUint(value, options.maxVerticesSize);
+        }
+        else if (argument == "--readers") {
+            valid = parseUint(value, options.readersNb);
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static ScenarioStats replay(const Options& options, const Core::CameraPath& path) {
+    ScenarioStats stats;
+
+    // Each scenario starts with a new planet so the results don't depend on the previous scenarios
+    std::unique_ptr<Core::SphereQuadTree> planet = Core::SphereQuadTree::create(options.size, options.maxHeight);
+    planet->temporalCoherence(options.coherence != 0);
+
+    Core::SphereQuadTree::PrefetchSettings prefetchSettings = planet->getPrefetchSettings();
+    prefetchSettings.lookahead = options.prefetch;
+    planet->setPrefetchSettings(prefetchSettings);
+    planet->setNodesCacheSize(static_cast<size_t>(options.cache) * 1024);
+
+    Core::LodBudget::Limits limits;
+    limits.nodesNb = options.maxNodesNb;
+    limits.verticesSize = static_cast<uint64_t>(options.maxVerticesSize) * 1024;
+    planet->getBudget().setLimits(limits);
+    uint64_t splitsNb = 0;
+
+    Graphics::Camera camera;
+    camera.setNear(1.0f);
+    camera.setFar(9999999.0f);
+    camera.setAspect(16.0f / 9.0f);
+
+    std::vector<char> stagingBuffer;
+    System::Timer timer;
+
+    Core::LodGovernor::Settings governorSettings;
+    governorSettings.targetFrameTime = options.budget / 1000.0f;
+    Core::LodGovernor governor(governorSettings);
+
+    std::atomic<bool> stopReaders{false};
+    std::atomic<uint64_t> walksNb{0};
+    std::atomic<uint64_t> walkedNodesNb{0};
+    std::vector<std::thread> readers;
+
+    for (uint32_t i = 0; i < options.readersNb; ++i) {
+        readers.emplace_back([&planet, &stopReaders, &walksNb, &walkedNodesNb]() {
+            while (!stopReaders.load(std::memory_order_relaxed)) {
+                uint32_t nodesNb = 0;
+                planet->walk([&nodesNb](const Core::QuadTree&) {
+                    ++nodesNb;
+                    return true;
+                });
+
+                walksNb.fetch_add(1, std::memory_order_relaxed);
+                walkedNodesNb.fetch_add(nodesNb, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    float duration = path.getDuration();
+    for (uint32_t frameNb = 0; frameNb * options.timestep <= duration; ++frameNb) {
+        float time = frameNb * options.timestep;
+        FrameStats frame;
+
+        PROFILE_FRAME();
+
+        path.apply(time, camera);
+
+        timer.reset();
+        planet->updateQuadTrees(camera);
+        frame.updateTime = timer.getElapsedTime();
+
+        timer.reset();
+        planet->updateMeshes();
+        frame.emissionTime = timer.getElapsedTime();
+
+        timer.reset();
+        {
+            const auto& mesh = planet->getMesh();
+            size_t verticesSize = mesh.vertices.size() * sizeof(Core::QuadTree::Vertex);
+            size_t indicesSize = mesh.indices.size() * sizeof(uint32_t);
+
+            if (stagingBuffer.size() < verticesSize + indicesSize) {
+                stagingBuffer.resize(verticesSize + indicesSize);
+            }
+
+            std::memcpy(stagingBuffer.data(), mesh.vertices.data(), verticesSize);
+            std::memcpy(stagingBuffer.data() + verticesSize, mesh.indices.data(), indicesSize);
+        }
+        frame.uploadTime = timer.getElapsedTime();
+
+        frame.nodesNb = planet->getNodesNb();
+        frame.evaluatedNodesNb = planet->getEvaluatedNodesNb();
+        frame.verticesNb = planet->getMesh().vertices.size();
+        frame.trianglesNb = planet->getMesh().indices.size() / 3;
+        frame.retiredNodesNb = planet->getRetiredNodesNb();
+        frame.lodScale = planet->getLodScale();
+
+        Core::SphereQuadTree::PrefetchStatistics prefetchStatistics = planet->getPrefetchStatistics();
+        frame.splitsNb = static_cast<uint32_t>(prefetchStatistics.splitsNb - splitsNb);
+        frame.prefetchedNodesNb = prefetchStatistics.prefetchedNodesNb;
+        splitsNb = prefetchStatistics.splitsNb;
+        stats.prefetchedSplitsNb = prefetchStatistics.prefetchedSplitsNb;
+
+        Core::SphereQuadTree::NodesCacheStatistics cacheStatistics = planet->getNodesCacheStatistics();
+        frame.cachedNodesNb = cacheStatistics.cachedNodesNb;
+        stats.cacheHitsNb = cacheStatistics.hitsNb;
+        stats.cacheMissesNb = cacheStatistics.missesNb;
+
+        frame.deferredSplitsNb = planet->getDeferredSplitsNb();
+        frame.budgetScale = planet->getBudgetScale();
+
+        if (options.budget > 0.0f) {
+            planet->setLodScale(governor.update(frame.updateTime + frame.emissionTime + frame.uploadTime));
+        }
+
+        stats.frames.push_back(frame);
+    }
+
+    stopReaders = true;
+    for (auto& reader: readers) {
+        reader.join();
+    }
+
+    stats.walksNb = walksNb.load();
+    stats.walkedNodesNb = walkedNodesNb.load();
+
+    return stats;
+}
+
+// The names of the --path-file scenarios are file paths, with backslashes on Windows
+static std::string escapeJson(const std::string& string) {
+    std::string escaped;
+
+    for (char c: string) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20) {
+            char code[7];
+            std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned int>(c));
+            escaped += code;
+        }
+        else {
+            escaped += c;
+        }
+    }
+
+    return escaped;
+}
+
+// Nearest rank percentile of sorted values
+static float getPercentile(const std::vector<float>& sortedValues, float percentile) {
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0f * sortedValues.size()));
+    return sortedValues[std::max<size_t>(rank, 1) - 1];
+}
+
+static void writeTimeStats(std::ostream& stream, const char* name, std::vector<float> times) {
+    float total = 0.0f;
+    for (float& time: times) {
+        // Milliseconds
+        time *= 1000.0f;
+        total += time;
+    }
+
+    std::sort(times.begin(), times.end());
+
+    stream << "      \"" << name << "\": {"
+        << "\"mean\": " << total / times.size() << ", "
+        << "\"p50\": " << getPercentile(times, 50.0f) << ", "
+        << "\"p95\": " << getPercentile(times, 95.0f) << ", "
+        << "\"p99\": " << getPercentile(times, 99.0f) << ", "
+        << "\"max\": " << times.back() << "}";
+}
+
+static void writeCountStats(std::ostream& stream, const char* name, const std::vector<uint32_t>& counts) {
+    uint64_t total = 0;
+    uint32_t min = counts.front();
+    uint32_t max = counts.front();
+
+    for (uint32_t count: counts) {
+        total += count;
+        min = std::min(min, count);
+        max = std::max(max, count);
+    }
+
+    stream << "      \"" << name << "\": {"
+        << "\"min\": " << min << ", "
+        << "\"mean\": " << static_cast<double>(total) / counts.size() << ", "
+        << "\"max\": " << max << "}";
+}
+
+static void writeValueStats(std::ostream& stream, const char* name, const std::vector<float>& values) {
+    float total = 0.0f;
+    float min = values.front();
+    float max = values.front();
+
+    for (float value: values) {
+        total += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    stream << "      \"" << name << "\": {"
+        << "\"min\": " << min << ", "
+        << "\"mean\": " << total / values.size() << ", "
+        << "\"max\": " << max << "}";
+}
+
+static void writeScenario(std::ostream& stream, const std::string& name, const ScenarioStats& stats) {
+    const std::vector<FrameStats>& frames = stats.frames;
+
+    std::vector<float> updateTimes;
+    std::vector<float> emissionTimes;
+    std::vector<float> uploadTimes;
+    std::vector<uint32_t> nodesNbs;
+    std::vector<uint32_t> evaluatedNodesNbs;
+    std::vector<uint32_t> verticesNbs;
+    std::vector<uint32_t> trianglesNbs;
+    std::vector<uint32_t> retiredNodesNbs;
+    std::vector<float> lodScales;
+    std::vector<uint32_t> splitsNbs;
+    std::vector<uint32_t> prefetchedNodesNbs;
+    std::vector<uint32_t> cachedNodesNbs;
+    std::vector<uint32_t> deferredSplitsNbs;
+    std::vector<float> budgetScales;
+
+    for (const auto& frame: frames) {
+        updateTimes.push_back(frame.updateTime);
+        emissionTimes.push_back(frame.emissionTime);
+        uploadTimes.push_back(frame.uploadTime);
+        nodesNbs.push_back(frame.nodesNb);
+        evaluatedNodesNbs.push_back(frame.evaluatedNodesNb);
+        verticesNbs.push_back(frame.verticesNb);
+        trianglesNbs.push_back(frame.trianglesNb);
+        retiredNodesNbs.push_back(frame.retiredNodesNb);
+        lodScales.push_back(frame.lodScale);
+        splitsNbs.push_back(frame.splitsNb);
+        prefetchedNodesNbs.push_back(frame.prefetchedNodesNb);
+        cachedNodesNbs.push_back(frame.cachedNodesNb);
+        deferredSplitsNbs.push_back(frame.deferredSplitsNb);
+        budgetScales.push_back(frame.budgetScale);
+    }
+
+    stream << "    {" << std::endl;
+    stream << "      \"name\": \"" << escapeJson(name) << "\"," << std::endl;
+    stream << "      \"frames\": " << frames.size() << "," << std::endl;
+    writeTimeStats(stream, "update_ms", updateTimes);
+    stream << "," << std::endl;
+    writeTimeStats(stream, "emission_ms", emissionTimes);
+    stream << "," << std::endl;
+    writeTimeStats(stream, "upload_ms", uploadTimes);
+    stream << "," << std::endl;
+    writeCountStats(stream, "nodes", nodesNbs);
+    stream << "," << std::endl;
+    writeCountStats(stream, "evaluatedNodes", evaluatedNodesNbs);
+    stream << "," << std::endl;
+    writeCountStats(stream, "vertices", verticesNbs);
+    stream << "," << std::endl;
+    writeCountStats(stream, "triangles", trianglesNbs);
+    stream << "," << std::endl;
+    // Merged quadtrees still read by a walk after the update
+    writeCountStats(stream, "retiredNodes", retiredNodesNbs);
+    stream << "," << std::endl;
+    writeValueStats(stream, "lodScale", lodScales);
+    stream << "," << std::endl;
+    writeCountStats(stream, "splits", splitsNbs);
+    stream << "," << std::endl;
+    // Generated ahead of the camera and not displayed yet
+    writeCountStats(stream, "prefetchedNodes", prefetchedNodesNbs);
+    stream << "," << std::endl;
+    stream << "      \"prefetchedSplits\": " << stats.prefetchedSplitsNb << "," << std::endl;
+    // Merged quadtrees kept for the next splits
+    writeCountStats(stream, "cachedNodes", cachedNodesNbs);
+    stream << "," << std::endl;
+    stream << "      \"cacheHits\": " << stats.cacheHitsNb << "," << std::endl;
+    stream << "      \"cacheMisses\": " << stats.cacheMissesNb << "," << std::endl;
+    // Splits refused by the budget, and the scale of the split distances it applied
+    writeCountStats(stream, "deferredSplits", deferredSplitsNbs);
+    stream << "," << std::endl;
+    writeValueStats(stream, "budgetScale", budgetScales);
+    stream << "," << std::endl;
+    stream << "      \"walks\": " << stats.walksNb << "," << std::endl;
+    stream << "      \"walkedNodes\": " << stats.walkedNodesNb;
+    stream << std::endl << "    }";
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    std::vector<Benchmark::Scenario> scenarios;
+    if (!options.pathFile.empty()) {
+        Benchmark::Scenario scenario;
+        scenario.name = options.pathFile;
+
+        if (!scenario.path.loadFromFile(options.pathFile) || scenario.path.isEmpty()) {
+            std::cerr << "Can't load camera path \"" << options.pathFile << "\"" << std::endl;
+            return 1;
+        }
+
+        scenarios.push_back(std::move(scenario));
+    }
+    else if (!Benchmark::createScenarios(
+        options.path,
+        options.size,
+        options.maxHeight,
+        options.duration,
+        options.timestep,
+        scenarios
+    )) {
+        std::cerr << "Unknown path \"" << options.path << "\" (orbit, dive, skim, teleport, bounce or all)" << std::endl;
+        return 1;
+    }
+
+    std::ostringstream report;
+    report << "{" << std::endl;
+    report << "  \"size\": " << options.size << "," << std::endl;
+    report << "  \"maxHeight\": " << options.maxHeight << "," << std::endl;
+    report << "  \"timestep\": " << options.timestep << "," << std::endl;
+    report << "  \"scenarios\": [" << std::endl;
+
+    for (size_t i = 0; i < scenarios.size(); ++i) {
+        ScenarioStats stats = replay(options, scenarios[i].path);
+
+        writeScenario(report, scenarios[i].name, stats);
+        report << (i + 1 < scenarios.size() ? "," : "") << std::endl;
+    }
+
+    report << "  ]" << std::endl;
+    report << "}" << std::endl;
+
+    if (!options.trace.empty() && !System::Profiler::exportChromeTrace(options.trace)) {
+        return 1;
+    }
+
+    if (options.output.empty()) {
+        std::cout << report.str();
+        return 0;
+    }
+
+    std::ofstream file(options.output);
+    if (!file.good()) {
+        std::cerr << "Can't open \"" << options.output << "\"" << std::endl;
+        return 1;
+    }
+
+    file << report.str();
+
+    return file.good() ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+#include <random> // std::mt19937, std::uniform_real_distribution
+#include <vector> // std::vector
+
+#include <benchmark/benchmark.h> // benchmark::State
+
+#include <Graphics/Camera.hpp> // Graphics::Camera
+#include <Graphics/Frustum.hpp> // Graphics::Frustum
+
+#include "Items.hpp"
+
+struct Box {
+    glm::vec3 corners[8];
+};
+
+static void BM_Frustum_isAABBInside(benchmark::State& state) {
+    Graphics::Camera camera;
+    camera.setNear(1.0f);
+    camera.setFar(9999999.0f);
+    camera.setPos({0.0f, 0.0f, 150.0f});
+    camera.lookAt({0.0f, 0.0f, 0.0f});
+
+    const Graphics::Frustum& frustum = camera.getFrustum();
+
+    // Boxes around the planet, part of them outside the frustum
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> extent(1.0f, 20.0f);
+    std::vector<Box> boxes(1024);
+    for (auto& box: boxes) {
+        glm::vec3 min = {position(generator), position(generator), position(generator)};
+        glm::vec3 max = min + glm::vec3(extent(generator), extent(generator), extent(generator));
+
+        for (uint32_t i = 0; i < 8; ++i) {
+            box.corners[i] = {
+                i & 1 ? max.x : min.x,
+                i & 2 ? max.y : min.y,
+                i & 4 ? max.z : min.z
+            };
+        }
+    }
+
+    for (auto _: state) {
+        for (const auto& box: boxes) {
+            benchmark::DoNotOptimize(frustum.isAABBInside(
+                box.corners[0],
+                box.corners[1],
+                box.corners[2],
+                box.corners[3],
+                box.corners[4],
+                box.corners[5],
+                box.corners[6],
+                box.corners[7]
+            ));
+        }
+    }
+
+    setItemsProcessed(state, boxes.size());
+}
+BENCHMARK(BM_Frustum_isAABBInside);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h> // benchmark::State
+
+#include <Core/GradientMapGenerator.hpp> // Core::GradientMapGenerator
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+#include <System/JobSystem.hpp> // System::JobSystem
+
+#include "Items.hpp"
+
+static const uint32_t faceSize = 256;
+
+// Gradients of the 6 faces on one thread, with the AVX2 kernel if range(0) is set (and supported)
+// range(1) selects the filter: 0 Sobel, 1 central differences
+static void BM_GradientMapGenerator_generate(benchmark::State& state) {
+    if (state.range(0) && !Core::GradientMapGenerator::isAVX2Supported()) {
+        state.SkipWithError("AVX2 not supported");
+        return;
+    }
+
+    System::JobSystem jobSystem(1);
+
+    Core::HeightMapGenerator::Parameters parameters;
+    parameters.size = faceSize;
+
+    Core::HeightMapGenerator::Faces heights;
+    Core::HeightMapGenerator(parameters).generate(heights, jobSystem);
+
+    Core::GradientMapGenerator generator(faceSize, static_cast<Core::GradientMapGenerator::Filter>(state.range(1)));
+    generator.setAVX2Enabled(state.range(0) != 0);
+
+    Core::GradientMapGenerator::Faces gradients;
+
+    for (auto _: state) {
+        generator.generate(heights, gradients, jobSystem);
+        benchmark::ClobberMemory();
+    }
+
+    setItemsProcessed(state, Core::CubeMap::facesNb * faceSize * faceSize);
+}
+BENCHMARK(BM_GradientMapGenerator_generate)->ArgNames({"avx2", "filter"})->ArgsProduct({{0, 1}, {0, 1}});
+
+// Update after an edit of range(0) * range(0) heights at the corner of a face, so 3 faces are updated
+static void BM_GradientMapGenerator_update(benchmark::State& state) {
+    System::JobSystem jobSystem(1);
+
+    Core::HeightMapGenerator::Parameters parameters;
+    parameters.size = faceSize;
+
+    Core::HeightMapGenerator::Faces heights;
+    Core::HeightMapGenerator(parameters).generate(heights, jobSystem);
+
+    Core::GradientMapGenerator generator(faceSize);
+    Core::GradientMapGenerator::Faces gradients;
+    generator.generate(heights, gradients, jobSystem);
+
+    uint32_t editSize = static_cast<uint32_t>(state.range(0));
+    Core::GradientMapGenerator::Rect rect = {0, 0, editSize, editSize};
+
+    for (auto _: state) {
+        generator.update(heights, Core::CubeMap::Face::POSITIVE_Z, rect, gradients, jobSystem);
+        benchmark::ClobberMemory();
+    }
+
+    setItemsProcessed(state, editSize * editSize);
+}
+BENCHMARK(BM_GradientMapGenerator_update)->ArgName("edit")->Arg(16)->Arg(64);
@@ -0,0 +1,48 @@
+#include <vector> // std::vector
+
+#include <benchmark/benchmark.h> // benchmark::State
+
+#include <glm/geometric.hpp> // glm::normalize
+
+#include <Core/CubeMap.hpp> // Core::CubeMap
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+
+#include "Items.hpp"
+
+// Heights of one row of a 2048 face, with the AVX2 kernel if range(0) is set (and supported)
+// range(1) selects the noise: 0 fBm, 1 ridged, 2 fBm with domain warping
+static void BM_HeightMapGenerator_row(benchmark::State& state) {
+    if (state.range(0) && !Core::HeightMapGenerator::isAVX2Supported()) {
+        state.SkipWithError("AVX2 not supported");
+        return;
+    }
+
+    Core::HeightMapGenerator::Parameters parameters;
+    parameters.noiseType = state.range(1) == 1 ? Core::HeightMapGenerator::NoiseType::RIDGED : Core::HeightMapGenerator::NoiseType::FBM;
+    parameters.warpStrength = state.range(1) == 2 ? 0.3f : 0.0f;
+
+    Core::HeightMapGenerator generator(parameters);
+    generator.setAVX2Enabled(state.range(0) != 0);
+
+    const uint32_t size = 2048;
+    std::vector<float> x(size);
+    std::vector<float> y(size);
+    std::vector<float> z(size);
+    std::vector<float> heights(size);
+
+    for (uint32_t column = 0; column < size; ++column) {
+        glm::vec3 direction = glm::normalize(Core::CubeMap::getDirection(Core::CubeMap::Face::POSITIVE_Z, column, size / 2, size));
+
+        x[column] = direction.x;
+        y[column] = direction.y;
+        z[column] = direction.z;
+    }
+
+    for (auto _: state) {
+        generator.generate(x.data(), y.data(), z.data(), heights.data(), size);
+        benchmark::ClobberMemory();
+    }
+
+    setItemsProcessed(state, size);
+}
+BENCHMARK(BM_HeightMapGenerator_row)->ArgNames({"avx2", "noise"})->ArgsProduct({{0, 1}, {0, 1, 2}});
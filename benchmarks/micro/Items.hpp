@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint> // int64_t
+
+#include <benchmark/benchmark.h> // benchmark::State, benchmark::Counter
+
+// Most benchmarks process a batch of items per iteration:
+// report the items per second and the time per item, in addition of the time per iteration
+inline void setItemsProcessed(benchmark::State& state, int64_t itemsNbPerIteration) {
+    int64_t itemsNb = state.iterations() * itemsNbPerIteration;
+
+    state.SetItemsProcessed(itemsNb);
+    state.counters["s_per_item"] = benchmark::Counter(
+        static_cast<double>(itemsNb),
+        benchmark::Counter::kIsRate | benchmark::Counter::kInvert
+    );
+}
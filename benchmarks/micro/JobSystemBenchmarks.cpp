@@ -0,0 +1,42 @@
+#include <atomic> // std::atomic
+
+#include <benchmark/benchmark.h> // benchmark::State
+
+#include <System/JobSystem.hpp> // System::JobSystem
+
+#include "Items.hpp"
+
+// Overhead of parallelFor on range(0) indices doing almost nothing, in ranges of range(1) indices
+static void BM_JobSystem_parallelFor(benchmark::State& state) {
+    System::JobSystem jobSystem;
+    uint32_t jobsNb = static_cast<uint32_t>(state.range(0));
+    uint32_t grainSize = static_cast<uint32_t>(state.range(1));
+    std::atomic<uint32_t> sum{0};
+
+    for (auto _: state) {
+        jobSystem.parallelFor(jobsNb, [&sum](uint32_t i) {
+            sum.fetch_add(i & 1, std::memory_order_relaxed);
+        }, grainSize);
+    }
+
+    benchmark::DoNotOptimize(sum.load());
+    setItemsProcessed(state, jobsNb);
+}
+BENCHMARK(BM_JobSystem_parallelFor)->ArgNames({"jobs", "grain"})->ArgsProduct({{1024, 65536}, {1, 64}})->UseRealTime();
+
+// Push range(0) empty jobs from the calling thread and wait for them
+static void BM_JobSystem_run(benchmark::State& state) {
+    System::JobSystem jobSystem;
+    int64_t jobsNb = state.range(0);
+
+    for (auto _: state) {
+        System::JobSystem::Counter counter;
+        for (int64_t i = 0; i < jobsNb; ++i) {
+            jobSystem.run([]() {}, counter);
+        }
+        jobSystem.wait(counter);
+    }
+
+    setItemsProcessed(state, jobsNb);
+}
+BENCHMARK(BM_JobSystem_run)->ArgName("jobs")->Arg(1024)->UseRealTime();
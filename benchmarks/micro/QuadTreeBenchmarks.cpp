@@ -0,0 +1,210 @@
+#include <memory> // std::unique_ptr
+#include <random> // std::mt19937, std::uniform_real_distribution
+#include <vector> // std::vector
+
+#include <benchmark/benchmark.h> // benchmark::State
+
+#include <Core/QuadTree.hpp> // Core::QuadTree
+#include <Core/SphereQuadTree.hpp> // Core::SphereQuadTree
+#include <Graphics/Camera.hpp> // Graphics::Camera
+#include <System/Vector.hpp> // System::Vector
+
+#include "Items.hpp"
+
+namespace Core {
+
+// Access to the Core::QuadTree private functions
+class QuadTreeBenchmark {
+public:
+    // Front face of a planet, without neighbors
+    // Same front root as SphereQuadTree, for a planet of size 1
+    static std::unique_ptr<QuadTree> createRoot(const SphereQuadTree& planet) {
+        float size = 1.0f;
+
+        return std::make_unique<QuadTree>(
+            planet,
+            QuadTree::Face::FRONT,
+            0,
+            size,
+            glm::vec3(-size / 2.0f, -size / 2.0f, size / 2.0f),
+            glm::vec3(1.0f, 0.0f, 0.0f),
+            glm::vec3(0.0f, 1.0f, 0.0f),
+            glm::vec3(0.0f, 0.0f, 1.0f)
+        );
+    }
+
+    static void splitToLevel(QuadTree& quadTree, uint32_t level) {
+        if (quadTree._level >= level) {
+            return;
+        }
+
+        if (!quadTree._split) {
+            quadTree.split(0.0f);
+        }
+
+        splitToLevel(*quadTree._children.topLeft, level);
+        splitToLevel(*quadTree._children.topRight, level);
+        splitToLevel(*quadTree._children.bottomLeft, level);
+        splitToLevel(*quadTree._children.bottomRight, level);
+    }
+
+    // Split all the leaves except the skipped one
+    static void splitLeaves(QuadTree& quadTree, const QuadTree* skipped) {
+        if (&quadTree == skipped) {
+            return;
+        }
+
+        if (!quadTree._split) {
+            quadTree.split(0.0f);
+            return;
+        }
+
+        splitLeaves(*quadTree._children.topLeft, skipped);
+        splitLeaves(*quadTree._children.topRight, skipped);
+        splitLeaves(*quadTree._children.bottomLeft, skipped);
+        splitLeaves(*quadTree._children.bottomRight, skipped);
+    }
+
+    static void getLeaves(QuadTree& quadTree, std::vector<QuadTree*>& leaves) {
+        if (!quadTree._split) {
+            leaves.push_back(&quadTree);
+            return;
+        }
+
+        getLeaves(*quadTree._children.topLeft, leaves);
+        getLeaves(*quadTree._children.topRight, leaves);
+        getLeaves(*quadTree._children.bottomLeft, leaves);
+        getLeaves(*quadTree._children.bottomRight, leaves);
+    }
+
+    // Leaf in the middle of the quadtree, so all its neighbors exist
+    static QuadTree* getInnerLeaf(QuadTree& quadTree) {
+        QuadTree* leaf = quadTree._children.topLeft->_children.bottomRight.get();
+        while (leaf->_split) {
+            leaf = leaf->_children.topLeft.get();
+        }
+
+        return leaf;
+    }
+
+    static glm::vec3 calculateSpherePos(QuadTree& quadTree, const glm::vec3& cubePos) {
+        return quadTree.calculateSpherePos(cubePos);
+    }
+
+    static bool isOccludedByHorizon(const QuadTree& quadTree, const Graphics::Camera& camera) {
+        float margin = 0.0f;
+        return quadTree.isOccludedByHorizon(camera.getPos(), margin);
+    }
+
+    static void split(QuadTree& quadTree) {
+        quadTree.split(0.0f);
+    }
+
+    static void merge(QuadTree& quadTree) {
+        quadTree.merge();
+    }
+
+    static void addChildrenVertices(
+        QuadTree& quadTree,
+        System::Vector<QuadTree::Vertex>& vertices,
+        System::Vector<uint32_t>& indices
+    ) {
+        quadTree.addChildrenVertices(vertices, indices);
+    }
+};
+
+} // Namespace Core
+
+static const float planetSize = 100.0f;
+static const float planetMaxHeight = 20.0f;
+
+static void BM_QuadTree_calculateSpherePos(benchmark::State& state) {
+    auto planet = Core::SphereQuadTree::create(planetSize, planetMaxHeight);
+    auto root = Core::QuadTreeBenchmark::createRoot(*planet);
+
+    // Positions on the front face of the cube
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> distribution(-0.5f, 0.5f);
+    std::vector<glm::vec3> cubePositions(1024);
+    for (auto& cubePos: cubePositions) {
+        cubePos = {distribution(generator), distribution(generator), 0.5f};
+    }
+
+    for (auto _: state) {
+        for (const auto& cubePos: cubePositions) {
+            benchmark::DoNotOptimize(Core::QuadTreeBenchmark::calculateSpherePos(*root, cubePos));
+        }
+    }
+
+    setItemsProcessed(state, cubePositions.size());
+}
+BENCHMARK(BM_QuadTree_calculateSpherePos);
+
+static void BM_QuadTree_isOccludedByHorizon(benchmark::State& state) {
+    auto planet = Core::SphereQuadTree::create(planetSize, planetMaxHeight);
+    auto root = Core::QuadTreeBenchmark::createRoot(*planet);
+    Core::QuadTreeBenchmark::splitToLevel(*root, 4);
+
+    std::vector<Core::QuadTree*> leaves;
+    Core::QuadTreeBenchmark::getLeaves(*root, leaves);
+
+    // Low altitude, so part of the leaves are occluded
+    Graphics::Camera camera;
+    camera.setPos({0.0f, planetSize * 0.8f, planetSize * 0.8f});
+    camera.lookAt({0.0f, 0.0f, 0.0f});
+
+    for (auto _: state) {
+        for (const Core::QuadTree* leaf: leaves) {
+            benchmark::DoNotOptimize(Core::QuadTreeBenchmark::isOccludedByHorizon(*leaf, camera));
+        }
+    }
+
+    setItemsProcessed(state, leaves.size());
+}
+BENCHMARK(BM_QuadTree_isOccludedByHorizon);
+
+// Split and merge of a leaf at level range(0)
+// If range(1) is set, the leaf neighbors are split so updateNeighBors links the neighbors children
+static void BM_QuadTree_splitMerge(benchmark::State& state) {
+    auto planet = Core::SphereQuadTree::create(planetSize, planetMaxHeight);
+    auto root = Core::QuadTreeBenchmark::createRoot(*planet);
+    Core::QuadTreeBenchmark::splitToLevel(*root, static_cast<uint32_t>(state.range(0)));
+
+    Core::QuadTree* leaf = Core::QuadTreeBenchmark::getInnerLeaf(*root);
+    if (state.range(1)) {
+        Core::QuadTreeBenchmark::splitLeaves(*root, leaf);
+    }
+
+    for (auto _: state) {
+        Core::QuadTreeBenchmark::split(*leaf);
+        Core::QuadTreeBenchmark::merge(*leaf);
+        // Delete the merged children, like the next update
+        planet->collectRetiredNodes();
+    }
+
+    setItemsProcessed(state, 1);
+}
+BENCHMARK(BM_QuadTree_splitMerge)->ArgNames({"level", "splitNeighbors"})->ArgsProduct({{2, 4, 6}, {0, 1}});
+
+// Emission of a quadtree uniformly split to level range(0)
+static void BM_QuadTree_addChildrenVertices(benchmark::State& state) {
+    auto planet = Core::SphereQuadTree::create(planetSize, planetMaxHeight);
+    auto root = Core::QuadTreeBenchmark::createRoot(*planet);
+    Core::QuadTreeBenchmark::splitToLevel(*root, static_cast<uint32_t>(state.range(0)));
+
+    System::Vector<Core::QuadTree::Vertex> vertices(500);
+    System::Vector<uint32_t> indices(500);
+
+    for (auto _: state) {
+        vertices.clear();
+        indices.clear();
+
+        Core::QuadTreeBenchmark::addChildrenVertices(*root, vertices, indices);
+        benchmark::ClobberMemory();
+    }
+
+    setItemsProcessed(state, vertices.size());
+    state.counters["vertices"] = vertices.size();
+    state.counters["triangles"] = indices.size() / 3;
+}
+BENCHMARK(BM_QuadTree_addChildrenVertices)->ArgName("level")->DenseRange(1, 7);
@@ -0,0 +1,47 @@
+#include <vector> // std::vector
+
+#include <benchmark/benchmark.h> // benchmark::State
+
+#include <Core/QuadTree.hpp> // Core::QuadTree
+#include <System/Vector.hpp> // System::Vector
+
+#include "Items.hpp"
+
+// Push range(1) vertices in a System::Vector resized every range(0) elements
+// The vector is cleared between iterations, like the quadtrees meshes
+static void BM_Vector_push_back(benchmark::State& state) {
+    System::Vector<Core::QuadTree::Vertex> vertices(static_cast<uint32_t>(state.range(0)));
+    Core::QuadTree::Vertex vertex = {};
+    int64_t elemsNb = state.range(1);
+
+    for (auto _: state) {
+        vertices.clear();
+
+        for (int64_t i = 0; i < elemsNb; ++i) {
+            vertices.push_back(vertex);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    setItemsProcessed(state, elemsNb);
+}
+BENCHMARK(BM_Vector_push_back)->ArgNames({"chunkSize", "elems"})->ArgsProduct({{500, 4096}, {1000, 100000}});
+
+// Reference: std::vector cleared between iterations
+static void BM_StdVector_push_back(benchmark::State& state) {
+    std::vector<Core::QuadTree::Vertex> vertices;
+    Core::QuadTree::Vertex vertex = {};
+    int64_t elemsNb = state.range(0);
+
+    for (auto _: state) {
+        vertices.clear();
+
+        for (int64_t i = 0; i < elemsNb; ++i) {
+            vertices.push_back(vertex);
+        }
+        benchmark::ClobberMemory();
+    }
+
+    setItemsProcessed(state, elemsNb);
+}
+BENCHMARK(BM_StdVector_push_back)->ArgName("elems")->Arg(1000)->Arg(100000);
@@ -0,0 +1,9 @@
+#include <benchmark/benchmark.h> // BENCHMARK_MAIN
+
+/*
+ * Micro-benchmarks of the hot functions of planet_core
+ *
+ * The results are reported in ns/op and items/s
+ * Use --benchmark_format=json or --benchmark_out=FILE --benchmark_out_format=json for machine-readable output
+*/
+BENCHMARK_MAIN();
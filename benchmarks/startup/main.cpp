@@ -0,0 +1,206 @@
+#include <algorithm> // std::min, std::max
+#include <cstdio> // std::sscanf
+#include <cstring> // std::memcpy
+#include <fstream> // std::ofstream
+#include <iostream> // std::cerr, std::cout
+#include <memory> // std::shared_ptr
+#include <sstream> // std::ostringstream
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <Core/HeightMipChain.hpp> // Core::HeightMipChain
+#include <Core/PlanetPackage.hpp> // Core::PlanetPackage
+#include <Core/SphereQuadTree.hpp> // Core::SphereQuadTree
+#include <Core/TexelFormat.hpp> // Core::TexelFormat
+#include <System/JobSystem.hpp> // System::JobSystem
+#include <System/Timer.hpp> // System::Timer
+
+/*
+ * Compares the planet startup without package (cold) and with a baked package (warm), without OpenGL
+ *
+ * Usage:
+ * planet_startup [--package FILE] [--faceSize SIZE] [--runs RUNS] [--threads THREADS] [--out FILE]
+ *
+ * - cold: generation of the height map, the gradient map and the min/max pyramid (PlanetPackage::generate)
+ * - warm: mapping of the package, creation of the SphereQuadTree, generation of the height map mipmaps (Core::HeightMipChain),
+ *   conversion of the height map levels and copy of the gradient map in a staging buffer, the CPU side of the Graphics::Planet upload
+ *
+ * The package is baked first with the same parameters, the warm runs use the file cache of the OS
+ * The report is written in JSON, on the standard output or in the --out file
+*/
+
+struct Options {
+    std::string package = "planet_startup.pkg";
+    uint32_t faceSize = 1024;
+    uint32_t runsNb = 5;
+    // 0 uses one thread per core
+    uint32_t threadsNb = 0;
+    std::string output;
+};
+
+static bool parseUint(const char* value, uint32_t& number) {
+    return std::sscanf(value, "%u", &number) == 1;
+}
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++i];
+        bool valid = true;
+
+        if (argument == "--package") {
+            options.package = value;
+        }
+        else if (argument == "--faceSize") {
+            valid = parseUint(value, options.faceSize) && options.faceSize > 0;
+        }
+        else if (argument == "--runs") {
+            valid = parseUint(value, options.runsNb) && options.runsNb > 0;
+        }
+        else if (argument == "--threads") {
+            valid = parseUint(value, options.threadsNb);
+        }
+        else if (argument == "--out") {
+            options.output = value;
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool runWarm(const Options& options, System::JobSystem& jobSystem, std::vector<char>& stagingBuffer) {
+    std::shared_ptr<const Core::PlanetPackage> package = Core::PlanetPackage::create(options.package);
+    if (package == nullptr) {
+        return false;
+    }
+
+    std::unique_ptr<Core::SphereQuadTree> sphereQuadTree = Core::SphereQuadTree::create(package);
+    if (sphereQuadTree == nullptr) {
+        return false;
+    }
+
+    size_t texelsNb = static_cast<size_t>(package->getFaceSize()) * package->getFaceSize();
+    // The heights are converted to the default height map format of Graphics::Planet
+    size_t heightsSize = texelsNb * Core::TexelFormat::getSize(Core::TexelFormat::Height::R16);
+    size_t gradientsSize = texelsNb * Core::TexelFormat::getSize(Core::TexelFormat::Gradient::RG16F);
+    stagingBuffer.resize(heightsSize + gradientsSize);
+
+    for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+        Core::TexelFormat::encodeHeights(package->getHeights(static_cast<Core::CubeMap::Face>(face)), texelsNb, Core::TexelFormat::Height::R16, stagingBuffer.data());
+        std::memcpy(stagingBuffer.data() + heightsSize, package->getGradients(static_cast<Core::CubeMap::Face>(face)), gradientsSize);
+    }
+
+    Core::HeightMipChain mipChain;
+    Core::HeightMipChain::Faces faces;
+    for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+        faces[face] = package->getHeights(static_cast<Core::CubeMap::Face>(face));
+    }
+
+    mipChain.generate(faces, package->getFaceSize(), jobSystem);
+
+    // The levels are smaller than the face
+    for (uint32_t level = 1; level < mipChain.getLevelsNb(); ++level) {
+        size_t levelTexelsNb = static_cast<size_t>(mipChain.getSize(level)) * mipChain.getSize(level);
+
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            Core::TexelFormat::encodeHeights(mipChain.getHeights(static_cast<Core::CubeMap::Face>(face), level), levelTexelsNb, Core::TexelFormat::Height::R16, stagingBuffer.data());
+        }
+    }
+
+    return true;
+}
+
+static void writeTimeStats(std::ostream& stream, const char* name, const std::vector<float>& times) {
+    float total = 0.0f;
+    float min = times.front();
+    float max = times.front();
+
+    for (float time: times) {
+        total += time;
+        min = std::min(min, time);
+        max = std::max(max, time);
+    }
+
+    // Milliseconds
+    stream << "  \"" << name << "\": {"
+        << "\"first\": " << times.front() * 1000.0f << ", "
+        << "\"mean\": " << total / times.size() * 1000.0f << ", "
+        << "\"min\": " << min * 1000.0f << ", "
+        << "\"max\": " << max * 1000.0f << "}";
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    System::JobSystem jobSystem(options.threadsNb);
+
+    Core::PlanetPackage::Description description;
+    description.heightMapParameters.size = options.faceSize;
+
+    std::vector<float> coldTimes;
+    std::vector<float> warmTimes;
+    System::Timer timer;
+
+    for (uint32_t run = 0; run < options.runsNb; ++run) {
+        Core::PlanetPackage::Content content;
+
+        timer.reset();
+        Core::PlanetPackage::generate(description, jobSystem, content);
+        coldTimes.push_back(timer.getElapsedTime());
+
+        if (run == 0 && !Core::PlanetPackage::write(options.package, description, content)) {
+            return 1;
+        }
+    }
+
+    std::vector<char> stagingBuffer;
+    for (uint32_t run = 0; run < options.runsNb; ++run) {
+        timer.reset();
+        if (!runWarm(options, jobSystem, stagingBuffer)) {
+            return 1;
+        }
+        warmTimes.push_back(timer.getElapsedTime());
+    }
+
+    std::ostringstream report;
+    report << "{" << std::endl;
+    report << "  \"faceSize\": " << options.faceSize << "," << std::endl;
+    report << "  \"threads\": " << jobSystem.getThreadsNb() << "," << std::endl;
+    writeTimeStats(report, "cold_ms", coldTimes);
+    report << "," << std::endl;
+    writeTimeStats(report, "warm_ms", warmTimes);
+    report << std::endl << "}" << std::endl;
+
+    if (options.output.empty()) {
+        std::cout << report.str();
+        return 0;
+    }
+
+    std::ofstream file(options.output);
+    if (!file.good()) {
+        std::cerr << "Can't open \"" << options.output << "\"" << std::endl;
+        return 1;
+    }
+
+    file << report.str();
+
+    return file.good() ? 0 : 1;
+}
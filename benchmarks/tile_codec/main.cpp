@@ -0,0 +1,279 @@
+#include <algorithm> // std::min, std::max
+#include <cstdio> // std::sscanf
+#include <cstdlib> // std::abs
+#include <fstream> // std::ofstream
+#include <iostream> // std::cerr, std::cout
+#include <memory> // std::unique_ptr
+#include <sstream> // std::ostringstream
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <glm/geometric.hpp> // glm::normalize
+
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+#include <Core/HeightTileCodec.hpp> // Core::HeightTileCodec
+#include <Core/HeightTileSet.hpp> // Core::HeightTileSet
+#include <Core/TexelFormat.hpp> // Core::TexelFormat
+#include <System/Timer.hpp> // System::Timer
+
+/*
+ * Compression ratio and single thread throughput of Core::HeightTileCodec
+ *
+ * Usage:
+ * planet_tile_codec [--tiles FILE] [--tilesNb TILES] [--tileSize SIZE] [--level LEVEL] [--maxError ERROR] [--runs RUNS] [--out FILE]
+ *
+ * The tiles are read from a tile set (planet_bake --tiles, planet_ingest), or generated like planet_bake --tiles
+ * at the level LEVEL of the face +Z. Each run encodes and decodes all the tiles, the best run is reported
+ * The codec is measured lossless and with the max error ERROR, the throughputs are in MB/s of decoded heights
+ * The report is written in JSON, on the standard output or in the --out file
+*/
+
+struct Options {
+    std::string tiles;
+    uint32_t tilesNb = 64;
+    uint32_t tileSize = 256;
+    uint32_t level = 4;
+    uint32_t maxError = 4;
+    uint32_t runsNb = 5;
+    std::string output;
+};
+
+struct Result {
+    uint32_t maxError;
+    double ratio;
+    uint32_t measuredMaxError;
+    double encodeSpeed;
+    double scalarDecodeSpeed;
+    double simdDecodeSpeed;
+};
+
+static bool parseUint(const char* value, uint32_t& number) {
+    return std::sscanf(value, "%u", &number) == 1;
+}
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++i];
+        bool valid = true;
+
+        if (argument == "--tiles") {
+            options.tiles = value;
+        }
+        else if (argument == "--tilesNb") {
+            valid = parseUint(value, options.tilesNb) && options.tilesNb > 0;
+        }
+        else if (argument == "--tileSize") {
+            valid = parseUint(value, options.tileSize) && options.tileSize > 0;
+        }
+        else if (argument == "--level") {
+            valid = parseUint(value, options.level) && options.level < 16;
+        }
+        else if (argument == "--maxError") {
+            valid = parseUint(value, options.maxError) && options.maxError <= Core::HeightTileCodec::maxMaxError;
+        }
+        else if (argument == "--runs") {
+            valid = parseUint(value, options.runsNb) && options.runsNb > 0;
+        }
+        else if (argument == "--out") {
+            options.output = value;
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Tiles of all the levels, finest first
+static bool readTiles(const Options& options, uint32_t& tileTexelsSize, std::vector<std::vector<uint16_t>>& tiles) {
+    std::unique_ptr<Core::HeightTileSet> tileSet = Core::HeightTileSet::create(options.tiles);
+    if (tileSet == nullptr) {
+        return false;
+    }
+
+    tileTexelsSize = tileSet->getTileTexelsSize();
+    std::vector<uint16_t> texels(static_cast<size_t>(tileTexelsSize) * tileTexelsSize);
+
+    for (uint32_t level = tileSet->getDescription().levelsNb; level-- > 0;) {
+        uint32_t levelTilesNb = 1u << level;
+
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            for (uint32_t i = 0; i < levelTilesNb * levelTilesNb; ++i) {
+                if (tiles.size() == options.tilesNb) {
+                    return true;
+                }
+
+                if (tileSet->readTile(static_cast<Core::CubeMap::Face>(face), level, i % levelTilesNb, i / levelTilesNb, texels.data())) {
+                    tiles.push_back(texels);
+                }
+            }
+        }
+    }
+
+    return !tiles.empty();
+}
+
+static void generateTiles(const Options& options, uint32_t& tileTexelsSize, std::vector<std::vector<uint16_t>>& tiles) {
+    Core::HeightMapGenerator generator{Core::HeightMapGenerator::Parameters()};
+
+    tileTexelsSize = options.tileSize + 2;
+    uint32_t texelsNb = tileTexelsSize * tileTexelsSize;
+    uint32_t levelTilesNb = 1u << options.level;
+    float faceSize = static_cast<float>(options.tileSize << options.level);
+
+    std::vector<float> x(texelsNb);
+    std::vector<float> y(texelsNb);
+    std::vector<float> z(texelsNb);
+    std::vector<float> heights(texelsNb);
+
+    for (uint32_t tile = 0; tile < std::min(options.tilesNb, levelTilesNb * levelTilesNb); ++tile) {
+        for (uint32_t i = 0; i < texelsNb; ++i) {
+            float faceX = static_cast<float>((tile % levelTilesNb) * options.tileSize + i % tileTexelsSize) - 1.0f;
+            float faceY = static_cast<float>((tile / levelTilesNb) * options.tileSize + i / tileTexelsSize) - 1.0f;
+
+            glm::vec3 direction = glm::normalize(Core::CubeMap::getDirection(
+                Core::CubeMap::Face::POSITIVE_Z,
+                2.0f * (faceX + 0.5f) / faceSize - 1.0f,
+                2.0f * (faceY + 0.5f) / faceSize - 1.0f
+            ));
+
+            x[i] = direction.x;
+            y[i] = direction.y;
+            z[i] = direction.z;
+        }
+
+        generator.generate(x.data(), y.data(), z.data(), heights.data(), texelsNb);
+
+        tiles.emplace_back(texelsNb);
+        Core::TexelFormat::encodeHeights(heights.data(), texelsNb, Core::TexelFormat::Height::R16, tiles.back().data());
+    }
+}
+
+static Result measure(const Options& options, uint32_t tileTexelsSize, const std::vector<std::vector<uint16_t>>& tiles, uint32_t maxError) {
+    size_t maxEncodedSize = Core::HeightTileCodec::getMaxEncodedSize(tileTexelsSize, tileTexelsSize);
+    std::vector<std::vector<uint8_t>> encodedTiles(tiles.size(), std::vector<uint8_t>(maxEncodedSize));
+    std::vector<size_t> encodedSizes(tiles.size());
+    std::vector<uint16_t> decodedTexels(static_cast<size_t>(tileTexelsSize) * tileTexelsSize);
+
+    float encodeTime = 0.0f;
+    float scalarDecodeTime = 0.0f;
+    float simdDecodeTime = 0.0f;
+    System::Timer timer;
+
+    for (uint32_t run = 0; run < options.runsNb; ++run) {
+        timer.reset();
+        for (size_t i = 0; i < tiles.size(); ++i) {
+            encodedSizes[i] = Core::HeightTileCodec::encode(tiles[i].data(), tileTexelsSize, tileTexelsSize, maxError, encodedTiles[i].data());
+        }
+        float time = timer.getElapsedTime();
+        encodeTime = run == 0 ? time : std::min(encodeTime, time);
+
+        for (uint32_t simd = 0; simd < 2; ++simd) {
+            timer.reset();
+            for (size_t i = 0; i < tiles.size(); ++i) {
+                Core::HeightTileCodec::decode(encodedTiles[i].data(), encodedSizes[i], tileTexelsSize, tileTexelsSize, decodedTexels.data(), simd != 0);
+            }
+            time = timer.getElapsedTime();
+
+            float& decodeTime = simd ? simdDecodeTime : scalarDecodeTime;
+            decodeTime = run == 0 ? time : std::min(decodeTime, time);
+        }
+    }
+
+    Result result = {maxError, 0.0, 0, 0.0, 0.0, 0.0};
+
+    size_t encodedSize = 0;
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        encodedSize += encodedSizes[i];
+
+        Core::HeightTileCodec::decode(encodedTiles[i].data(), encodedSizes[i], tileTexelsSize, tileTexelsSize, decodedTexels.data());
+        for (size_t texel = 0; texel < decodedTexels.size(); ++texel) {
+            uint32_t error = static_cast<uint32_t>(std::abs(static_cast<int32_t>(decodedTexels[texel]) - tiles[i][texel]));
+            result.measuredMaxError = std::max(result.measuredMaxError, error);
+        }
+    }
+
+    double size = static_cast<double>(tiles.size()) * decodedTexels.size() * sizeof(uint16_t);
+    result.ratio = size / encodedSize;
+    result.encodeSpeed = size / encodeTime / 1e6;
+    result.scalarDecodeSpeed = size / scalarDecodeTime / 1e6;
+    result.simdDecodeSpeed = size / simdDecodeTime / 1e6;
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    uint32_t tileTexelsSize = 0;
+    std::vector<std::vector<uint16_t>> tiles;
+    if (!options.tiles.empty()) {
+        if (!readTiles(options, tileTexelsSize, tiles)) {
+            return 1;
+        }
+    }
+    else {
+        generateTiles(options, tileTexelsSize, tiles);
+    }
+
+    std::vector<Result> results;
+    results.push_back(measure(options, tileTexelsSize, tiles, 0));
+    if (options.maxError != 0) {
+        results.push_back(measure(options, tileTexelsSize, tiles, options.maxError));
+    }
+
+    std::ostringstream report;
+    report << "{" << std::endl;
+    report << "  \"tiles\": " << tiles.size() << "," << std::endl;
+    report << "  \"tileTexelsSize\": " << tileTexelsSize << "," << std::endl;
+    report << "  \"simd\": " << (Core::HeightTileCodec::isSIMDSupported() ? "true" : "false") << "," << std::endl;
+    report << "  \"results\": [" << std::endl;
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+
+        // Throughputs in MB/s
+        report << "    {"
+            << "\"maxError\": " << result.maxError << ", "
+            << "\"measuredMaxError\": " << result.measuredMaxError << ", "
+            << "\"ratio\": " << result.ratio << ", "
+            << "\"encode\": " << result.encodeSpeed << ", "
+            << "\"decodeScalar\": " << result.scalarDecodeSpeed << ", "
+            << "\"decodeSIMD\": " << result.simdDecodeSpeed << "}"
+            << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+
+    report << "  ]" << std::endl << "}" << std::endl;
+
+    if (options.output.empty()) {
+        std::cout << report.str();
+        return 0;
+    }
+
+    std::ofstream file(options.output);
+    if (!file.good()) {
+        std::cerr << "Can't open \"" << options.output << "\"" << std::endl;
+        return 1;
+    }
+
+    file << report.str();
+
+    return file.good() ? 0 : 1;
+}
@@ -1,6 +1,8 @@
 # detect os
 if(${CMAKE_SYSTEM_NAME} STREQUAL "Windows")
     set(OS_WINDOWS 1)
+elseif(${CMAKE_SYSTEM_NAME} STREQUAL "Linux")
+    set(OS_LINUX 1)
 else()
     message(FATAL_ERROR "Unsupported operating system or environment")
     return()
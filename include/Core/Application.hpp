@@ -1,11 +1,17 @@
 #pragma once
 
 #include <cstdint> // uint32_t
-#include <memory> // std::unique_ptr
+#include <memory> // std::unique_ptr, std::shared_ptr
+#include <mutex> // std::mutex, std::unique_lock
 #include <vector> // std::vector
 
-#include <Core/SphereQuadTree.hpp> // Core::SphereQuadTree
+#include <Core/CameraPath.hpp> // Core::CameraPath
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+#include <Core/LodBudget.hpp> // Core::LodBudget
+#include <Core/LodGovernor.hpp> // Core::LodGovernor
+#include <Core/LodPipeline.hpp> // Core::LodPipeline
 #include <Graphics/Camera.hpp> // Graphics::Camera
+#include <Graphics/Planet.hpp> // Graphics::Planet
 #include <Graphics/Renderer.hpp> // Graphics::Renderer
 #include <Window/Window.hpp> // Window::Window
 
@@ -22,7 +28,8 @@ public:
     Application& operator=(const Application& app) = delete;
     Application& operator=(Application&& app) = delete;
 
-    bool init();
+    // planet_generator [--package FILE]
+    bool init(int argc, char** argv);
     bool run();
 
 private:
@@ -33,17 +40,47 @@ private:
     void displayCommandsWindow();
     void displayDebugWindow();
     void displayEditorWindow();
+    void displayProfilerWindow();
 
     void updateCameraPosition(float elapsedTime);
     void updateCameraRotation(Window::Event& event);
 
+    // The recorded camera path can be replayed by the planet_lod_replay benchmark
+    void cameraPathRecording(bool recording);
+
+    // Update the quadtrees on the LOD thread, or in onFrame
+    void lodPipelined(bool pipelined);
+    // The planets can be edited while the lock is owned, the lock is empty if the LOD is not pipelined
+    std::unique_lock<std::mutex> pauseLod();
+
+    // Scale the LOD of the planets for the cost of the last frame, in seconds
+    void updateLodGovernor(float frameTime);
+    void lodGoverned(bool governed);
+
 private:
     std::unique_ptr<Window::Window> _window = nullptr;
     std::unique_ptr<Graphics::Renderer> _renderer = nullptr;
 
-    std::vector<std::unique_ptr<Core::SphereQuadTree>> _planets;
+    // Budget of all the planets, the parent of their budgets
+    std::shared_ptr<Core::LodBudget> _lodBudget = nullptr;
+    std::vector<std::unique_ptr<Graphics::Planet>> _planets;
+    // Destroyed before the planets it updates
+    std::unique_ptr<Core::LodPipeline> _lodPipeline = nullptr;
 
     Graphics::Camera _camera;
+
+    Core::LodGovernor _lodGovernor;
+    bool _lodGoverned = true;
+
+    // Edited in the editor window, applied with the Generate button
+    Core::HeightMapGenerator::Parameters _heightMapParameters;
+
+    Core::CameraPath _cameraPath;
+    bool _cameraPathRecording = false;
+    float _cameraPathTime = 0.0f;
+
+    // Number of frames displayed in the profiler window
+    int _profilerFramesNb = 3;
 };
 
 } // Namespace Core
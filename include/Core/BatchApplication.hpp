@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint> // uint8_t
+#include <memory> // std::unique_ptr
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <glm/vec2.hpp> // glm::ivec2
+#include <glm/vec3.hpp> // glm::vec3
+
+#include <Graphics/API/Framebuffer.hpp> // Graphics::API::Framebuffer
+#include <Graphics/API/Texture.hpp> // Graphics::API::Texture
+#include <Graphics/Camera.hpp> // Graphics::Camera
+#include <Graphics/Planet.hpp> // Graphics::Planet
+#include <Graphics/Renderer.hpp> // Graphics::Renderer
+#include <Window/OffscreenContext.hpp> // Window::OffscreenContext
+
+namespace Core {
+
+/*
+ * Headless application rendering a list of planet previews into image files
+ *
+ * Usage:
+ * planet_generator [--size WIDTHxHEIGHT] [--jobs FILE] [--job "JOB"]...
+ *
+ * A job is a list of key=value separated by spaces, the jobs file contains one job per line
+ * Empty lines and lines starting with '#' are ignored
+ * size=100 maxHeight=20 seed=1 pos=0,0,150 lookAt=0,0,0 fov=45 out=preview.png
+ * seed is the seed of the procedural height map
+ *
+ * The output format depends on the file extension:
+ * - .png: RGBA png image
+ * - .raw: RGBA bytes, rows from top to bottom
+ *
+ * The renderer, the shaders, the planet and the framebuffer are created once and reused for all the jobs
+*/
+class BatchApplication {
+public:
+    struct Job {
+        enum class Format: uint8_t {
+            PNG,
+            RAW
+        };
+
+        float size = 100.0f;
+        float maxHeight = 20.0f;
+        uint32_t seed = 1;
+
+        glm::vec3 pos = {0.0f, 0.0f, 150.0f};
+        glm::vec3 lookAt = {0.0f, 0.0f, 0.0f};
+        float fov = 45.0f;
+
+        std::string output;
+        Format format = Format::PNG;
+    };
+
+public:
+    BatchApplication() = default;
+    ~BatchApplication() = default;
+
+    BatchApplication(const BatchApplication& app) = delete;
+    BatchApplication(BatchApplication&& app) = delete;
+
+    BatchApplication& operator=(const BatchApplication& app) = delete;
+    BatchApplication& operator=(BatchApplication&& app) = delete;
+
+    // Returns true if the command line asks for the batch mode
+    static bool isRequested(int argc, char** argv);
+
+    bool init(int argc, char** argv);
+    bool run();
+
+private:
+    bool parseArguments(int argc, char** argv);
+    bool parseJobsFile(const std::string& fileName);
+    bool parseJob(const std::string& jobDescription, Job& job) const;
+
+    bool initFramebuffer();
+
+    bool renderJob(const Job& job);
+    bool writeImage(const Job& job);
+
+private:
+    glm::ivec2 _size = {512, 512};
+    std::vector<Job> _jobs;
+
+    std::unique_ptr<Window::OffscreenContext> _context = nullptr;
+    std::unique_ptr<Graphics::Renderer> _renderer = nullptr;
+
+    // Only one planet is used and updated for each job
+    std::vector<std::unique_ptr<Graphics::Planet>> _planets;
+
+    Graphics::Camera _camera;
+
+    Graphics::API::Framebuffer _framebuffer;
+    Graphics::API::Texture _colorTexture;
+
+    // Reused between jobs to read the framebuffer
+    std::vector<uint8_t> _pixels;
+    std::vector<uint8_t> _flippedPixels;
+};
+
+} // Namespace Core
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <glm/vec3.hpp> // glm::vec3
+
+#include <Graphics/Camera.hpp> // Graphics::Camera
+
+namespace Core {
+
+/*
+ * Camera positions over time, used to replay the same camera movement
+ * The camera position and look at position are linearly interpolated between the key frames
+ * Two key frames with the same time make the camera teleport
+ *
+ * File format: one key frame per line, empty lines and lines starting with '#' are ignored
+ * time x,y,z lookAtX,lookAtY,lookAtZ
+*/
+class CameraPath {
+public:
+    struct KeyFrame {
+        float time;
+        glm::vec3 pos;
+        glm::vec3 lookAt;
+    };
+
+public:
+    CameraPath() = default;
+    ~CameraPath() = default;
+
+    CameraPath(const CameraPath& path) = default;
+    CameraPath(CameraPath&& path) = default;
+
+    CameraPath& operator=(const CameraPath& path) = default;
+    CameraPath& operator=(CameraPath&& path) = default;
+
+    bool loadFromFile(const std::string& fileName);
+    bool saveToFile(const std::string& fileName) const;
+
+    // Key frames must be added by increasing time
+    void addKeyFrame(const KeyFrame& keyFrame);
+    void clear();
+
+    bool isEmpty() const;
+    float getDuration() const;
+    const std::vector<KeyFrame>& getKeyFrames() const;
+
+    // Set the camera position and orientation at the given time
+    void apply(float time, Graphics::Camera& camera) const;
+
+private:
+    std::vector<KeyFrame> _keyFrames;
+};
+
+} // Namespace Core
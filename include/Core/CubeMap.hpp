@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint> // uint32_t
+
+#include <glm/vec3.hpp> // glm::vec3
+
+namespace Core {
+
+/*
+ * Faces of a cube map texture, in the OpenGL order (GL_TEXTURE_CUBE_MAP_POSITIVE_X + face)
+ * The first row of a face is at t = -1 and the first column at s = -1
+*/
+class CubeMap {
+public:
+    enum class Face: uint32_t {
+        POSITIVE_X = 0,
+        NEGATIVE_X = 1,
+        POSITIVE_Y = 2,
+        NEGATIVE_Y = 3,
+        POSITIVE_Z = 4,
+        NEGATIVE_Z = 5
+    };
+
+    static constexpr uint32_t facesNb = 6;
+
+public:
+    CubeMap() = delete;
+
+    // Direction (not normalized) of the face point at s, t in [-1, 1]
+    static glm::vec3 getDirection(Face face, float s, float t);
+    // Direction (not normalized) of the center of the texel x, y of a face of size * size texels
+    static glm::vec3 getDirection(Face face, uint32_t x, uint32_t y, uint32_t size);
+    // Face of a direction and its s, t coordinates in [-1, 1], inverse of getDirection
+    static Face getFace(const glm::vec3& direction, float& s, float& t);
+};
+
+} // Namespace Core
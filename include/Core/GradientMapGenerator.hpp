@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array> // std::array
+#include <cstdint> // uint32_t, int64_t
+#include <vector> // std::vector
+
+#include <glm/vec2.hpp> // glm::vec2
+
+#include <Core/CubeMap.hpp> // Core::CubeMap
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+#include <System/JobSystem.hpp> // System::JobSystem
+
+namespace Core {
+
+/*
+ * Gradient map of a cube height map, on the CPU (same gradients as gradient.frag, without OpenGL context)
+ *
+ * The texels around a face are read on the neighbor faces, so the faces have no seams
+ * The faces are split in tiles of rows generated by the job system
+ * After a local edit of the heights, update only generates again the gradients depending on the edited heights,
+ * on the edited face and on its neighbors
+ * The AVX2 kernel gives the same gradients as the scalar one
+*/
+class GradientMapGenerator {
+public:
+    enum class Filter: uint32_t {
+        // 3x3 Sobel filter, like gradient.frag
+        SOBEL = 0,
+        // Differences of the 4 neighbors, scaled to the amplitude of the Sobel filter
+        CENTRAL_DIFFERENCES = 1
+    };
+
+    // Texels [xMin, xMax[ x [yMin, yMax[ of a face, empty if xMin == xMax
+    struct Rect {
+        uint32_t xMin;
+        uint32_t yMin;
+        uint32_t xMax;
+        uint32_t yMax;
+    };
+
+    using Rects = std::array<Rect, CubeMap::facesNb>;
+
+    // Gradients of the heights in [0, 1], row by row
+    using Faces = std::array<std::vector<glm::vec2>, CubeMap::facesNb>;
+
+public:
+    // Faces of size * size texels
+    explicit GradientMapGenerator(uint32_t size, Filter filter = Filter::SOBEL);
+    ~GradientMapGenerator() = default;
+
+    GradientMapGenerator(const GradientMapGenerator& generator) = default;
+    GradientMapGenerator(GradientMapGenerator&& generator) = default;
+
+    GradientMapGenerator& operator=(const GradientMapGenerator& generator) = default;
+    GradientMapGenerator& operator=(GradientMapGenerator&& generator) = default;
+
+    static bool isAVX2Supported();
+
+    uint32_t getSize() const;
+    Filter getFilter() const;
+    // The AVX2 kernel is used by default if the CPU supports it
+    void setAVX2Enabled(bool enabled);
+    bool isAVX2Enabled() const;
+
+    void generate(const HeightMapGenerator::Faces& heights, Faces& gradients, System::JobSystem& jobSystem) const;
+    // The heights of rect changed on face, the gradients must have been generated with the previous heights
+    // Returns the gradients updated on each face, to upload them
+    Rects update(
+        const HeightMapGenerator::Faces& heights,
+        CubeMap::Face face,
+        const Rect& rect,
+        Faces& gradients,
+        System::JobSystem& jobSystem
+    ) const;
+
+private:
+    // Texel of a face
+    struct Texel {
+        uint32_t face;
+        uint32_t index;
+    };
+
+    // Gradients of count texels, top, middle and bottom are the rows around them with one more texel on each side
+    static void generateScalar(
+        Filter filter,
+        const float* top,
+        const float* middle,
+        const float* bottom,
+        glm::vec2* gradients,
+        uint32_t count
+    );
+
+    // Only processes the texels by packs of 8, defined in GradientMapGeneratorAVX2.cpp
+    static void generateAVX2(
+        Filter filter,
+        const float* top,
+        const float* middle,
+        const float* bottom,
+        glm::vec2* gradients,
+        uint32_t count
+    );
+
+    void initBorders();
+    // Index in _borders of the texel x, y around the face, x and y in [-1, size]
+    uint32_t getBorderIndex(int64_t x, int64_t y) const;
+
+    void generateRects(const HeightMapGenerator::Faces& heights, const Rects& rects, Faces& gradients, System::JobSystem& jobSystem) const;
+    // Heights of the columns [xMin - 1, xMax] of the row y in [-1, size]
+    void readRow(const HeightMapGenerator::Faces& heights, CubeMap::Face face, int64_t y, uint32_t xMin, uint32_t xMax, float* row) const;
+
+private:
+    // Rows generated by a job
+    static constexpr uint32_t tileRowsNb = 16;
+
+    uint32_t _size;
+    Filter _filter;
+
+    // Texels read around each face: the row above, the row below (both with the corners),
+    // the column on the left and the column on the right
+    std::array<std::vector<Texel>, CubeMap::facesNb> _borders;
+
+    bool _avx2Enabled;
+};
+
+} // Namespace Core
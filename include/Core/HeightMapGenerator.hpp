@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array> // std::array
+#include <cstdint> // uint32_t, int32_t
+#include <vector> // std::vector
+
+#include <Core/CubeMap.hpp> // Core::CubeMap
+#include <System/JobSystem.hpp> // System::JobSystem
+
+namespace Core {
+
+/*
+ * Procedural height map of the six cube map faces
+ *
+ * The noise is evaluated on the sphere (normalized cube map direction), so the faces have no seams
+ * The faces are split in tiles of rows generated by the job system
+ * Each height only depends on the parameters and the texel position, so the result is the same for any number of threads,
+ * and the AVX2 kernel gives the same result as the scalar one
+*/
+class HeightMapGenerator {
+public:
+    enum class NoiseType: uint32_t {
+        // Fractal brownian motion of simplex noise
+        FBM = 0,
+        // Ridged multifractal, sharp crests
+        RIDGED = 1
+    };
+
+    struct Parameters {
+        uint32_t seed = 1;
+        // Width and height of a face
+        uint32_t size = 2048;
+
+        NoiseType noiseType = NoiseType::FBM;
+        uint32_t octaves = 8;
+        // Frequency of the first octave, on the unit sphere
+        float frequency = 1.5f;
+        // Frequency multiplier between two octaves
+        float lacunarity = 2.0f;
+        // Amplitude multiplier between two octaves
+        float gain = 0.5f;
+
+        // Offset of the sample position by an other fBm, 0 disables domain warping
+        float warpStrength = 0.0f;
+        uint32_t warpOctaves = 4;
+    };
+
+    // Heights in [0, 1], row by row
+    using Faces = std::array<std::vector<float>, CubeMap::facesNb>;
+
+public:
+    explicit HeightMapGenerator(const Parameters& parameters);
+    ~HeightMapGenerator() = default;
+
+    HeightMapGenerator(const HeightMapGenerator& generator) = default;
+    HeightMapGenerator(HeightMapGenerator&& generator) = default;
+
+    HeightMapGenerator& operator=(const HeightMapGenerator& generator) = default;
+    HeightMapGenerator& operator=(HeightMapGenerator&& generator) = default;
+
+    static bool isAVX2Supported();
+
+    const Parameters& getParameters() const;
+    // The AVX2 kernel is used by default if the CPU supports it
+    void setAVX2Enabled(bool enabled);
+    bool isAVX2Enabled() const;
+
+    void generate(Faces& faces, System::JobSystem& jobSystem) const;
+    // Heights of count points of the unit sphere
+    void generate(const float* x, const float* y, const float* z, float* heights, uint32_t count) const;
+
+private:
+    static void generateScalar(
+        const Parameters& parameters,
+        const int32_t* permutations,
+        const float* x,
+        const float* y,
+        const float* z,
+        float* heights,
+        uint32_t count
+    );
+
+    // Only processes the points by packs of 8, defined in HeightMapGeneratorAVX2.cpp
+    static void generateAVX2(
+        const Parameters& parameters,
+        const int32_t* permutations,
+        const float* x,
+        const float* y,
+        const float* z,
+        float* heights,
+        uint32_t count
+    );
+
+private:
+    // Rows generated by a job
+    static constexpr uint32_t tileRowsNb = 16;
+
+    Parameters _parameters;
+
+    // Permutation of [0, 255] repeated twice, so the hashes don't need a modulo
+    std::array<int32_t, 512> _permutations;
+
+    bool _avx2Enabled;
+};
+
+} // Namespace Core
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array> // std::array
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+#include <vector> // std::vector
+
+#include <glm/vec2.hpp> // glm::vec2
+
+#include <Core/CubeMap.hpp> // Core::CubeMap
+#include <System/JobSystem.hpp> // System::JobSystem
+
+namespace Core {
+
+/*
+ * Mip chain of a cube height map, on the CPU
+ *
+ * The levels have the OpenGL mipmap sizes (half the previous size, rounded down) so they are uploaded as the mipmaps
+ * of the height map texture, each texel is the box filtered texels of the previous level under it
+ * When the previous size is odd, the last texel of a row or a column covers 3 texels of the previous level
+ * The minimum and maximum heights under each texel are kept along the averages, so any level bounds the face heights
+*/
+class HeightMipChain {
+public:
+    // Level 0 of each face, faceSize * faceSize heights in [0, 1]
+    using Faces = std::array<const float*, CubeMap::facesNb>;
+
+public:
+    HeightMipChain() = default;
+    ~HeightMipChain() = default;
+
+    HeightMipChain(const HeightMipChain& mipChain) = delete;
+    HeightMipChain(HeightMipChain&& mipChain) = default;
+
+    HeightMipChain& operator=(const HeightMipChain& mipChain) = delete;
+    HeightMipChain& operator=(HeightMipChain&& mipChain) = default;
+
+    // Width and height of each level, the level 0 is the face
+    static std::vector<uint32_t> getSizes(uint32_t faceSize);
+
+    void generate(const Faces& faces, uint32_t faceSize, System::JobSystem& jobSystem);
+
+    uint32_t getLevelsNb() const;
+    uint32_t getSize(uint32_t level) const;
+
+    // level in [1, getLevelsNb()[, the level 0 is the height map
+    const float* getHeights(CubeMap::Face face, uint32_t level) const;
+    const glm::vec2* getMinMax(CubeMap::Face face, uint32_t level) const;
+    // Texels of the levels [1, getLevelsNb()[ of a face, stored one after the other
+    size_t getFaceTexelsNb() const;
+
+private:
+    // Rows of a level generated by a job
+    static constexpr uint32_t blockRowsNb = 16;
+
+    std::vector<uint32_t> _sizes;
+    // Offset of each level in the levels of a face, in texels
+    std::vector<size_t> _offsets;
+    size_t _faceTexelsNb = 0;
+
+    std::array<std::vector<float>, CubeMap::facesNb> _heights;
+    std::array<std::vector<glm::vec2>, CubeMap::facesNb> _minMax;
+};
+
+} // Namespace Core
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <cstdint> // uint8_t, uint16_t, uint32_t
+
+namespace Core {
+
+/*
+ * Lossless or bounded error codec of the height tiles, without dependency
+ *
+ * The heights are predicted from their neighbors and the zigzag encoded residuals are bit packed by blocks of 128,
+ * each block with its own number of bits. The residuals of a block are interleaved in 8 lanes of 16 bits,
+ * so the SSE2 decoder unpacks 8 consecutive residuals at a time
+ * With a max error, the heights are quantized with a step of 2 * maxError + 1 before the prediction
+ *
+ * Layout: Header, the number of bits of each block (one byte per block), the packed blocks (16 * bits bytes per block)
+*/
+class HeightTileCodec {
+public:
+    enum class Predictor: uint8_t {
+        // Height above, the first row is predicted with the height on the left
+        UP = 0,
+        // Left + up - up left, better on smooth tiles
+        GRADIENT = 1
+    };
+
+    struct Header {
+        Predictor predictor;
+        uint8_t reserved;
+        // Quantization step, 1 if lossless
+        uint16_t step;
+    };
+
+    static constexpr uint32_t blockSize = 128;
+    static constexpr uint32_t maxMaxError = 32767;
+
+public:
+    HeightTileCodec() = delete;
+
+    static bool isSIMDSupported();
+
+    static size_t getMaxEncodedSize(uint32_t width, uint32_t height);
+
+    // maxError 0 is lossless, otherwise the decoded heights are at most maxError from the heights
+    // data must have getMaxEncodedSize bytes, returns the encoded size
+    static size_t encode(const uint16_t* texels, uint32_t width, uint32_t height, uint32_t maxError, uint8_t* data);
+    // False if data is not a tile of this size, the SSE2 decoder is used if simd is set and it's supported
+    static bool decode(const uint8_t* data, size_t size, uint32_t width, uint32_t height, uint16_t* texels, bool simd = true);
+};
+
+} // Namespace Core
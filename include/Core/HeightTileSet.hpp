@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstdint> // uint16_t, uint32_t, uint64_t
+#include <fstream> // std::ofstream
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <Core/CubeMap.hpp> // Core::CubeMap
+#include <System/MappedFile.hpp> // System::MappedFile
+
+namespace Core {
+
+/*
+ * Sparse tiled height map: a pyramid of tiles per cube face, memory mapped when it is loaded
+ *
+ * The level 0 has one tile per face, the level n has 2^n * 2^n tiles per face, so a face of the level n
+ * has tileSize * 2^n texels per side. The tile x, y of a level covers the face texels
+ * [x * tileSize, (x + 1) * tileSize[ * [y * tileSize, (y + 1) * tileSize[ with the cube map conventions of Core::CubeMap
+ * Each tile also stores a border of texels of its neighbors, so it can be filtered without them
+ * The tiles are stored raw or compressed (see Format), they are decoded by readTile
+ *
+ * Layout (little endian):
+ * - Header
+ * - Tile table: one Tile per face, level and tile, in this order (see getTileIndex)
+ * - Tiles data, in any order, missing tiles have a size of 0
+*/
+class HeightTileSet {
+public:
+    enum class Format: uint32_t {
+        // (tileSize + 2 * border)^2 heights in [0, 1], unsigned normalized 16 bits
+        R16 = 1,
+        // R16 heights coded with Core::HeightTileCodec, at most maxError from the heights
+        R16_PACKED = 2
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        Format format;
+        uint32_t tileSize;
+        uint32_t border;
+        uint32_t levelsNb;
+        uint32_t maxError;
+        uint32_t reserved[4];
+    };
+
+    struct Tile {
+        // From the beginning of the file
+        uint64_t offset;
+        uint32_t size;
+        uint32_t reserved;
+    };
+
+    struct Description {
+        uint32_t tileSize = 256;
+        uint32_t border = 1;
+        uint32_t levelsNb = 1;
+        Format format = Format::R16_PACKED;
+        // Only used by R16_PACKED, 0 is lossless
+        uint32_t maxError = 0;
+    };
+
+    /*
+     * Writes the tiles in any order and from any thread, the tile table is written by finish
+    */
+    class Writer {
+    public:
+        ~Writer() = default;
+
+        Writer(const Writer& writer) = delete;
+        Writer(Writer&& writer) = delete;
+
+        Writer& operator=(const Writer& writer) = delete;
+        Writer& operator=(Writer&& writer) = delete;
+
+        static std::unique_ptr<Writer> create(const std::string& fileName, const Description& description);
+
+        // texels has getTexelsNb() texels, border included, they are coded with the format of the description
+        bool writeTile(CubeMap::Face face, uint32_t level, uint32_t x, uint32_t y, const uint16_t* texels);
+        bool finish();
+
+        const Description& getDescription() const;
+        uint32_t getTexelsNb() const;
+
+    private:
+        // Only the Writer::create can create the writer
+        Writer() = default;
+
+        bool init(const std::string& fileName, const Description& description);
+
+    private:
+        std::string _fileName;
+        Description _description;
+
+        std::mutex _mutex;
+        std::ofstream _file;
+        std::vector<Tile> _tiles;
+        uint64_t _offset = 0;
+    };
+
+    static constexpr uint32_t version = 1;
+
+public:
+    ~HeightTileSet() = default;
+
+    HeightTileSet(const HeightTileSet& tileSet) = delete;
+    HeightTileSet(HeightTileSet&& tileSet) = delete;
+
+    HeightTileSet& operator=(const HeightTileSet& tileSet) = delete;
+    HeightTileSet& operator=(HeightTileSet&& tileSet) = delete;
+
+    // Map and validate a tile set
+    static std::unique_ptr<HeightTileSet> create(const std::string& fileName);
+
+    // Index of a tile in the tile table
+    static uint64_t getTileIndex(const Description& description, CubeMap::Face face, uint32_t level, uint32_t x, uint32_t y);
+    static uint64_t getTilesNb(const Description& description);
+
+    const Description& getDescription() const;
+    // Texels per side of a face at the level
+    uint32_t getFaceSize(uint32_t level) const;
+    // Texels per side of a tile, border included
+    uint32_t getTileTexelsSize() const;
+
+    bool hasTile(CubeMap::Face face, uint32_t level, uint32_t x, uint32_t y) const;
+    // Copy or decode the texels of a tile, getTileTexelsSize()^2 texels
+    // Can be called from any thread, the pages are read from the disk on the first access
+    bool readTile(CubeMap::Face face, uint32_t level, uint32_t x, uint32_t y, uint16_t* texels) const;
+
+private:
+    // Only the HeightTileSet::create can create the tile set
+    HeightTileSet() = default;
+
+    bool init(const std::string& fileName);
+
+private:
+    std::unique_ptr<System::MappedFile> _file = nullptr;
+
+    Description _description;
+
+    const char* _data = nullptr;
+    const Tile* _tiles = nullptr;
+};
+
+} // Namespace Core
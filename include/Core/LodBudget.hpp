@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint> // uint32_t, uint64_t
+#include <memory> // std::shared_ptr
+#include <mutex> // std::mutex
+
+namespace Core {
+
+/*
+ * Memory budget of the level of detail: quadtrees, bytes of the emitted vertices and bytes of the height tiles
+ *
+ * The planets reserve what they need before they grow and release it when they shrink
+ * A reservation fails if it would exceed the limits of the budget or of its parent,
+ * so each planet has its own budget and the budget of all the planets is their parent
+ * The usage can be read and reserved from any thread
+*/
+class LodBudget {
+public:
+    // 0 is unlimited
+    struct Limits {
+        uint32_t nodesNb = 0;
+        uint64_t verticesSize = 0;
+        uint64_t texturesSize = 0;
+    };
+
+    struct Usage {
+        uint32_t nodesNb;
+        uint64_t verticesSize;
+        uint64_t texturesSize;
+    };
+
+public:
+    LodBudget() = default;
+    explicit LodBudget(const Limits& limits);
+    // The usage is released from the parent
+    ~LodBudget();
+
+    LodBudget(const LodBudget& budget) = delete;
+    LodBudget(LodBudget&& budget) = delete;
+
+    LodBudget& operator=(const LodBudget& budget) = delete;
+    LodBudget& operator=(LodBudget&& budget) = delete;
+
+    // fraction of the limits the reservation can use, in ]0, 1]
+    // The reservations of a lower priority use a lower fraction so they are refused first
+    // Returns false if the usage doesn't fit, nothing is reserved then
+    bool reserve(const Usage& usage, float fraction = 1.0f);
+    void release(const Usage& usage);
+
+    Usage getUsage() const;
+    // Usage over the limits of the budget or of its parent, once they are lowered, 0 for the resources within them
+    Usage getExcess() const;
+
+    Limits getLimits() const;
+    // The usage is kept, getExcess tells what must be released
+    void setLimits(const Limits& limits);
+
+    const std::shared_ptr<LodBudget>& getParent() const;
+    // The usage is moved to the new parent, even over its limits
+    void setParent(std::shared_ptr<LodBudget> parent);
+
+private:
+    bool fits(const Usage& usage, float fraction) const;
+    // Add the usage to the parents without checking their limits
+    void add(const Usage& usage);
+
+private:
+    mutable std::mutex _mutex;
+
+    Limits _limits;
+    Usage _usage = {0, 0, 0};
+
+    std::shared_ptr<LodBudget> _parent = nullptr;
+};
+
+} // Namespace Core
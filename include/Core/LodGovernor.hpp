@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint> // uint8_t
+
+namespace Core {
+
+/*
+ * Scales the LOD distances of the planets to keep the frame time close to a target
+ *
+ * The frame times are smoothed with an exponential moving average, and the scale only changes
+ * while the smoothed time is out of the band around the target, by a step limited per frame,
+ * so it converges without oscillating from one frame to the next
+ * The number of displayed quadtrees grows with the square of the scale
+*/
+class LodGovernor {
+public:
+    struct Settings {
+        // Seconds
+        float targetFrameTime = 1.0f / 60.0f;
+        // Relative width of the band around the target where the scale doesn't change
+        float band = 0.1f;
+        float minScale = 0.25f;
+        float maxScale = 2.0f;
+        // Weight of the last frame in the smoothed frame time, in ]0, 1]
+        float smoothing = 0.1f;
+        // Relative change of the scale for a relative error of 1
+        float gain = 0.25f;
+        // Maximum relative change of the scale per frame
+        float maxStep = 0.02f;
+    };
+
+    enum class State: uint8_t {
+        // The frame time is in the band, or the scale is at its limit
+        STABLE = 0,
+        INCREASING = 1,
+        DECREASING = 2
+    };
+
+public:
+    LodGovernor() = default;
+    explicit LodGovernor(const Settings& settings);
+    ~LodGovernor() = default;
+
+    LodGovernor(const LodGovernor& governor) = default;
+    LodGovernor(LodGovernor&& governor) = default;
+
+    LodGovernor& operator=(const LodGovernor& governor) = default;
+    LodGovernor& operator=(LodGovernor&& governor) = default;
+
+    // frameTime is the cost of the last frame in seconds, returns the new scale
+    float update(float frameTime);
+    // Back to a scale of 1, the next frame time is not smoothed
+    void reset();
+
+    const Settings& getSettings() const;
+    void setSettings(const Settings& settings);
+
+    float getScale() const;
+    float getSmoothedFrameTime() const;
+    State getState() const;
+
+private:
+    Settings _settings;
+
+    float _scale = 1.0f;
+    // 0 until the first update
+    float _smoothedFrameTime = 0.0f;
+    State _state = State::STABLE;
+};
+
+} // Namespace Core
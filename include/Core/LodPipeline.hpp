@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstdint> // uint64_t
+#include <functional> // std::function
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex, std::unique_lock
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+#include <Core/SphereQuadTree.hpp> // Core::SphereQuadTree
+#include <Graphics/Camera.hpp> // Graphics::Camera
+#include <System/Timer.hpp> // System::Timer
+#include <System/TripleBuffer.hpp> // System::TripleBuffer
+
+namespace Core {
+
+/*
+ * Level of detail updates on their own thread, one frame ahead of the render thread
+ *
+ * The render thread gives the camera of each frame and uploads the last snapshot computed by the LOD thread,
+ * so the quadtrees of frame N + 1 are updated while frame N is submitted
+ * The cameras and the snapshots are handed over with System::TripleBuffer: none of the threads waits for the other,
+ * the LOD thread only sleeps when there is no new camera
+ * A snapshot not acquired before the next one is skipped, but the height tiles can't be: they are queued
+ * and moved in the acquired snapshot, so all the tiles are uploaded in the order they were loaded
+*/
+class LodPipeline {
+public:
+    // Updates the quadtrees of the planets for the camera, in one snapshot per planet
+    using UpdateFunction = std::function<void(Graphics::Camera& camera, std::vector<SphereQuadTree::Snapshot>& snapshots)>;
+
+    struct Snapshot {
+        std::vector<SphereQuadTree::Snapshot> planets;
+
+        // Frame of the camera used by the update
+        uint64_t cameraFrame = 0;
+        // Reset when the camera was given
+        System::Timer cameraTimer;
+        // Seconds
+        float updateTime = 0.0f;
+
+        // Totals of the LOD thread when the snapshot was published
+        uint64_t updatesNb = 0;
+        uint64_t skippedSnapshotsNb = 0;
+
+        uint64_t generation = 0;
+    };
+
+    struct Metrics {
+        // Camera to display latency of the snapshots, in milliseconds
+        float latency;
+        float averageLatency;
+        float maxLatency;
+        // Frames between the camera of the displayed snapshot and the current camera
+        uint64_t framesLatency;
+        // Time of the last update on the LOD thread, in milliseconds
+        float updateTime;
+
+        uint64_t updatesNb;
+        uint64_t displayedSnapshotsNb;
+        // Snapshots replaced by a newer one before being acquired, or invalidated
+        uint64_t droppedSnapshotsNb;
+    };
+
+public:
+    ~LodPipeline();
+
+    LodPipeline(const LodPipeline& pipeline) = delete;
+    LodPipeline(LodPipeline&& pipeline) = delete;
+
+    LodPipeline& operator=(const LodPipeline& pipeline) = delete;
+    LodPipeline& operator=(LodPipeline&& pipeline) = delete;
+
+    // update is called on the LOD thread, it must only read what the render thread doesn't change without pause
+    static std::unique_ptr<LodPipeline> create(UpdateFunction update);
+
+    // Render thread
+    // Start the update for the camera of a new frame
+    void setCamera(const Graphics::Camera& camera);
+    // Last snapshot of the current generation with the height tiles queued until now,
+    // nullptr if there is no new one since the last call
+    // It stays valid until the next call
+    const Snapshot* acquireSnapshot();
+    // The LOD thread doesn't update the quadtrees while the lock is owned
+    std::unique_lock<std::mutex> pause();
+    // The snapshots and height tiles computed before are dropped, while paused (when the height map is replaced)
+    void invalidate();
+    // Wait for the current update and stop the LOD thread, the last snapshot can still be acquired
+    void stop();
+    const Metrics& getMetrics() const;
+
+private:
+    // Only the LodPipeline::create can create the pipeline
+    LodPipeline(UpdateFunction update);
+
+    bool init();
+
+    void run();
+
+private:
+    struct CameraState {
+        Graphics::Camera camera;
+        uint64_t frame = 0;
+        System::Timer timer;
+    };
+
+    UpdateFunction _update;
+
+    std::thread _thread;
+
+    // Only used to wake up the LOD thread, the cameras and snapshots don't need it
+    std::mutex _wakeMutex;
+    std::condition_variable _wakeCondition;
+    // Protected by _wakeMutex
+    bool _cameraPublished = false;
+    bool _stop = false;
+
+    // Owned by the LOD thread while it updates the quadtrees
+    std::mutex _updateMutex;
+
+    System::TripleBuffer<CameraState> _cameras;
+    System::TripleBuffer<Snapshot> _snapshots;
+
+    // Height tiles of each planet not acquired yet, in the order of the updates
+    std::mutex _heightTilesMutex;
+    std::vector<VirtualHeightMap::Uploads> _heightTiles;
+
+    std::atomic<uint64_t> _generation{0};
+
+    // Render thread
+    uint64_t _frame = 0;
+    float _totalLatency = 0.0f;
+    uint64_t _invalidatedSnapshotsNb = 0;
+    Metrics _metrics{};
+
+    // LOD thread
+    uint64_t _updatesNb = 0;
+    uint64_t _skippedSnapshotsNb = 0;
+};
+
+} // Namespace Core
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array> // std::array
+#include <cstdint> // uint16_t, uint32_t, uint64_t
+#include <memory> // std::unique_ptr
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <glm/vec2.hpp> // glm::vec2
+
+#include <Core/CubeMap.hpp> // Core::CubeMap
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+#include <System/MappedFile.hpp> // System::MappedFile
+#include <System/JobSystem.hpp> // System::JobSystem
+
+namespace Core {
+
+/*
+ * Binary package of a baked planet, memory mapped when it is loaded
+ *
+ * The sections are aligned on pages and stored in the format of their texture,
+ * so they are uploaded directly from the mapping, without parsing or conversion
+ *
+ * Layout (little endian):
+ * - Header
+ * - Section table: Header::sectionsNb Section
+ * - Sections, each one aligned on sectionAlignment, holding the six faces in the cube map order:
+ *   - HEIGHT_MAP: faceSize * faceSize heights in [0, 1] (R32F)
+ *   - GRADIENT_MAP: faceSize * faceSize gradients of the heights in [0, 1], see Core::TexelFormat (RG16F)
+ *   - MIN_MAX: minimum and maximum heights pyramid (RG32F), levels 1 to the 1x1 level of Core::HeightMipChain
+ *
+ * The version is incremented on any change of the layout, packages of an other version must be baked again
+*/
+class PlanetPackage {
+public:
+    enum class SectionType: uint32_t {
+        HEIGHT_MAP = 1,
+        MIN_MAX = 3,
+        GRADIENT_MAP = 4
+    };
+
+    enum class Format: uint32_t {
+        R32F = 1,
+        RG16 = 2,
+        RG32F = 3,
+        RG16F = 4
+    };
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t sectionsNb;
+
+        float size;
+        float maxHeight;
+        uint32_t faceSize;
+
+        // Parameters the height map was generated with
+        uint32_t seed;
+        uint32_t noiseType;
+        uint32_t octaves;
+        float frequency;
+        float lacunarity;
+        float gain;
+        float warpStrength;
+        uint32_t warpOctaves;
+
+        uint32_t reserved[3];
+    };
+
+    struct Section {
+        SectionType type;
+        Format format;
+        // From the beginning of the file
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct Description {
+        float size = 100.0f;
+        float maxHeight = 20.0f;
+        HeightMapGenerator::Parameters heightMapParameters;
+    };
+
+    // Sections data before they are written
+    struct Content {
+        HeightMapGenerator::Faces heights;
+        // Two half floats per texel
+        std::array<std::vector<uint16_t>, CubeMap::facesNb> gradients;
+        // Levels of a face one after the other
+        std::array<std::vector<glm::vec2>, CubeMap::facesNb> minMax;
+    };
+
+    static constexpr uint32_t version = 4;
+    static constexpr uint32_t sectionAlignment = 4096;
+
+public:
+    ~PlanetPackage() = default;
+
+    PlanetPackage(const PlanetPackage& package) = delete;
+    PlanetPackage(PlanetPackage&& package) = delete;
+
+    PlanetPackage& operator=(const PlanetPackage& package) = delete;
+    PlanetPackage& operator=(PlanetPackage&& package) = delete;
+
+    // Map and validate a package
+    static std::unique_ptr<PlanetPackage> create(const std::string& fileName);
+
+    // Bake step: generate the height map, the gradient map and the min/max pyramid of a planet
+    static void generate(const Description& description, System::JobSystem& jobSystem, Content& content);
+    static bool write(const std::string& fileName, const Description& description, const Content& content);
+
+    const Description& getDescription() const;
+    uint32_t getFaceSize() const;
+
+    const float* getHeights(CubeMap::Face face) const;
+    // RG16F, independent of the max height
+    const uint16_t* getGradients(CubeMap::Face face) const;
+
+    uint32_t getMinMaxLevelsNb() const;
+    uint32_t getMinMaxSize(uint32_t level) const;
+    // level in [1, getMinMaxLevelsNb()[
+    const glm::vec2* getMinMax(CubeMap::Face face, uint32_t level) const;
+
+private:
+    // Only the PlanetPackage::create can create the package
+    PlanetPackage() = default;
+
+    bool init(const std::string& fileName);
+
+private:
+    std::unique_ptr<System::MappedFile> _file = nullptr;
+
+    Description _description;
+    uint32_t _faceSize = 0;
+
+    const float* _heights = nullptr;
+    const uint16_t* _gradients = nullptr;
+    const glm::vec2* _minMax = nullptr;
+
+    std::vector<uint32_t> _minMaxSizes;
+    // Offset of each level in the pyramid of a face, in texels
+    std::vector<size_t> _minMaxOffsets;
+    size_t _minMaxFaceSize = 0;
+};
+
+} // Namespace Core
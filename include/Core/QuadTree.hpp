@@ -1,6 +1,8 @@
 #pragma once
 
-#include <cstdint> // uint32_t, uint8_t
+#include <array> // std::array
+#include <atomic> // std::atomic
+#include <cstdint> // uint32_t, uint64_t, uint8_t
 #include <memory> // unique_ptr
 #include <vector> // std::vector
 
@@ -11,14 +13,21 @@
 
 namespace Core {
 
+class SphereQuadTree;
+class QuadTreeBenchmark;
+
 class QuadTree {
     friend class SphereQuadTree;
+    // The micro-benchmarks measure the private functions
+    friend class QuadTreeBenchmark;
 
 public:
     using LevelsTable = std::vector<float>;
 
     // TODO: Move elsewhere
     // widthDir and heightDir are used to calculate normal in vertex shader
+    // The positions are computed for a planet of size 1 (cube in [-0.5, 0.5], sphere of radius 1),
+    // the vertex shader scales them with the planet size
     struct Vertex {
         glm::vec3 cubePos;
         glm::vec3 spherePos;
@@ -56,6 +65,16 @@ public:
         BOTTOM = 5
     };
 
+    // Camera movement accumulated over the updates of a planet, in world units
+    // The distance between two updates is bounded by translation + rotation * (distance to the camera + translation)
+    struct CameraMotion {
+        double translation = 0.0;
+        // Sum of the displacements of the camera axes, the chord of the rotation for a unit distance
+        double rotation = 0.0;
+        // Sum of the changes of the LOD scale, they move the split distances by the levels table times the change
+        double lodScale = 0.0;
+    };
+
 private:
     struct Children {
         std::unique_ptr<QuadTree> topLeft = nullptr;
@@ -78,7 +97,7 @@ private:
         Vertex bottomRight;
     };
 
-    // AABB box used for frustum culling
+    // AABB box used for frustum culling, in planet size units like the vertices
     struct AABB {
         // Correspond to QuadTree::Corners
         // padded on left/right and top/bottom sides
@@ -93,6 +112,8 @@ private:
         // Is the same as AABB::corners
         // except that the rounded shape bend is added
         // to fill all the quadtree shape
+        // The max height is not included, it's added when the box is tested (see QuadTree::getHeightExtrusion)
+        // so changing the max height doesn't update the boxes
         //  |\          \ |
         //  | \          \|
         //  |  |    =>    |
@@ -104,6 +125,21 @@ private:
             glm::vec3 bottomLeft;
             glm::vec3 bottomRight;
         } cornersUp;
+
+        // Center of the corners and distance to the farthest one, without the max height
+        glm::vec3 center;
+        float radius;
+    };
+
+    // Decisions of a quadtree and its children, kept by the updates while the camera moves less than the margin
+    struct Coherence {
+        // Distance the quadtrees can move relatively to the camera before their culling, split or merge can change,
+        // 0 to evaluate them at the next update
+        float margin = 0.0f;
+        // Distance from the camera to the farthest AABB box corner of the quadtrees, the rotations move it the most
+        float reach = 0.0f;
+        // Planet camera motion when the margin was computed
+        CameraMotion motion;
     };
 
 public:
@@ -126,7 +162,12 @@ public:
     QuadTree& operator=(const QuadTree& quadTree) = delete;
     QuadTree&& operator=(QuadTree&& quadTree) = delete;
 
-    void update(Graphics::Camera& camera);
+    // Returns the number of quadtrees whose decisions were evaluated, the others kept them (see Coherence)
+    uint32_t update(Graphics::Camera& camera);
+    // Generate the children the leaves will need while the camera moves from cameraPos to predictedPos,
+    // and prefetch their height tiles
+    // They are not displayed, split uses them instead of generating new ones
+    void prefetch(const glm::vec3& cameraPos, const glm::vec3& predictedPos);
     void updateNeighBors();
     void setNeighBors(QuadTree* top, QuadTree* left, QuadTree* right, QuadTree* bottom);
 
@@ -136,22 +177,59 @@ public:
 
     void setNeighbor(Face fromFace, NeighborOrientation neighborOrientation, QuadTree* neighbor);
 
+    // Number of nodes in the quadtree, including this one
+    uint32_t getNodesNb() const;
+
+    // Can be called from any thread while the quadtrees are updated, inside SphereQuadTree::walk
+    Face getFace() const;
+    uint32_t getLevel() const;
+    // Positions on the sphere of radius 1
+    const glm::vec3& getCenter() const;
+    void getSphereCorners(glm::vec3& topLeft, glm::vec3& topRight, glm::vec3& bottomLeft, glm::vec3& bottomRight) const;
+    // nullptr if the quadtree is not split
+    const QuadTree* readChild(ChildOrientation childOrientation) const;
+
 private:
     void addChildrenVertices(System::Vector<Vertex>& vertices, System::Vector<uint32_t>& indices);
     void addDebugVertices(System::Vector<glm::vec3>& vertices, System::Vector<uint32_t>& indices);
 
-    void updateShapeAABB();
-
     glm::vec3 calculateSpherePos(const glm::vec3& cubePos);
     void calculateShapeAABB();
-
-    bool needSplit(const Graphics::Camera& camera);
-    void split();
-    bool needMerge(const Graphics::Camera& camera);
+    // Offset of the AABB box upper corners for the planet max height
+    glm::vec3 getHeightExtrusion() const;
+
+    // distance is the distance from the camera to the center, in planet size units
+    bool needSplit(float distance);
+    // priority is the distance relatively to the split distance, in [0, 1], the lowest priorities are refused first
+    // The prefetch uses 2, below all the splits
+    // Returns false if the budget refused the split (see SphereQuadTree::reserveSplit)
+    bool split(float priority);
+    bool createChildren(Children& children, float priority) const;
+    // Delete the prefetched children of the leaves, and the ones they prefetched
+    void releasePrefetchedChildren();
+    bool needMerge(float distance);
+    // The children are cached by the planet, split can reattach them (see SphereQuadTree::cacheChildren)
     void merge();
-
-    bool isInsideFrustum(Graphics::Camera& camera) const;
-    bool isOccludedByHorizon(const Graphics::Camera& camera) const;
+    // Reset the state of a cached quadtree, its shape didn't change
+    void reattach();
+    // Same for the quadtrees of the same face, level and position, whatever their parent
+    uint64_t getKey() const;
+
+    // margin is a distance the camera can move without changing the result
+    bool isInsideFrustum(Graphics::Camera& camera, float& margin) const;
+    bool isOccludedByHorizon(const glm::vec3& cameraPos, float& margin) const;
+    float getSplitMargin(float distance) const;
+    float getReach(const Graphics::Camera& camera) const;
+
+    // Margin and reach of the decisions at the motion of the current update
+    float getRemainingMargin(const CameraMotion& motion) const;
+    float getCurrentReach(const CameraMotion& motion) const;
+
+    // Request the height tile of the quadtree level if the height map is streamed
+    void requestHeightTile() const;
+    void prefetchHeightTile() const;
+    // Same for the displayed quadtrees, when the update keeps their decisions
+    void requestHeightTiles() const;
 
 private:
     const SphereQuadTree& _planet;
@@ -161,8 +239,17 @@ private:
     float _size = 0.0f;
 
     Children _children;
+    // Generated by prefetch while the quadtree is not split, nullptr if there are none
+    std::unique_ptr<Children> _prefetchedChildren = nullptr;
     Neighbors _neighbors;
     bool _split = false;
+    // Not culled by the last update
+    bool _visible = false;
+    Coherence _coherence;
+
+    // Children read by the other threads, in ChildOrientation order
+    // They are published once linked to their neighbors, and unpublished by merge (see SphereQuadTree::walk)
+    std::array<std::atomic<const QuadTree*>, 4> _sharedChildren{};
 
     glm::vec3 _pos;
     glm::vec3 _widthDir;
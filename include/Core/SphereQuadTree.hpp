@@ -1,63 +1,247 @@
 #pragma once
 
-#include <cstdint> // uint32_t
-#include <memory> // std::unique_ptr
+#include <atomic> // std::atomic
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t, uint64_t
+#include <functional> // std::function
+#include <memory> // std::unique_ptr, std::shared_ptr
 #include <unordered_map> // std::unordered_map
 #include <vector> // std::vector
 
+#include <Core/LodBudget.hpp> // Core::LodBudget
+#include <Core/PlanetPackage.hpp> // Core::PlanetPackage
 #include <Core/QuadTree.hpp> // Core::QuadTree
+#include <Core/VirtualHeightMap.hpp> // Core::VirtualHeightMap
 #include <Graphics/Camera.hpp> // Graphics::Camera
-#include <Graphics/API/Buffer.hpp> // Graphics::API::Buffer
-#include <Graphics/API/Texture.hpp> // Graphics::API::Texture
-
-namespace Graphics {
-    class Renderer;
-} // Namespace Graphics
+#include <System/EpochReclaimer.hpp> // System::EpochReclaimer
+#include <System/LruCache.hpp> // System::LruCache
+#include <System/Vector.hpp> // System::Vector
 
 namespace Core {
 
+/*
+ * Level of detail of a planet, made of one quadtree per cube face
+ *
+ * It does not use OpenGL: the vertices and indices of the displayed quadtrees are emitted in memory
+ * on each update, and the presentation layer (Graphics::Planet) uploads them
+ *
+ * The updates only evaluate the quadtrees whose culling, split or merge can have changed since the camera moved
+ * by more than their margins (see QuadTree::Coherence), a still camera doesn't evaluate any quadtree
+ *
+ * The camera position is extrapolated from its velocity, and the quadtrees it will need are generated ahead
+ * with their height tiles (see QuadTree::prefetch), under a budget of quadtrees and tile slots
+ *
+ * The children of the merged quadtrees are kept in a System::LruCache under a memory cap,
+ * a next split at the same place reattaches them instead of generating them again
+ *
+ * The quadtrees, their vertices and the height tiles are reserved in a Core::LodBudget: the splits refused by the budget
+ * are deferred, and the split distances are scaled down until the farthest quadtrees are merged for them
+ *
+ * Other threads can walk the quadtrees without lock while they are updated: the quadtrees evicted from the cache
+ * are retired to a System::EpochReclaimer and deleted by a next update, once the walks reading them are finished
+*/
 class SphereQuadTree {
+    // The quadtrees cache their merged children
+    friend class QuadTree;
+
+public:
+    // Vertices and indices of the displayed quadtrees
+    template<typename VertexType>
+    struct Mesh {
+        Mesh(uint32_t chunkSize): vertices(chunkSize), indices(chunkSize) {}
+
+        System::Vector<VertexType> vertices;
+        System::Vector<uint32_t> indices;
+    };
+
+    // Result of an update, owned by the caller so it can be uploaded on an other thread (see Core::LodPipeline)
+    struct Snapshot {
+        Mesh<QuadTree::Vertex> mesh{500};
+        Mesh<glm::vec3> debugMesh{500};
+        // Appended by each update, the caller clears them once they are uploaded
+        VirtualHeightMap::Uploads heightTiles;
+    };
+
+    struct PrefetchSettings {
+        // Updates the camera position is extrapolated by, 0 disables the prefetch
+        uint32_t lookahead = 30;
+        // Updates between two prefetches, the prediction changes slowly
+        uint32_t interval = 4;
+        // Prefetched quadtrees not displayed yet
+        uint32_t maxNodesNb = 1024;
+        // Quadtrees generated by a prefetch, so the cost is spread over the updates
+        uint32_t maxNewNodesNb = 64;
+        // Slots of the virtual height map the prefetched tiles can use (see VirtualHeightMap::prefetch)
+        uint32_t tileSlotsNb = 128;
+    };
+
+    struct PrefetchStatistics {
+        // Prefetched quadtrees not displayed yet
+        uint32_t prefetchedNodesNb;
+        // Since the creation of the planet
+        uint64_t splitsNb;
+        // Splits which used the prefetched children
+        uint64_t prefetchedSplitsNb;
+    };
+
+    struct NodesCacheStatistics {
+        // Merged quadtrees kept in the cache
+        uint32_t cachedNodesNb;
+        // Children looked up by the splits and the prefetches, since the creation of the planet
+        uint64_t hitsNb;
+        uint64_t missesNb;
+    };
+
 public:
     ~SphereQuadTree() = default;
 
+    // The quadtrees keep a reference to their planet, it can't be moved
     SphereQuadTree(const SphereQuadTree& quadTree) = delete;
-    SphereQuadTree(SphereQuadTree&& quadTree);
+    SphereQuadTree(SphereQuadTree&& quadTree) = delete;
 
     SphereQuadTree& operator=(const SphereQuadTree& quadTree) = delete;
-    SphereQuadTree& operator=(SphereQuadTree&& quadTree);
+    SphereQuadTree& operator=(SphereQuadTree&& quadTree) = delete;
 
-    static std::unique_ptr<SphereQuadTree> create(const Graphics::Renderer* renderer, float size, float maxHeight);
+    static std::unique_ptr<SphereQuadTree> create(float size, float maxHeight);
+    // Size and max height of a baked package, the package is kept for its height map
+    static std::unique_ptr<SphereQuadTree> create(std::shared_ptr<const PlanetPackage> package);
 
+    // Same as updateQuadTrees followed by updateMeshes
     void update(Graphics::Camera& camera);
+    // Same as update, the meshes are emitted in the snapshot instead of getMesh and getDebugMesh
+    // It does not read the snapshots of the previous updates, several snapshots can be used in turn
+    void update(Graphics::Camera& camera, Snapshot& snapshot);
+    // Split and merge the quadtrees for the camera
+    void updateQuadTrees(Graphics::Camera& camera);
+    // Emit the vertices and indices of the quadtrees
+    void updateMeshes();
 
     float getSize() const;
     float getMaxHeight() const;
-    const Graphics::API::Buffer& getBuffer() const;
-    const Graphics::API::Buffer& getDebugBuffer() const;
+    // Split distance of each level, in planet size units, before the LOD scale
     const QuadTree::LevelsTable& getLevelsTable() const;
-    const Graphics::API::Texture& getHeightMap() const;
-    const Graphics::API::Texture& getNormalMap() const;
+    const Mesh<QuadTree::Vertex>& getMesh() const;
+    const Mesh<glm::vec3>& getDebugMesh() const;
+    uint32_t getNodesNb() const;
+    // Merged quadtrees not deleted yet
+    uint32_t getRetiredNodesNb() const;
+    // Quadtrees whose decisions were evaluated by the last update
+    uint32_t getEvaluatedNodesNb() const;
+    // nullptr if the planet is not loaded from a package
+    const std::shared_ptr<const PlanetPackage>& getPackage() const;
+    // nullptr if the height map is not streamed, the quadtrees request the tiles they display
+    VirtualHeightMap* getVirtualHeightMap() const;
+
+    void setVirtualHeightMap(std::unique_ptr<VirtualHeightMap> virtualHeightMap);
 
     void setMaxHeight(float maxHeight);
     void setSize(float size);
 
+    // Multiplies the split distances of the levels table, used by the next update (see Core::LodGovernor)
+    // Can be called from any thread
+    float getLodScale() const;
+    void setLodScale(float lodScale);
+
+    // Keep the decisions of the quadtrees the camera movement can't change, enabled by default
+    bool temporalCoherence() const;
+    void temporalCoherence(bool enabled);
+
+    const PrefetchSettings& getPrefetchSettings() const;
+    void setPrefetchSettings(const PrefetchSettings& settings);
+    PrefetchStatistics getPrefetchStatistics() const;
+
+    // Bytes of the merged quadtrees kept for the next splits, 0 disables the cache
+    size_t getNodesCacheSize() const;
+    void setNodesCacheSize(size_t size);
+    NodesCacheStatistics getNodesCacheStatistics() const;
+
+    // Memory of the planet, its parent is the budget shared with the other planets
+    // The usage can be read from any thread
+    LodBudget& getBudget();
+    const LodBudget& getBudget() const;
+    // Splits refused by the budget during the last update
+    uint32_t getDeferredSplitsNb() const;
+    // Multiplies the split distances while the budget defers splits
+    float getBudgetScale() const;
+
+    // Can be called from any thread while the quadtrees are updated, the quadtrees stay valid until it returns
+    // visitor returns false to skip the children of the quadtree
+    void walk(const std::function<bool(const QuadTree& quadTree)>& visitor) const;
+    // Delete the merged quadtrees no walk can read anymore, done by updateQuadTrees
+    void collectRetiredNodes();
+
 private:
     // Only the SphereQuadTree::create can create the quadtree
     SphereQuadTree(float size, float maxHeight);
 
-    bool init(const Graphics::Renderer* renderer);
+    bool init();
 
     void initChildren();
-    bool initHeightMap();
-    bool initNormalMap(const Graphics::Renderer* renderer);
     void initLevelsDistance();
-    bool initBuffer();
-    bool initDebugBuffer();
+
+    System::EpochReclaimer<QuadTree>& getNodesReclaimer() const;
+    // The evicted children are retired, other threads may still read them
+    // Over the node limit of the budget, the children are retired instead of cached
+    void cacheChildren(uint64_t key, QuadTree::Children children) const;
+    // Returns false if the children of the key are not cached
+    bool takeCachedChildren(uint64_t key, QuadTree::Children& children) const;
+    void retireChildren(QuadTree::Children children) const;
+    // Split distance of the level for the current update, in planet size units
+    float getSplitDistance(uint32_t level) const;
+
+    // Accumulate the camera movement since the last update, false if the quadtrees must all be evaluated
+    bool updateCameraMotion(const Graphics::Camera& camera);
+    const QuadTree::CameraMotion& getCameraMotion() const;
+    // The current update can keep the decisions of the quadtrees
+    bool isCoherentUpdate() const;
+
+    // Extrapolate the camera position and prefetch the quadtrees, after the quadtrees are updated
+    void prefetch(const Graphics::Camera& camera);
+    // Release the prefetched quadtrees of all the faces, when the prefetch is disabled or the planet is over its budget
+    void releasePrefetchedChildren();
+    // Budget of the prefetched quadtrees, false if there is not enough left
+    bool reservePrefetchedNodes(uint32_t nodesNb) const;
+    void releasePrefetchedNodes(uint32_t nodesNb) const;
+    void addSplit(bool prefetched) const;
+
+    // Budget of the vertices of a split and of the new quadtrees, priority is the one of QuadTree::split
+    // The cached quadtrees farthest from the camera are evicted to make room for the new ones
+    bool reserveSplit(float priority) const;
+    void releaseSplit() const;
+    bool reserveNodes(uint32_t nodesNb, float priority) const;
+    void releaseNodes(uint32_t nodesNb) const;
+    void addDeferredSplit() const;
+    // Returns false if the cache is empty
+    bool evictFarthestCachedChildren() const;
+    // Scale the split distances for the splits deferred by the last update, before the quadtrees are updated
+    void updateBudgetScale();
+    // Reserve the slots of the tiles requested by the quadtrees, before the virtual height map is updated
+    void updateTilesBudget();
+
+    void updateMesh(Mesh<QuadTree::Vertex>& mesh) const;
+    void updateDebugMesh(Mesh<glm::vec3>& mesh) const;
 
 private:
     float _size = 0.0f;
     float _maxHeight = 0.0f;
 
+    std::shared_ptr<const PlanetPackage> _package = nullptr;
+    std::unique_ptr<VirtualHeightMap> _virtualHeightMap = nullptr;
+
+    // Merged quadtrees read by the walks of other threads
+    std::unique_ptr<System::EpochReclaimer<QuadTree>> _nodesReclaimer = nullptr;
+    // Children of the merged quadtrees, by key of their parent (see QuadTree::getKey)
+    std::unique_ptr<System::LruCache<uint64_t, QuadTree::Children>> _nodesCache = nullptr;
+    size_t _nodesCacheSize = 0;
+
+    std::unique_ptr<LodBudget> _budget = nullptr;
+    float _budgetScale = 1.0f;
+    // Updates since the budget scale changed
+    uint32_t _budgetUpdatesNb = 0;
+    mutable uint32_t _deferredSplitsNb = 0;
+    // Slots of the virtual height map reserved in the budget
+    uint32_t _tileSlotsNb = 0;
+
     std::unique_ptr<QuadTree> _leftQuadTree = nullptr;
     std::unique_ptr<QuadTree> _rightQuadTree = nullptr;
     std::unique_ptr<QuadTree> _frontQuadTree = nullptr;
@@ -65,17 +249,55 @@ private:
     std::unique_ptr<QuadTree> _topQuadTree = nullptr;
     std::unique_ptr<QuadTree> _bottomQuadTree = nullptr;
 
-    // Buffer storing vertices and indices
-    Graphics::API::Buffer _buffer;
-    // Buffer storing aabb boxes
-    Graphics::API::Buffer _debugBuffer;
+    // Vertices and indices of the quadtrees
+    // Resize is performed only every 500 vertices/indices added
+    // and the memory is kept between updates
+    Mesh<QuadTree::Vertex> _mesh{500};
+    // Vertices and indices of the quadtrees aabb boxes
+    Mesh<glm::vec3> _debugMesh{500};
 
     // Store distance needed for each level
     QuadTree::LevelsTable _levelsTable;
+    std::atomic<float> _lodScale{1.0f};
+    // _lodScale at the beginning of the current update, so all the quadtrees use the same
+    float _updateLodScale = 1.0f;
+
+    // Camera and parameters of the last update, the margins of the quadtrees are not valid anymore if they change
+    struct CoherenceState {
+        bool valid = false;
+        glm::vec3 pos;
+        glm::vec3 forward;
+        glm::vec3 up;
+        glm::vec3 right;
+        float fov;
+        float nearPlane;
+        float farPlane;
+        float aspect;
+        bool frustumLocked;
+        float lodScale;
+        float size;
+        float maxHeight;
+    };
 
-    Graphics::API::Texture _heightMap;
-    Graphics::API::Texture _normalMap;
+    bool _temporalCoherence = true;
+    bool _coherentUpdate = false;
+    CoherenceState _coherenceState;
+    QuadTree::CameraMotion _cameraMotion;
+    uint32_t _evaluatedNodesNb = 0;
+
+    struct CameraVelocity {
+        bool valid = false;
+        glm::vec3 pos;
+        // Smoothed camera movement per update
+        glm::vec3 velocity;
+        uint32_t updatesNb = 0;
+    };
+
+    PrefetchSettings _prefetchSettings;
+    CameraVelocity _cameraVelocity;
+    // Changed by the quadtrees during the updates
+    mutable PrefetchStatistics _prefetchStatistics{};
+    mutable uint32_t _newPrefetchedNodesNb = 0;
 };
 
 } // Namespace Core
-
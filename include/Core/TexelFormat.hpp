@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <cstdint> // uint32_t
+
+#include <glm/vec2.hpp> // glm::vec2
+
+namespace Core {
+
+/*
+ * Storage formats of the height map and gradient map textures, and their CPU side encoding
+ *
+ * The heights are in [0, 1], a single channel is stored
+ * The gradients are the Sobel filter of the heights in [0, 1], so they don't depend on the max height:
+ * the shaders scale them with the max height to get the normals
+*/
+class TexelFormat {
+public:
+    enum class Height: uint32_t {
+        R16 = 0,
+        R16F = 1,
+        R32F = 2
+    };
+
+    enum class Gradient: uint32_t {
+        RG16F = 0,
+        RG32F = 1
+    };
+
+    // Height map and gradient map formats of a planet
+    struct Formats {
+        Height heightMap = Height::R16;
+        Gradient gradientMap = Gradient::RG16F;
+    };
+
+public:
+    TexelFormat() = delete;
+
+    // Bytes per texel
+    static size_t getSize(Height format);
+    static size_t getSize(Gradient format);
+
+    // Write texelsNb * getSize(format) bytes
+    static void encodeHeights(const float* heights, size_t texelsNb, Height format, void* texels);
+    // Write getSize(format) bytes
+    static void encodeGradient(const glm::vec2& gradient, Gradient format, void* texel);
+};
+
+} // Namespace Core
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <array> // std::array
+#include <condition_variable> // std::condition_variable
+#include <cstdint> // uint16_t, uint32_t, uint64_t
+#include <memory> // std::unique_ptr, std::shared_ptr
+#include <mutex> // std::mutex
+#include <thread> // std::thread
+#include <unordered_map> // std::unordered_map
+#include <vector> // std::vector
+
+#include <glm/vec3.hpp> // glm::vec3
+
+#include <Core/CubeMap.hpp> // Core::CubeMap
+#include <Core/HeightTileSet.hpp> // Core::HeightTileSet
+
+namespace Core {
+
+/*
+ * Virtual height map streamed from a Core::HeightTileSet
+ *
+ * The tiles are copied in a fixed number of slots (the physical tile cache), and an indirection table
+ * gives for each tile of the finest level the slot and the level of the finest resident tile covering it
+ *
+ * The tiles are requested by the quadtrees and loaded by a background thread
+ * The least recently used tiles are evicted when there is no free slot, the level 0 tiles are always resident
+ * The slots used can be limited below the slots of the cache, for a memory budget (see Core::LodBudget)
+ * The tiles can also be prefetched before they are displayed: they are loaded after the requested ones,
+ * and the prefetched tiles not requested yet are limited to a budget of slots
+ *
+ * Except the loading, everything is done on the thread calling update, it's not thread safe
+*/
+class VirtualHeightMap {
+public:
+    struct Tile {
+        CubeMap::Face face;
+        uint32_t level;
+        uint32_t x;
+        uint32_t y;
+    };
+
+    struct IndirectionEntry {
+        uint16_t slot;
+        uint16_t level;
+    };
+
+    // Entries of the indirection table changed by the last update, [xMin, xMax[ * [yMin, yMax[
+    struct DirtyRect {
+        uint32_t xMin;
+        uint32_t yMin;
+        uint32_t xMax;
+        uint32_t yMax;
+    };
+
+    struct Statistics {
+        uint32_t residentTilesNb;
+        // Requested tiles waiting for a slot or being loaded
+        uint32_t pendingTilesNb;
+        uint64_t loadsNb;
+        uint64_t evictionsNb;
+        // Prefetched tiles not requested yet, in any state
+        uint32_t prefetchedTilesNb;
+        // Prefetched tiles already resident when they were requested
+        uint64_t prefetchHitsNb;
+    };
+
+    // Copy of the changes of updates, they can be uploaded on an other thread than the one calling update
+    struct Uploads {
+        struct Slot {
+            uint32_t slot;
+            std::vector<uint16_t> texels;
+        };
+
+        struct Indirection {
+            CubeMap::Face face;
+            DirtyRect rect;
+            // Row by row
+            std::vector<IndirectionEntry> entries;
+        };
+
+        // In the order of the updates, they must be uploaded in this order
+        std::vector<Slot> slots;
+        std::vector<Indirection> indirections;
+        // Statistics of the last update
+        Statistics statistics;
+
+        void clear();
+    };
+
+public:
+    ~VirtualHeightMap();
+
+    VirtualHeightMap(const VirtualHeightMap& virtualHeightMap) = delete;
+    VirtualHeightMap(VirtualHeightMap&& virtualHeightMap) = delete;
+
+    VirtualHeightMap& operator=(const VirtualHeightMap& virtualHeightMap) = delete;
+    VirtualHeightMap& operator=(VirtualHeightMap&& virtualHeightMap) = delete;
+
+    // slotsNb must be greater than the 6 tiles of the level 0
+    static std::unique_ptr<VirtualHeightMap> create(std::shared_ptr<const HeightTileSet> tileSet, uint32_t slotsNb);
+
+    // Tile of the level (clamped to the tile set levels) covering the direction
+    Tile getTile(const glm::vec3& direction, uint32_t level) const;
+
+    // Mark the tile as used by the current frame, it's loaded if it's not resident
+    void request(const Tile& tile);
+    // Load the tile for the next frames if the prefetch budget allows it
+    // It must be prefetched again every few frames until it's requested, or it's dropped
+    void prefetch(const Tile& tile);
+
+    // Once per frame: collect the loaded tiles, evict the least recently used tiles and start the new loads
+    void update();
+
+    const HeightTileSet& getTileSet() const;
+    uint32_t getSlotsNb() const;
+    // Slots the prefetched tiles not requested yet can use, 0 disables the prefetch
+    uint32_t getPrefetchSlotsNb() const;
+    void setPrefetchSlotsNb(uint32_t prefetchSlotsNb);
+    // Slots the tiles can use, the next update evicts the tiles above it which are not used by the frame
+    uint32_t getUsableSlotsNb() const;
+    void setUsableSlotsNb(uint32_t usableSlotsNb);
+    // Texels per side of a slot, border included
+    uint32_t getSlotSize() const;
+    const uint16_t* getSlotTexels(uint32_t slot) const;
+    // Slots loaded by the last update, their texels must be uploaded
+    const std::vector<uint32_t>& getLoadedSlots() const;
+
+    // Entries per side of the indirection table of a face
+    uint32_t getIndirectionSize() const;
+    const IndirectionEntry* getIndirection(CubeMap::Face face) const;
+    // Empty rect (xMin == xMax) if the face did not change
+    const std::array<DirtyRect, CubeMap::facesNb>& getDirtyRects() const;
+    // Append the loaded slots and the indirection changes of the last update
+    void addUploads(Uploads& uploads) const;
+
+    Statistics getStatistics() const;
+
+private:
+    enum class TileState {
+        // Waiting for a slot
+        REQUESTED,
+        LOADING,
+        RESIDENT,
+        // Not in the tile set, it's not requested again
+        MISSING
+    };
+
+    struct TileEntry {
+        Tile tile;
+        TileState state;
+        uint32_t slot;
+        uint64_t lastUsedFrame;
+        // Prefetched and not requested yet
+        bool prefetched;
+    };
+
+    struct Load {
+        uint64_t key;
+        Tile tile;
+        uint32_t slot;
+        bool loaded;
+    };
+
+    static constexpr uint32_t noSlot = UINT32_MAX;
+
+private:
+    // Only the VirtualHeightMap::create can create the virtual height map
+    VirtualHeightMap() = default;
+
+    bool init(std::shared_ptr<const HeightTileSet> tileSet, uint32_t slotsNb);
+
+    static uint64_t getKey(const Tile& tile);
+
+    void collectLoads();
+    void startLoads();
+    void evict(uint32_t slot);
+    // The tile is requested, or dropped
+    void unprefetch(TileEntry& entry);
+
+    // Point the indirection entries covered by the tile to its slot, if the tile is finer than the current one
+    void setIndirection(const Tile& tile, uint32_t slot);
+    // Point the indirection entries using the slot of the evicted tile to its finest resident ancestor
+    void resetIndirection(const Tile& tile, uint32_t slot);
+    void addDirtyRect(CubeMap::Face face, const DirtyRect& rect);
+
+    void loadTiles();
+
+private:
+    std::shared_ptr<const HeightTileSet> _tileSet = nullptr;
+
+    uint32_t _slotsNb = 0;
+    uint32_t _slotSize = 0;
+    std::vector<uint16_t> _slotsTexels;
+    // Key of the tile in each slot, UINT64_MAX if the slot is free
+    std::vector<uint64_t> _slotsKeys;
+    std::vector<uint32_t> _freeSlots;
+    std::vector<uint32_t> _loadedSlots;
+
+    std::unordered_map<uint64_t, TileEntry> _tiles;
+    uint64_t _frame = 0;
+    uint32_t _loadingTilesNb = 0;
+    uint32_t _prefetchSlotsNb = 0;
+    uint32_t _usableSlotsNb = 0;
+
+    uint32_t _indirectionSize = 0;
+    std::array<std::vector<IndirectionEntry>, CubeMap::facesNb> _indirection;
+    std::array<DirtyRect, CubeMap::facesNb> _dirtyRects;
+
+    Statistics _statistics = {0, 0, 0, 0, 0, 0};
+
+    // Shared with the loading thread
+    std::mutex _loadsMutex;
+    std::condition_variable _loadsCondition;
+    std::vector<Load> _pendingLoads;
+    std::vector<Load> _finishedLoads;
+    bool _stopped = false;
+    std::thread _loadingThread;
+};
+
+} // Namespace Core
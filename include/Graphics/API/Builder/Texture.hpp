@@ -1,11 +1,13 @@
 #pragma once
 
+#include <memory> // std::shared_ptr
 #include <string> // std::string
 #include <unordered_map> // std::unordered_map
 #include <vector> // std::vector
 
 #include <GL/glew.h> // GLint, GLenum, GLsizei
 
+#include <Graphics/API/ImageCache.hpp> // Graphics::API::ImageCache
 #include <Graphics/API/Texture.hpp> // Graphics::API::Texture
 
 namespace Graphics {
@@ -18,21 +20,28 @@ public:
         friend Texture;
 
     public:
-        Image(GLenum type = 0);
-        ~Image();
+        Image(GLenum type = 0, GLint level = 0);
+        ~Image() = default;
 
         void setType(GLenum type);
         void setFileName(const std::string& fileName);
+        // Upload data owned by the caller, it must be valid until the texture is built
+        void setData(const void* data, GLsizei width, GLsizei height);
 
     private:
+        // Decode the file with the image cache, can be called from any thread
+        bool loadFile();
         bool getData(void*& data, GLsizei& width, GLsizei& height);
 
     private:
         GLenum _type = 0; // 0 means use same as texture type
+        GLint _level = 0; // Mipmap level, its size is the size of the level 0 divided by 2^level
         std::string _fileName; // Optionally load texture from a file
+        const void* _externalData = nullptr; // Optionally upload data owned by the caller
 
         // Used internally
-        void* _data = nullptr;
+        std::shared_ptr<const ImageCache::Image> _image;
+        bool _fileLoaded = false;
         int _width = 0;
         int _height = 0;
         Texture* _texture = nullptr;
@@ -55,6 +64,8 @@ public:
     void setType(GLenum type);
     void setWidth(GLsizei width);
     void setHeight(GLsizei height);
+    // Layers of a GL_TEXTURE_2D_ARRAY, its single image holds all of them
+    void setDepth(GLsizei depth);
     void setInternalFormat(GLint internalFormat);
     void setFormat(GLint format);
     void setDataType(GLenum dataType);
@@ -64,10 +75,15 @@ public:
     template<typename... Args>
     Image* addImage(Args... args);
 
+private:
+    // Decode the images files in parallel before the upload
+    void decodeImages();
+
 private:
     GLenum _type = GL_TEXTURE_2D;
     GLsizei _width = 0;
     GLsizei _height = 0;
+    GLsizei _depth = 1;
 
     GLint _internalFormat = GL_RGBA;
     GLint _format = GL_RGBA;
@@ -6,6 +6,12 @@ inline void  Texture::Image::setFileName(const std::string& fileName) {
     _fileName = fileName;
 }
 
+inline void Texture::Image::setData(const void* data, GLsizei width, GLsizei height) {
+    _externalData = data;
+    _width = width;
+    _height = height;
+}
+
 inline void Texture::setType(GLenum type) {
     _type = type;
 }
@@ -18,6 +24,10 @@ inline void Texture::setHeight(GLsizei height) {
     _height = height;
 }
 
+inline void Texture::setDepth(GLsizei depth) {
+    _depth = depth;
+}
+
 inline void Texture::setInternalFormat(GLint internalFormat) {
     _internalFormat = internalFormat;
 }
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint> // uint32_t, uint64_t
+#include <memory> // std::shared_ptr
+#include <string> // std::string
+
+namespace Graphics {
+namespace API {
+
+/*
+ * Decoded images shared by all the textures, keyed by file name, modification time and requested format
+ * An image file loaded several times (for example the six faces of a cube map) is decoded once,
+ * and all the textures are uploaded from the same buffer
+ *
+ * The cache only keeps weak references, an image is freed when the last texture builder using it is destroyed
+ * The entries of the freed images and of the failed decodings are removed, the cache doesn't grow with the edited files
+ * get can be called by several threads, an image requested while it is decoded by an other thread is not decoded twice
+*/
+class ImageCache {
+public:
+    enum class DataType: uint8_t {
+        UNSIGNED_BYTE,
+        FLOAT
+    };
+
+    class Image {
+    public:
+        Image() = default;
+        ~Image();
+
+        Image(const Image& image) = delete;
+        Image(Image&& image) = delete;
+
+        Image& operator=(const Image& image) = delete;
+        Image& operator=(Image&& image) = delete;
+
+        const void* getData() const;
+        int getWidth() const;
+        int getHeight() const;
+        int getComponentsNb() const;
+        // Number of components of the file, can be different than the requested number of components
+        int getFileComponentsNb() const;
+
+    private:
+        friend ImageCache;
+
+        void* _data = nullptr;
+        int _width = 0;
+        int _height = 0;
+        int _componentsNb = 0;
+        int _fileComponentsNb = 0;
+    };
+
+    struct Statistics {
+        // Images found in the cache or being decoded by an other thread
+        uint64_t hits;
+        // Decoded images
+        uint64_t misses;
+    };
+
+public:
+    ImageCache() = delete;
+
+    // nullptr if the file can't be decoded
+    static std::shared_ptr<const Image> get(const std::string& fileName, int componentsNb, DataType dataType);
+
+    static Statistics getStatistics();
+
+private:
+    static std::shared_ptr<const Image> decode(const std::string& fileName, int componentsNb, DataType dataType);
+};
+
+} // Namespace API
+} // Namespace Graphics
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string> // std::string
 #include <unordered_map> // std::unordered_map
 
 #include <GL/glew.h> // GLenum, GLuint
@@ -32,6 +32,18 @@ public:
     void unBind() const;
 
     void updateData(void* data, GLenum type = 0) const;
+    // Update a region of a layer of a GL_TEXTURE_2D_ARRAY, rowLength is the number of texels per row of data
+    void updateLayer(
+        uint32_t layer,
+        uint32_t x,
+        uint32_t y,
+        uint32_t width,
+        uint32_t height,
+        uint32_t rowLength,
+        const void* data
+    ) const;
+    // Generate the levels after the level 0 from it
+    void generateMipmaps() const;
 
     uint32_t getWidth() const;
     uint32_t getHeight() const;
@@ -71,6 +71,18 @@ public:
         const glm::vec3& posG,
         const glm::vec3& posH
     ) const;
+    // Same as isAABBInside, margin is a distance the positions can move without changing the result
+    bool isAABBInside(
+        const glm::vec3& posA,
+        const glm::vec3& posB,
+        const glm::vec3& posC,
+        const glm::vec3& posD,
+        const glm::vec3& posE,
+        const glm::vec3& posF,
+        const glm::vec3& posG,
+        const glm::vec3& posH,
+        float& margin
+    ) const;
 
 private:
     NearPlane _nearPlane;
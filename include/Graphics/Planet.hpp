@@ -0,0 +1,126 @@
+#pragma once
+
+#include <memory> // std::unique_ptr
+#include <string> // std::string
+
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+#include <Core/SphereQuadTree.hpp> // Core::SphereQuadTree
+#include <Core/TexelFormat.hpp> // Core::TexelFormat
+#include <Graphics/API/Buffer.hpp> // Graphics::API::Buffer
+#include <Graphics/API/Texture.hpp> // Graphics::API::Texture
+#include <Graphics/Camera.hpp> // Graphics::Camera
+
+namespace Graphics {
+
+class Renderer;
+
+/*
+ * OpenGL presentation of a Core::SphereQuadTree
+ * Owns the height map, the gradient map and the buffers the quadtrees vertices are uploaded to
+*/
+class Planet {
+public:
+    // The package is used first, then the height tiles, then the image file,
+    // and the height map is generated with the parameters if they are all empty
+    struct HeightMapSource {
+        // Baked planet (Core::PlanetPackage), its size and max height replace the planet ones
+        std::string packageFileName;
+        // Height tiles (Core::HeightTileSet) streamed by the quadtrees level
+        std::string tilesFileName;
+        // Image loaded on the six faces
+        std::string fileName;
+        Core::HeightMapGenerator::Parameters parameters;
+
+        // Storage of the height map and gradient map textures
+        Core::TexelFormat::Formats formats;
+    };
+
+public:
+    ~Planet() = default;
+
+    Planet(const Planet& planet) = delete;
+    Planet(Planet&& planet) = delete;
+
+    Planet& operator=(const Planet& planet) = delete;
+    Planet& operator=(Planet&& planet) = delete;
+
+    static std::unique_ptr<Planet> create(
+        const Renderer* renderer,
+        float size,
+        float maxHeight,
+        const HeightMapSource& heightMapSource = HeightMapSource()
+    );
+
+    // Update the quadtrees and upload their vertices
+    void update(Camera& camera);
+    // Upload the quadtrees updated on an other thread (see Core::LodPipeline)
+    void upload(const Core::SphereQuadTree::Snapshot& snapshot);
+
+    float getSize() const;
+    float getMaxHeight() const;
+    // The vertex shader samples the height map mipmap log2(distance * scale), distance in planet size units
+    // It's the size in texels of the quads displayed at this distance
+    float getHeightMapLodScale() const;
+    Core::SphereQuadTree& getSphereQuadTree();
+    const Core::SphereQuadTree& getSphereQuadTree() const;
+    const API::Buffer& getBuffer() const;
+    const API::Buffer& getDebugBuffer() const;
+    const API::Texture& getHeightMap() const;
+    const API::Texture& getGradientMap() const;
+    // Only valid if the height map is streamed
+    bool hasVirtualHeightMap() const;
+    const API::Texture& getHeightTiles() const;
+    const API::Texture& getHeightIndirection() const;
+    // Statistics of the last uploaded height tiles
+    const Core::VirtualHeightMap::Statistics& getHeightTilesStatistics() const;
+    const HeightMapSource& getHeightMapSource() const;
+
+    void setMaxHeight(float maxHeight);
+    void setSize(float size);
+    // Load or generate the height map again, and its gradient map
+    bool setHeightMapSource(const HeightMapSource& heightMapSource);
+
+private:
+    // Only the Planet::create can create the planet
+    Planet() = default;
+
+    bool init(const Renderer* renderer, float size, float maxHeight, const HeightMapSource& heightMapSource);
+
+    bool initSphereQuadTree(float size, float maxHeight);
+    // heights are the faces generated on the CPU, empty if the height map is read from a package or an image
+    bool initHeightMap(Core::HeightMapGenerator::Faces& heights);
+    bool initGradientMap(const Core::HeightMapGenerator::Faces& heights);
+    bool initVirtualHeightMap();
+    bool initBuffer();
+    bool initDebugBuffer();
+
+    void uploadMesh(const Core::SphereQuadTree::Mesh<Core::QuadTree::Vertex>& mesh);
+    void uploadDebugMesh(const Core::SphereQuadTree::Mesh<glm::vec3>& mesh);
+    // Upload the loaded tiles and the changed indirection entries
+    void uploadHeightTiles(const Core::VirtualHeightMap::Uploads& uploads);
+
+private:
+    const Renderer* _renderer = nullptr;
+
+    std::unique_ptr<Core::SphereQuadTree> _sphereQuadTree = nullptr;
+    HeightMapSource _heightMapSource;
+
+    // Snapshot of the updates done by update, the memory is kept between updates
+    Core::SphereQuadTree::Snapshot _snapshot;
+
+    // Buffer storing vertices and indices
+    API::Buffer _buffer;
+    // Buffer storing aabb boxes
+    API::Buffer _debugBuffer;
+
+    API::Texture _heightMap;
+    API::Texture _gradientMap;
+
+    // Tile cache, one layer per slot of the Core::VirtualHeightMap
+    API::Texture _heightTiles;
+    // Slot and level of each tile of the finest level, one layer per face
+    API::Texture _heightIndirection;
+    Core::VirtualHeightMap::Statistics _heightTilesStatistics{};
+};
+
+} // Namespace Graphics
@@ -4,12 +4,13 @@
 
 #include <GL/glew.h> // GLuint
 
-#include <Core/SphereQuadTree.hpp> // Graphics::API::Buffer
+#include <Graphics/Planet.hpp> // Graphics::Planet
+#include <Graphics/API/Buffer.hpp> // Graphics::API::Buffer
+#include <Graphics/API/Framebuffer.hpp> // Graphics::API::Framebuffer
 #include <Graphics/API/ShaderProgram.hpp> // Graphics::API::ShaderProgram
 #include <Graphics/API/Texture.hpp> // Graphics::API::Texture
 #include <Graphics/Debug.hpp> // Graphics::Debug
 #include <Graphics/Camera.hpp> // Graphics::Camera
-#include <Window/Window.hpp> // Window::Window
 
 namespace Graphics {
 
@@ -23,33 +24,41 @@ public:
     Renderer& operator=(const Renderer& renderer) = delete;
     Renderer& operator=(Renderer&& renderer) = delete;
 
-    static std::unique_ptr<Renderer> create(const Window::Window* window);
+    static std::unique_ptr<Renderer> create();
 
-    void render(Camera& camera, const std::vector<std::unique_ptr<Core::SphereQuadTree>>& planets);
+    void render(Camera& camera, const std::vector<std::unique_ptr<Planet>>& planets);
 
     Debug& getDebug();
 
-    void createNormalMapFromHeightMap(const API::Texture& heightMap, const API::Texture& normalMap, float maxHeight) const;
+    // Gradients of the heights in [0, 1], the shaders get the normals with the max height
+    void createGradientMapFromHeightMap(const API::Texture& heightMap, const API::Texture& gradientMap) const;
 
 private:
     // Only the Renderer::create can create the renderer
-    Renderer(const Window::Window* window);
+    Renderer() = default;
     bool init();
 
-    void renderPlanets(API::ShaderProgram& shaderProgram, Camera& camera, const std::vector<std::unique_ptr<Core::SphereQuadTree>>& planets);
-    void renderPlanetsAABBDebug(Camera& camera, const std::vector<std::unique_ptr<Core::SphereQuadTree>>& planets);
+    void renderPlanets(API::ShaderProgram& shaderProgram, Camera& camera, const std::vector<std::unique_ptr<Planet>>& planets);
+    void renderPlanetsAABBDebug(Camera& camera, const std::vector<std::unique_ptr<Planet>>& planets);
 
 private:
     bool initShaderProgram();
+    bool initScreenTriangleBuffer();
+    bool initGradientMapFramebuffer();
 
 private:
-    const Window::Window* _window = nullptr;
 
     API::ShaderProgram _mainShaderProgram;
     API::ShaderProgram _debugShaderProgram;
     API::ShaderProgram _aabbDebugShaderProgram;
 
-    API::ShaderProgram _normalMapShaderProgram;
+    API::ShaderProgram _gradientMapShaderProgram;
+    // The color attachments are replaced by the faces of each generated gradient map
+    mutable API::Framebuffer _gradientMapFramebuffer;
+
+    // Empty vertex array used to draw the screen triangle (vertices are generated in the vertex shader)
+    // The core profile does not allow to draw without a vertex array bound
+    API::Buffer _screenTriangleBuffer;
 
     Debug _debug;
 };
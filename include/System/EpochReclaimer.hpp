@@ -0,0 +1,83 @@
+#pragma once
+
+#include <algorithm> // std::min
+#include <array> // std::array
+#include <atomic> // std::atomic
+#include <cstdint> // uint32_t, uint64_t
+#include <memory> // std::unique_ptr
+#include <thread> // std::this_thread
+#include <utility> // std::pair
+#include <vector> // std::vector
+
+namespace System {
+
+/*
+ * Epoch-based reclamation of the objects of a structure read by other threads without lock
+ *
+ * The writer unlinks an object, so the new readers can't reach it, and retires it with the current epoch
+ * Each reader pins the epoch while it reads the structure
+ * collect increments the epoch and deletes the objects retired before the oldest pinned epoch,
+ * the readers that could still reach them are all gone
+ * Only one thread can retire and collect, any thread can read
+*/
+template<typename T>
+class EpochReclaimer {
+public:
+    // Pins the epoch of a reader until it's destroyed
+    class ReadGuard {
+    public:
+        ~ReadGuard();
+
+        ReadGuard(const ReadGuard& guard) = delete;
+        ReadGuard(ReadGuard&& guard);
+
+        ReadGuard& operator=(const ReadGuard& guard) = delete;
+        ReadGuard& operator=(ReadGuard&& guard) = delete;
+
+    private:
+        friend class EpochReclaimer;
+
+        explicit ReadGuard(std::atomic<uint64_t>* slot);
+
+        std::atomic<uint64_t>* _slot;
+    };
+
+public:
+    EpochReclaimer() = default;
+    // The readers must be gone, the retired objects are deleted
+    ~EpochReclaimer() = default;
+
+    EpochReclaimer(const EpochReclaimer& reclaimer) = delete;
+    EpochReclaimer(EpochReclaimer&& reclaimer) = delete;
+
+    EpochReclaimer& operator=(const EpochReclaimer& reclaimer) = delete;
+    EpochReclaimer& operator=(EpochReclaimer&& reclaimer) = delete;
+
+    // Readers
+    // Waits if readersNb readers are already reading
+    ReadGuard read() const;
+
+    // Writer
+    // object must already be unreachable by the new readers
+    void retire(std::unique_ptr<T> object);
+    // Returns the number of deleted objects
+    uint32_t collect();
+    uint32_t getRetiredNb() const;
+
+private:
+    // Readers at the same time
+    static constexpr uint32_t readersNb = 64;
+    // Epoch of a slot without reader, the epochs start at 1
+    static constexpr uint64_t freeSlot = 0;
+
+    std::atomic<uint64_t> _epoch{1};
+    // Pinned epoch of each reader
+    mutable std::array<std::atomic<uint64_t>, readersNb> _slots{};
+
+    // Objects and the epoch they were retired at, oldest first
+    std::vector<std::pair<uint64_t, std::unique_ptr<T>>> _retired;
+};
+
+#include <System/EpochReclaimer.inl>
+
+} // Namespace System
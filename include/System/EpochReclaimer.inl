@@ -0,0 +1,78 @@
+template<typename T>
+constexpr uint32_t EpochReclaimer<T>::readersNb;
+
+template<typename T>
+constexpr uint64_t EpochReclaimer<T>::freeSlot;
+
+template<typename T>
+inline EpochReclaimer<T>::ReadGuard::ReadGuard(std::atomic<uint64_t>* slot): _slot(slot) {}
+
+template<typename T>
+inline EpochReclaimer<T>::ReadGuard::~ReadGuard() {
+    if (_slot != nullptr) {
+        // Release the reads of the objects before they can be deleted
+        _slot->store(freeSlot, std::memory_order_release);
+    }
+}
+
+template<typename T>
+inline EpochReclaimer<T>::ReadGuard::ReadGuard(ReadGuard&& guard): _slot(guard._slot) {
+    guard._slot = nullptr;
+}
+
+template<typename T>
+inline typename EpochReclaimer<T>::ReadGuard EpochReclaimer<T>::read() const {
+    for (uint32_t i = 0;; i = (i + 1) % readersNb) {
+        uint64_t epoch = _epoch.load();
+        uint64_t slotEpoch = freeSlot;
+
+        if (!_slots[i].compare_exchange_strong(slotEpoch, epoch)) {
+            if (i + 1 == readersNb) {
+                std::this_thread::yield();
+            }
+            continue;
+        }
+
+        // The epoch may have been incremented and collected before the slot was pinned:
+        // pin the current one, the objects can be read once it's stable
+        for (uint64_t currentEpoch = _epoch.load(); currentEpoch != epoch; currentEpoch = _epoch.load()) {
+            epoch = currentEpoch;
+            _slots[i].store(epoch);
+        }
+
+        return ReadGuard(&_slots[i]);
+    }
+}
+
+template<typename T>
+inline void EpochReclaimer<T>::retire(std::unique_ptr<T> object) {
+    _retired.emplace_back(_epoch.load(std::memory_order_relaxed), std::move(object));
+}
+
+template<typename T>
+inline uint32_t EpochReclaimer<T>::collect() {
+    // The readers pinning the new epoch can't reach the objects retired before
+    uint64_t oldestEpoch = _epoch.fetch_add(1) + 1;
+
+    for (const auto& slot: _slots) {
+        uint64_t slotEpoch = slot.load();
+        if (slotEpoch != freeSlot) {
+            oldestEpoch = std::min(oldestEpoch, slotEpoch);
+        }
+    }
+
+    auto end = _retired.begin();
+    while (end != _retired.end() && end->first < oldestEpoch) {
+        ++end;
+    }
+
+    uint32_t collectedNb = static_cast<uint32_t>(end - _retired.begin());
+    _retired.erase(_retired.begin(), end);
+
+    return collectedNb;
+}
+
+template<typename T>
+inline uint32_t EpochReclaimer<T>::getRetiredNb() const {
+    return static_cast<uint32_t>(_retired.size());
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic> // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstdint> // uint32_t
+#include <deque> // std::deque
+#include <functional> // std::function
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex
+#include <string> // std::string
+#include <thread> // std::thread
+#include <vector> // std::vector
+
+namespace System {
+
+/*
+ * Work-stealing job system
+ *
+ * Each worker has its own deque of jobs: it runs its last pushed jobs first, and steals the oldest jobs
+ * of the other deques when its deque is empty. The threads outside of the system push in a shared deque
+ * Jobs are grouped by a Counter: a job can run children with the counter of its parent,
+ * so waiting for the counter waits for the whole tree of jobs
+ * A thread waiting for a counter runs jobs until it reaches 0, so jobs can wait for other jobs
+ * and the thread calling parallelFor works too: a system of 1 thread has no worker
+*/
+class JobSystem {
+public:
+    struct Options {
+        // 0 uses one thread per core, including the calling thread
+        uint32_t threadsNb = 0;
+        // The workers are named "<name> <index>" in the profiler and the debuggers
+        std::string name = "Worker";
+        // Pin the worker i on the core i + 1, the calling thread keeps the core 0 (Linux only)
+        bool affinity = false;
+    };
+
+    // Number of unfinished jobs of a group, it must outlive them
+    class Counter {
+    public:
+        Counter() = default;
+        ~Counter() = default;
+
+        Counter(const Counter& counter) = delete;
+        Counter(Counter&& counter) = delete;
+
+        Counter& operator=(const Counter& counter) = delete;
+        Counter& operator=(Counter&& counter) = delete;
+
+        bool isDone() const;
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> _jobsNb{0};
+    };
+
+    using Job = std::function<void()>;
+
+public:
+    explicit JobSystem(uint32_t threadsNb = 0);
+    explicit JobSystem(const Options& options);
+    ~JobSystem();
+
+    JobSystem(const JobSystem& jobSystem) = delete;
+    JobSystem(JobSystem&& jobSystem) = delete;
+
+    JobSystem& operator=(const JobSystem& jobSystem) = delete;
+    JobSystem& operator=(JobSystem&& jobSystem) = delete;
+
+    // Number of threads running the jobs, including the calling thread
+    uint32_t getThreadsNb() const;
+
+    // Run job on any thread, counter is incremented until it finishes
+    void run(Job job, Counter& counter);
+    // Run jobs until the jobs of counter are finished
+    void wait(Counter& counter);
+
+    // Call job(index) for each index in [0, jobsNb) and wait for all the jobs to finish
+    // The indices are split in ranges of at least grainSize indices, the big ranges are stolen first
+    // It can be called by several threads at the same time, and by the jobs
+    void parallelFor(uint32_t jobsNb, const std::function<void(uint32_t)>& job, uint32_t grainSize = 1);
+
+private:
+    struct QueuedJob {
+        Job job;
+        Counter* counter;
+    };
+
+    // Deque of a worker, or of the threads outside of the system for the first one
+    struct Queue {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    void init(const Options& options);
+    void work(uint32_t workerId, const Options& options);
+
+    // Index in _queues of the calling thread
+    uint32_t getQueueIndex() const;
+    // Pop a job of the queue, or steal one of an other queue, false if they are all empty
+    bool popJob(uint32_t queueIndex, QueuedJob& job);
+    bool runJob(uint32_t queueIndex);
+
+    void runRange(uint32_t begin, uint32_t end, const std::function<void(uint32_t)>& job, uint32_t grainSize, Counter& counter);
+
+private:
+    std::vector<std::unique_ptr<Queue>> _queues;
+    std::vector<std::thread> _workers;
+
+    // Jobs in the queues, the workers sleep while it's 0
+    std::atomic<uint32_t> _queuedJobsNb{0};
+
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    // Protected by _sleepMutex
+    bool _stop = false;
+};
+
+} // Namespace System
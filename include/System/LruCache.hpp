@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <cstdint> // uint64_t
+#include <iterator> // std::next
+#include <list> // std::list
+#include <unordered_map> // std::unordered_map
+#include <utility> // std::pair, std::move
+
+namespace System {
+
+/*
+ * Values kept for their key and evicted least recently used first when the cache is full
+ *
+ * take moves the value out of the cache, so a value is owned either by the cache or by its user
+ * The evicted values are given to a function instead of being destroyed, so their owner can retire them
+*/
+template<typename Key, typename T>
+class LruCache {
+public:
+    struct Statistics {
+        uint64_t hitsNb;
+        uint64_t missesNb;
+        uint64_t evictionsNb;
+    };
+
+public:
+    explicit LruCache(size_t capacity);
+    ~LruCache() = default;
+
+    LruCache(const LruCache& cache) = delete;
+    LruCache(LruCache&& cache) = delete;
+
+    LruCache& operator=(const LruCache& cache) = delete;
+    LruCache& operator=(LruCache&& cache) = delete;
+
+    // The value of the same key and the least recently used values above the capacity are given to evict
+    template<typename Evict>
+    void insert(const Key& key, T value, Evict evict);
+    // Returns false if the key is not in the cache
+    bool take(const Key& key, T& value);
+    // Evict the value with the highest score instead of the least recently used one, false if the cache is empty
+    template<typename Score, typename Evict>
+    bool evictMax(Score score, Evict evict);
+
+    size_t getSize() const;
+    size_t getCapacity() const;
+    // 0 evicts all the values and disables the cache
+    template<typename Evict>
+    void setCapacity(size_t capacity, Evict evict);
+
+    Statistics getStatistics() const;
+
+private:
+    template<typename Evict>
+    void shrink(Evict evict);
+
+private:
+    size_t _capacity;
+
+    // Most recently used first
+    std::list<std::pair<Key, T>> _values;
+    std::unordered_map<Key, typename std::list<std::pair<Key, T>>::iterator> _index;
+
+    Statistics _statistics = {0, 0, 0};
+};
+
+#include <System/LruCache.inl>
+
+} // Namespace System
@@ -0,0 +1,93 @@
+template<typename Key, typename T>
+inline LruCache<Key, T>::LruCache(size_t capacity): _capacity(capacity) {}
+
+template<typename Key, typename T>
+template<typename Evict>
+inline void LruCache<Key, T>::insert(const Key& key, T value, Evict evict) {
+    auto entry = _index.find(key);
+    if (entry != _index.end()) {
+        evict(std::move(entry->second->second));
+        _values.erase(entry->second);
+        _index.erase(entry);
+        ++_statistics.evictionsNb;
+    }
+
+    _values.emplace_front(key, std::move(value));
+    _index[key] = _values.begin();
+
+    shrink(evict);
+}
+
+template<typename Key, typename T>
+inline bool LruCache<Key, T>::take(const Key& key, T& value) {
+    auto entry = _index.find(key);
+    if (entry == _index.end()) {
+        ++_statistics.missesNb;
+        return false;
+    }
+
+    value = std::move(entry->second->second);
+    _values.erase(entry->second);
+    _index.erase(entry);
+    ++_statistics.hitsNb;
+
+    return true;
+}
+
+template<typename Key, typename T>
+template<typename Score, typename Evict>
+inline bool LruCache<Key, T>::evictMax(Score score, Evict evict) {
+    if (_values.empty()) {
+        return false;
+    }
+
+    auto maxValue = _values.begin();
+    auto maxScore = score(maxValue->second);
+    for (auto it = std::next(_values.begin()); it != _values.end(); ++it) {
+        auto valueScore = score(it->second);
+        if (valueScore > maxScore) {
+            maxValue = it;
+            maxScore = valueScore;
+        }
+    }
+
+    evict(std::move(maxValue->second));
+    _index.erase(maxValue->first);
+    _values.erase(maxValue);
+    ++_statistics.evictionsNb;
+
+    return true;
+}
+
+template<typename Key, typename T>
+inline size_t LruCache<Key, T>::getSize() const {
+    return _index.size();
+}
+
+template<typename Key, typename T>
+inline size_t LruCache<Key, T>::getCapacity() const {
+    return _capacity;
+}
+
+template<typename Key, typename T>
+template<typename Evict>
+inline void LruCache<Key, T>::setCapacity(size_t capacity, Evict evict) {
+    _capacity = capacity;
+    shrink(evict);
+}
+
+template<typename Key, typename T>
+inline typename LruCache<Key, T>::Statistics LruCache<Key, T>::getStatistics() const {
+    return _statistics;
+}
+
+template<typename Key, typename T>
+template<typename Evict>
+inline void LruCache<Key, T>::shrink(Evict evict) {
+    while (_index.size() > _capacity) {
+        evict(std::move(_values.back().second));
+        _index.erase(_values.back().first);
+        _values.pop_back();
+        ++_statistics.evictionsNb;
+    }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef> // size_t
+#include <memory> // std::unique_ptr
+#include <string> // std::string
+
+namespace System {
+
+/*
+ * Read only memory mapping of a whole file
+ * The pages are loaded by the OS when they are read, and are shared with the file cache
+*/
+class MappedFile {
+public:
+    ~MappedFile();
+
+    MappedFile(const MappedFile& file) = delete;
+    MappedFile(MappedFile&& file) = delete;
+
+    MappedFile& operator=(const MappedFile& file) = delete;
+    MappedFile& operator=(MappedFile&& file) = delete;
+
+    static std::unique_ptr<MappedFile> create(const std::string& fileName);
+
+    // Aligned on a page
+    const void* getData() const;
+    size_t getSize() const;
+
+private:
+    // Only the MappedFile::create can create the mapping
+    MappedFile() = default;
+
+    bool init(const std::string& fileName);
+
+private:
+    const void* _data = nullptr;
+    size_t _size = 0;
+
+#if defined(_WIN32)
+    void* _file = nullptr;
+    void* _mapping = nullptr;
+#endif
+};
+
+} // Namespace System
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint> // uint32_t, uint64_t
+#include <memory> // std::unique_ptr
+#include <string> // std::string
+#include <vector> // std::vector
+
+/*
+ * Scoped CPU profiler
+ *
+ * PROFILE_SCOPE("name") measures the time until the end of the scope, the name must be a string literal
+ * PROFILE_FRAME() marks the beginning of a new frame
+ *
+ * The macros are only compiled with PLANET_PROFILER defined (cmake -DPLANET_PROFILER=ON),
+ * otherwise they are empty and have no cost
+*/
+#if defined(PLANET_PROFILER)
+    #define PROFILE_CONCAT_IMPL(a, b) a##b
+    #define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+    #define PROFILE_SCOPE(name) System::Profiler::ScopedZone PROFILE_CONCAT(profilerZone, __LINE__)(name)
+    #define PROFILE_FRAME() System::Profiler::newFrame()
+#else
+    #define PROFILE_SCOPE(name)
+    #define PROFILE_FRAME()
+#endif
+
+namespace System {
+
+/*
+ * Each thread writes its zones in its own ring buffer, without lock
+ * The oldest zones are overwritten when the ring buffer is full
+ *
+ * The zones can be read from any thread while they are written (getFrames, exportChromeTrace)
+*/
+class Profiler {
+public:
+    struct Zone {
+        const char* name;
+        // Nanoseconds since the profiler start
+        uint64_t start;
+        uint64_t end;
+        // Number of parent zones
+        uint32_t depth;
+        uint32_t threadId;
+    };
+
+    struct Thread {
+        uint32_t id;
+        std::string name;
+    };
+
+    class ScopedZone {
+    public:
+        explicit ScopedZone(const char* name);
+        ~ScopedZone();
+
+        ScopedZone(const ScopedZone& zone) = delete;
+        ScopedZone(ScopedZone&& zone) = delete;
+
+        ScopedZone& operator=(const ScopedZone& zone) = delete;
+        ScopedZone& operator=(ScopedZone&& zone) = delete;
+
+    private:
+        const char* _name;
+        uint64_t _start;
+    };
+
+    // Maximum number of zones kept per thread
+    static constexpr uint32_t zonesCapacity = 1 << 17;
+    // Maximum number of frames kept
+    static constexpr uint32_t framesCapacity = 256;
+
+public:
+    Profiler() = delete;
+
+    // Nanoseconds since the profiler start
+    static uint64_t getTime();
+
+    static void newFrame();
+    static void setThreadName(const std::string& name);
+
+    // Start time of the last framesNb finished frames, followed by the end time of the last one
+    // and the zones of these frames, sorted by thread and start time
+    static void getFrames(uint32_t framesNb, std::vector<uint64_t>& framesTimes, std::vector<Zone>& zones);
+    static std::vector<Thread> getThreads();
+
+    // Chrome trace event format, can be opened with chrome://tracing or https://ui.perfetto.dev
+    static bool exportChromeTrace(const std::string& fileName);
+
+private:
+    struct ThreadBuffer;
+
+    static ThreadBuffer& getThreadBuffer();
+    static std::vector<std::unique_ptr<ThreadBuffer>>& getThreadBuffers();
+    static void getZones(uint64_t start, uint64_t end, std::vector<Zone>& zones);
+};
+
+} // Namespace System
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <cstdint> // uint64_t
+#include <chrono> // std::chrono::steady_clock
 
 namespace System {
 
@@ -21,7 +21,7 @@ public:
 
 private:
     // Time since last reset
-    uint64_t _lastReset;
+    std::chrono::steady_clock::time_point _lastReset;
 };
 
 } // Namespace System
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array> // std::array
+#include <atomic> // std::atomic
+#include <cstdint> // uint8_t
+
+namespace System {
+
+/*
+ * Lock-free handoff of the last value written by a producer thread to a consumer thread
+ *
+ * The producer writes in its buffer and publishes it, the consumer switches to the last published buffer
+ * Neither thread waits for the other: a published buffer not read before the next publication is skipped,
+ * and it becomes the producer buffer again (publish tells it, so the producer can carry its content over)
+ * Only one producer thread and one consumer thread can use it
+*/
+template<typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+    ~TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer& buffer) = delete;
+    TripleBuffer(TripleBuffer&& buffer) = delete;
+
+    TripleBuffer& operator=(const TripleBuffer& buffer) = delete;
+    TripleBuffer& operator=(TripleBuffer&& buffer) = delete;
+
+    // Producer
+    T& getWriteBuffer();
+    // Returns false if the previous published buffer was not read, it's the new write buffer
+    bool publish();
+
+    // Consumer
+    // Switch to the last published buffer, returns false if nothing was published since the last call
+    bool update();
+    T& getReadBuffer();
+
+private:
+    // _state holds the index of the published buffer and this bit if it was not read yet
+    static constexpr uint8_t newBit = 4;
+    static constexpr uint8_t indexMask = 3;
+
+    std::array<T, 3> _buffers;
+
+    uint8_t _writeIndex = 0;
+    std::atomic<uint8_t> _state{1};
+    uint8_t _readIndex = 2;
+};
+
+#include <System/TripleBuffer.inl>
+
+} // Namespace System
@@ -0,0 +1,37 @@
+template<typename T>
+constexpr uint8_t TripleBuffer<T>::newBit;
+
+template<typename T>
+constexpr uint8_t TripleBuffer<T>::indexMask;
+
+template<typename T>
+inline T& TripleBuffer<T>::getWriteBuffer() {
+    return _buffers[_writeIndex];
+}
+
+template<typename T>
+inline bool TripleBuffer<T>::publish() {
+    // Release the writes of the buffer, acquire the reads of the buffer given back by the consumer
+    uint8_t previousState = _state.exchange(_writeIndex | newBit, std::memory_order_acq_rel);
+    _writeIndex = previousState & indexMask;
+
+    return (previousState & newBit) == 0;
+}
+
+template<typename T>
+inline bool TripleBuffer<T>::update() {
+    // Only the producer sets the bit, it can't be cleared by an other thread
+    if ((_state.load(std::memory_order_relaxed) & newBit) == 0) {
+        return false;
+    }
+
+    uint8_t previousState = _state.exchange(_readIndex, std::memory_order_acq_rel);
+    _readIndex = previousState & indexMask;
+
+    return true;
+}
+
+template<typename T>
+inline T& TripleBuffer<T>::getReadBuffer() {
+    return _buffers[_readIndex];
+}
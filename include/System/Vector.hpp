@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint> // uint32_t
 #include <vector> // std::vector
 
 namespace System {
@@ -7,6 +8,7 @@ namespace System {
 /*
  *
  * Abstraction of std::vector to resize the vector every chunkSize
+ * The memory is kept when the vector is cleared
  *
 */
 template<typename T>
@@ -16,12 +18,13 @@ public:
     ~Vector() = default;
 
     Vector(const Vector& vector) = delete;
-    Vector(Vector&& vector) = delete;
+    Vector(Vector&& vector) = default;
 
     Vector& operator=(const Vector& vector) = delete;
-    Vector& operator=(Vector&& vector) = delete;
+    Vector& operator=(Vector&& vector) = default;
 
     void push_back(T elem);
+    void clear();
     uint32_t size() const;
     const T* data() const;
 
@@ -37,4 +40,3 @@ private:
 #include <System/Vector.inl>
 
 } // Namespace System
-
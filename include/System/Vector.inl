@@ -1,14 +1,14 @@
 template<typename T>
 inline Vector<T>::Vector(uint32_t chunkSize, uint32_t baseSize): _chunkSize(chunkSize) {
     if (baseSize) {
-        _vector.reserve(baseSize);
+        _vector.resize(baseSize);
     }
     _vectorCapacity = baseSize;
 }
 
 template<typename T>
 inline void Vector<T>::push_back(T elem) {
-    if (!_elemsNb || _elemsNb == _vectorCapacity) {
+    if (_elemsNb == _vectorCapacity) {
         _vectorCapacity += _chunkSize;
         _vector.resize(_vectorCapacity);
     }
@@ -17,6 +17,11 @@ inline void Vector<T>::push_back(T elem) {
     ++_elemsNb;
 }
 
+template<typename T>
+inline void Vector<T>::clear() {
+    _elemsNb = 0;
+}
+
 template<typename T>
 inline uint32_t Vector<T>::size() const {
     return _elemsNb;
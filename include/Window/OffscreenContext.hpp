@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory> // std::unique_ptr
+
+#include <glm/vec2.hpp> // glm::ivec2
+
+namespace Window {
+
+/*
+ * OpenGL context without any window, used for headless rendering
+ * The context is created with EGL, on a surfaceless platform if available (Mesa)
+ * or a pbuffer surface otherwise, so it can run on servers without display or GPU (llvmpipe)
+ *
+ * Nothing is presented, the rendering must be done in a framebuffer
+*/
+class OffscreenContext {
+public:
+    ~OffscreenContext();
+
+    OffscreenContext(const OffscreenContext& context) = delete;
+    OffscreenContext(OffscreenContext&& context) = delete;
+
+    OffscreenContext& operator=(const OffscreenContext& context) = delete;
+    OffscreenContext& operator=(OffscreenContext&& context) = delete;
+
+    static std::unique_ptr<OffscreenContext> create(const glm::ivec2& size);
+
+    const glm::ivec2& getSize() const;
+
+private:
+    // Only the OffscreenContext::create can create the context
+    OffscreenContext() = default;
+
+    bool init(const glm::ivec2& size);
+    bool initDisplay();
+    bool initOpenGL();
+
+    void destroy();
+
+private:
+    // EGL handles, we don't want to include EGL headers in OffscreenContext.hpp
+    void* _display = nullptr;
+    void* _surface = nullptr;
+    void* _context = nullptr;
+
+    glm::ivec2 _size;
+};
+
+} // Namespace Window
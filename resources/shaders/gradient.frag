@@ -0,0 +1,81 @@
+#version 420 core
+
+layout(location = 0) in vec2 texCoord;
+
+// Sampled at the texels centers, so any height map format can be read
+uniform samplerCube heightMap;
+
+// Sobel gradients of the heights in [0, 1], the shaders scale them with the max height
+out vec2 outFragColor1;
+out vec2 outFragColor2;
+out vec2 outFragColor3;
+out vec2 outFragColor4;
+out vec2 outFragColor5;
+out vec2 outFragColor6;
+
+uniform float imageSize;
+
+// Same as Core::CubeMap::getDirection, s and t in [-1, 1]
+vec3 getDirection(int layer, vec2 st) {
+    switch (layer) {
+        case 0:
+            return vec3(1.0, -st.y, -st.x);
+        case 1:
+            return vec3(-1.0, -st.y, st.x);
+        case 2:
+            return vec3(st.x, 1.0, st.y);
+        case 3:
+            return vec3(st.x, -1.0, -st.y);
+        case 4:
+            return vec3(st.x, -st.y, 1.0);
+        default:
+            return vec3(-st.x, -st.y, -1.0);
+    }
+}
+
+float getHeight(int layer, vec2 heightMapCoord) {
+    // Texel coordinates to [-1, 1], the texels outside of the face are read on the neighbor face
+    vec2 st = heightMapCoord / imageSize * 2.0 - 1.0;
+
+    return textureLod(heightMap, getDirection(layer, st), 0.0).r;
+}
+
+vec2 calculateGradientSobel(int layer) {
+    // Center of the texel
+    vec2 faceTexCoord = texCoord;
+
+    // Calculate height of neighbors using cube positions
+    float topLeft = getHeight(layer, faceTexCoord + vec2(-1.0, -1.0));
+    float top = getHeight(layer, faceTexCoord + vec2(0.0, -1.0));
+    float topRight = getHeight(layer, faceTexCoord + vec2(1.0, -1.0));
+    float right = getHeight(layer, faceTexCoord + vec2(1.0, 0.0));
+    float bottomRight = getHeight(layer, faceTexCoord + vec2(1.0, 1.0));
+    float bottom = getHeight(layer, faceTexCoord + vec2(0.0, 1.0));
+    float bottomLeft = getHeight(layer, faceTexCoord + vec2(-1.0, 1.0));
+    float left = getHeight(layer, faceTexCoord + vec2(-1.0, 0.0));
+
+    // Apply sobel filter
+    vec2 gradient;
+    // Horizontal sobel
+    // 1  0  -1
+    // 2  0  -2
+    // 1  0  -1
+    gradient.x = topLeft - topRight + (2.0 * left) - (2.0 * right) + bottomLeft - bottomRight;
+
+    // Vertical sobel
+    // 1  2  1
+    // 0  0  0
+    //-1 -2 -1
+    gradient.y = topLeft + (2.0 * top) + topRight - bottomLeft - (2.0 * bottom) - bottomRight;
+
+    return gradient;
+}
+
+void main() {
+    outFragColor1 = calculateGradientSobel(0);
+    outFragColor2 = calculateGradientSobel(1);
+    outFragColor3 = calculateGradientSobel(2);
+    outFragColor4 = calculateGradientSobel(3);
+    outFragColor5 = calculateGradientSobel(4);
+    outFragColor6 = calculateGradientSobel(5);
+}
@@ -7,9 +7,10 @@ layout (location = 3) in vec3 inTangent;
 layout (location = 4) in vec3 inBitangent;
 
 uniform samplerCube heightMap;
-uniform samplerCube normalMap;
+uniform samplerCube gradientMap;
 uniform float planetSize;
 uniform float maxHeight;
+uniform float normalStrength = 5.0;
 
 out vec4 outFragColor;
 
@@ -21,10 +22,15 @@ float getHeight(vec3 heightMapCoord) {
     return heightMapValue.r * maxHeight;
 }
 
+// The gradients are computed on the heights in [0, 1], so the max height can change without updating the map
+vec3 getGradientNormal(vec3 gradientMapCoord) {
+    vec2 gradient = texture(gradientMap, gradientMapCoord).rg * maxHeight;
+
+    return normalize(vec3(gradient.x, 1.0 / normalStrength, gradient.y));
+}
+
 vec3 getNormal() {
-    // Convert normal from range [0, 1] to range [-1, 1]
-    vec3 worldNormal = 2.0f * texture(normalMap, cubeMapCoord).rgb - 1.0f;
-    worldNormal = normalize(worldNormal);
+    vec3 worldNormal = getGradientNormal(cubeMapCoord);
 
     // Construct tangent, bitangent, normal matrix
     mat3 TBN = mat3(inTangent, normalize(fragNormal), inBitangent);
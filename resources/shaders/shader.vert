@@ -1,5 +1,6 @@
 #version 420 core
 
+// Positions of a planet of size 1, see Core::QuadTree::Vertex
 layout (location = 0) in vec3 inCubePosition;
 layout (location = 1) in vec3 inSpherePosition;
 layout (location = 2) in vec3 inWidthDir;
@@ -14,11 +15,21 @@ layout (location = 4) out vec3 outBitangent;
 
 uniform mat4 view;
 uniform mat4 proj;
+uniform vec3 cameraPos;
 uniform float planetSize;
 uniform samplerCube heightMap;
-uniform samplerCube normalMap;
+uniform samplerCube gradientMap;
 
 uniform float maxHeight;
+// The mipmap sampled at a distance of 1 planet size, see Graphics::Planet::getHeightMapLodScale
+uniform float heightMapLodScale;
+
+// Streamed height map (Core::VirtualHeightMap), the cube height map is only used for the normals
+uniform bool virtualHeightMap;
+uniform sampler2DArray heightTiles;
+uniform usampler2DArray heightIndirection;
+uniform float heightTileSize;
+uniform float heightTileBorder;
 
 // Formulas: http://mathproofs.blogspot.kr/2005/07/mapping-cube-to-sphere.html
 vec3 mapCubeToSphere(vec3 pos)
@@ -34,18 +45,65 @@ vec3 mapCubeToSphere(vec3 pos)
     return normalize(pos);
 }
 
+// Same as Core::CubeMap::getFace, st in [-1, 1]
+int getCubeMapFace(vec3 direction, out vec2 st) {
+    vec3 absDirection = abs(direction);
+
+    if (absDirection.x >= absDirection.y && absDirection.x >= absDirection.z) {
+        st = vec2(direction.x > 0.0 ? -direction.z : direction.z, -direction.y) / absDirection.x;
+        return direction.x > 0.0 ? 0 : 1;
+    }
+    else if (absDirection.y >= absDirection.z) {
+        st = vec2(direction.x, direction.y > 0.0 ? direction.z : -direction.z) / absDirection.y;
+        return direction.y > 0.0 ? 2 : 3;
+    }
+
+    st = vec2(direction.z > 0.0 ? direction.x : -direction.x, -direction.y) / absDirection.z;
+    return direction.z > 0.0 ? 4 : 5;
+}
+
+float getVirtualHeight(vec3 heightMapCoord) {
+    vec2 st;
+    int face = getCubeMapFace(heightMapCoord, st);
+    vec2 uv = clamp(st * 0.5 + 0.5, 0.0, 1.0);
+
+    // Slot and level of the finest resident tile
+    ivec2 indirectionSize = textureSize(heightIndirection, 0).xy;
+    ivec2 indirectionCoord = min(ivec2(uv * vec2(indirectionSize)), indirectionSize - 1);
+    uvec2 entry = texelFetch(heightIndirection, ivec3(indirectionCoord, face), 0).rg;
+
+    // Coordinates in the tile, the border is skipped
+    float tilesNb = float(1u << entry.g);
+    vec2 tileCoord = uv * tilesNb;
+    vec2 tileUv = tileCoord - min(floor(tileCoord), tilesNb - 1.0);
+    vec2 slotCoord = (heightTileBorder + tileUv * heightTileSize) / (heightTileSize + 2.0 * heightTileBorder);
+
+    return texture(heightTiles, vec3(slotCoord, float(entry.r))).r;
+}
+
+// Mipmap matching the size of the quads displayed at the distance of the vertex
+// The distance is used instead of inQuadTreelevel, so the vertices shared by quadtrees of different levels get the same height
+float getHeightMapLod() {
+    return max(log2(distance(cameraPos / planetSize, inSpherePosition) * heightMapLodScale), 0.0);
+}
+
 float getHeight(vec3 heightMapCoord) {
-    vec4 heightMapValue = texture(heightMap, heightMapCoord);
+    if (virtualHeightMap) {
+        return getVirtualHeight(heightMapCoord) * maxHeight;
+    }
+
+    vec4 heightMapValue = textureLod(heightMap, heightMapCoord, getHeightMapLod());
 
     return heightMapValue.r * maxHeight;
 }
 
-vec3 getNormalizedCubeCoord(vec3 worldCubeCoord) {
-    return normalize((worldCubeCoord + (planetSize / 2.0)) / planetSize * 2.0 - 1.0);
+// The cube is centered on the planet
+vec3 getNormalizedCubeCoord(vec3 cubeCoord) {
+    return normalize(cubeCoord);
 }
 
 float getQuadSize() {
-    float squareSize = planetSize;
+    float squareSize = 1.0;
     for (int i = 0; i < inQuadTreelevel; ++i) {
         squareSize = squareSize / 2.0;
     }
@@ -72,8 +130,8 @@ void calculateTangent() {
     vec3 rightCubeMapCoord = getNormalizedCubeCoord(inCubePosition + (inWidthDir * quadSize));
     vec3 topCubeMapCoord = getNormalizedCubeCoord(inCubePosition + (inHeightDir * quadSize));
 
-    vec3 rightSpherePos = mapCubeToSphere(rightCubeMapCoord) * planetSize;
-    vec3 topSpherePos = mapCubeToSphere(topCubeMapCoord) * planetSize;
+    vec3 rightSpherePos = mapCubeToSphere(rightCubeMapCoord);
+    vec3 topSpherePos = mapCubeToSphere(topCubeMapCoord);
 
     // Triangle uvs
     vec2 uv0 = get2DTextCoord(outCubeMapCoord);
@@ -98,7 +156,7 @@ void calculateTangent() {
 
 void main()
 {
-    outPos = inSpherePosition;
+    outPos = inSpherePosition * planetSize;
 
     // Convert position to range [-1.0, 1.0]
     outCubeMapCoord = getNormalizedCubeCoord(inCubePosition);
@@ -1,15 +1,39 @@
-#include <iostream> // std::cerr
+#include <algorithm> // std::max, std::min
+#include <iostream> // std::cerr, std::cout
+#include <string> // std::string
 
 #include <imgui.h> // Imgui functions
 #include <glm/vec3.hpp> // glm::vec3
 
+#include <Core/CubeMap.hpp> // Core::CubeMap
+#include <Core/TexelFormat.hpp> // Core::TexelFormat
+#include <System/Profiler.hpp> // System::Profiler
 #include <System/Timer.hpp> // System::Timer
 
 #include <Core/Application.hpp> // Graphics::Core::Application
 
 namespace Core {
 
-bool Application::init() {
+bool Application::init(int argc, char** argv) {
+    std::string packageFileName;
+    std::string tilesFileName;
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (argument == "--package" && i + 1 < argc) {
+            packageFileName = argv[++i];
+        }
+        else if (argument == "--tiles" && i + 1 < argc) {
+            tilesFileName = argv[++i];
+        }
+        else {
+            // TODO: replace this with logger
+            std::cerr << "Application::init: Unknown argument \"" << argument << "\"" << std::endl;
+            std::cerr << "Usage: planet_generator [--package FILE] [--tiles FILE]" << std::endl;
+            return false;
+        }
+    }
+
     _window = Window::Window::create("Application window", {100, 100}, {1280, 720});
     if (_window == nullptr) {
         // TODO: replace this with logger
@@ -17,7 +41,7 @@ bool Application::init() {
         return false;
     }
 
-    _renderer = Graphics::Renderer::create(_window.get());
+    _renderer = Graphics::Renderer::create();
     if (_renderer == nullptr) {
         // TODO: replace this with logger
         std::cerr << "Application::init: failed to create renderer" << std::endl;
@@ -32,27 +56,41 @@ bool Application::init() {
     _camera.setFar(9999999.0f);
     _camera.setAspect((float)_window->getSize().x / (float)_window->getSize().y);
 
-    std::unique_ptr<Core::SphereQuadTree> planet = Core::SphereQuadTree::create(_renderer.get(), planetSize, planetMaxHeight);
+    _lodBudget = std::make_shared<Core::LodBudget>();
+
+    Graphics::Planet::HeightMapSource heightMapSource;
+    heightMapSource.packageFileName = packageFileName;
+    heightMapSource.tilesFileName = tilesFileName;
+    heightMapSource.parameters = _heightMapParameters;
+
+    std::unique_ptr<Graphics::Planet> planet = Graphics::Planet::create(_renderer.get(), planetSize, planetMaxHeight, heightMapSource);
     if (planet == nullptr) {
         std::cerr << "Application::init: failed to create planet" << std::endl;
         return false;
     }
 
-    _planets.push_back(std::move(planet));
+    // The editor starts from the parameters the package was baked with
+    const auto& package = planet->getSphereQuadTree().getPackage();
+    if (package != nullptr) {
+        _heightMapParameters = package->getDescription().heightMapParameters;
+    }
 
-    // TODO: Remove this line
-    // Why is the normal map not generating without the update ?
-    _planets.back()->update(_camera);
+    planet->getSphereQuadTree().getBudget().setParent(_lodBudget);
+    _planets.push_back(std::move(planet));
 
-    _renderer->createNormalMapFromHeightMap(_planets.back()->getHeightMap(), _planets.back()->getNormalMap(), _planets.back()->getMaxHeight());
+    lodPipelined(true);
 
     return true;
 }
 
 bool Application::run() {
     System::Timer timer;
+    // Time of the frame without the wait of the swap
+    System::Timer frameTimer;
 
     while (1) {
+        PROFILE_FRAME();
+
         float elapsedTime = timer.getElapsedTime();
         timer.reset();
 
@@ -60,9 +98,14 @@ bool Application::run() {
             break;
         }
 
+        frameTimer.reset();
+
         _window->beginFrame();
         onFrame(elapsedTime);
         _renderer->render(_camera, _planets);
+
+        updateLodGovernor(frameTimer.getElapsedTime());
+
         _window->endFrame();
     }
 
@@ -107,6 +150,10 @@ bool Application::handleEvents() {
             event.key.code == Window::Keyboard::Key::F5) {
             debug.aabbDisplayed(!debug.aabbDisplayed());
         }
+        if (event.type == Window::Event::Type::KeyPressed &&
+            event.key.code == Window::Keyboard::Key::F6) {
+            cameraPathRecording(!_cameraPathRecording);
+        }
 
         if (event.type == Window::Event::Type::Resize) {
             _camera.setAspect((float)_window->getSize().x / (float)_window->getSize().y);
@@ -117,14 +164,39 @@ bool Application::handleEvents() {
 }
 
 void Application::onFrame(float elapsedTime) {
-    for (auto& planet: _planets) {
-        planet->update(_camera);
+    PROFILE_SCOPE("Application::onFrame");
+
+    if (_lodPipeline != nullptr) {
+        // The quadtrees of this camera are displayed by a next frame
+        _lodPipeline->setCamera(_camera);
+
+        const Core::LodPipeline::Snapshot* snapshot = _lodPipeline->acquireSnapshot();
+        if (snapshot != nullptr) {
+            for (uint32_t i = 0; i < _planets.size() && i < snapshot->planets.size(); ++i) {
+                _planets[i]->upload(snapshot->planets[i]);
+            }
+        }
+    }
+    else {
+        for (auto& planet: _planets) {
+            planet->update(_camera);
+        }
+    }
+
+    if (_cameraPathRecording) {
+        _cameraPath.addKeyFrame({
+            _cameraPathTime,
+            _camera.getPos(),
+            _camera.getPos() + _camera.getForward()
+        });
+        _cameraPathTime += elapsedTime;
     }
 
     displayOverlayWindow(elapsedTime);
     displayCommandsWindow();
     displayDebugWindow();
     displayEditorWindow();
+    displayProfilerWindow();
 
     updateCameraPosition(elapsedTime);
 }
@@ -132,7 +204,7 @@ void Application::onFrame(float elapsedTime) {
 void Application::displayOverlayWindow(float elapsedTime) {
     // Display overlay window
     {
-        ImGui::SetNextWindowSize(ImVec2(400, 50));
+        ImGui::SetNextWindowSize(ImVec2(400, 112));
         ImGui::SetNextWindowPos(ImVec2(10, 10));
         if (!ImGui::Begin(
             "Fixed Overlay",
@@ -173,6 +245,49 @@ void Application::displayOverlayWindow(float elapsedTime) {
             _planets[i]->getBuffer().getVerticesNb(),
             sizeof(QuadTree::Vertex) * _planets[i]->getBuffer().getVerticesNb() / 1000
         );
+
+        // Reserved in the LOD budget by the LOD thread
+        Core::LodBudget::Usage usage = _planets[i]->getSphereQuadTree().getBudget().getUsage();
+        ImGui::Text(
+            "Planet %d memory: %u nodes, %llu Kb vertices, %llu Kb tiles",
+            i,
+            usage.nodesNb,
+            (unsigned long long)(usage.verticesSize / 1000),
+            (unsigned long long)(usage.texturesSize / 1000)
+        );
+    }
+
+    if (_lodPipeline != nullptr) {
+        const Core::LodPipeline::Metrics& metrics = _lodPipeline->getMetrics();
+        ImGui::Text(
+            "LOD latency: %.1f ms (avg %.1f, max %.1f), %llu frames, update %.1f ms",
+            metrics.latency,
+            metrics.averageLatency,
+            metrics.maxLatency,
+            (unsigned long long)metrics.framesLatency,
+            metrics.updateTime
+        );
+        ImGui::Text(
+            "LOD snapshots: %llu updated, %llu displayed, %llu dropped",
+            (unsigned long long)metrics.updatesNb,
+            (unsigned long long)metrics.displayedSnapshotsNb,
+            (unsigned long long)metrics.droppedSnapshotsNb
+        );
+    }
+
+    if (_lodGoverned) {
+        static const char* statesNames[] = {"stable", "increasing", "decreasing"};
+
+        ImGui::Text(
+            "LOD scale: %.2f, frame %.1f ms / %.1f ms (%s)",
+            _lodGovernor.getScale(),
+            _lodGovernor.getSmoothedFrameTime() * 1000.0f,
+            _lodGovernor.getSettings().targetFrameTime * 1000.0f,
+            statesNames[static_cast<uint8_t>(_lodGovernor.getState())]
+        );
+    }
+    else {
+        ImGui::Text("LOD scale: 1.00, governor disabled");
     }
 
     ImGui::End();
@@ -206,7 +321,7 @@ void Application::displayCommandsWindow() {
 
 void Application::displayDebugWindow() {
     ImGui::SetNextWindowPos(ImVec2(10, 230), ImGuiSetCond_FirstUseEver);
-    ImGui::SetNextWindowSize(ImVec2(200, 150), ImGuiSetCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(200, 170), ImGuiSetCond_FirstUseEver);
     if (!ImGui::Begin("Debug##Display", nullptr, ImVec2(0, 0)))
     {
         ImGui::End();
@@ -238,6 +353,64 @@ void Application::displayDebugWindow() {
         _renderer->getDebug().aabbDisplayed(aabbDisplayed);
     }
 
+    bool cameraPathRecording = _cameraPathRecording;
+    if (ImGui::Checkbox("Record camera path (F6)", &cameraPathRecording)) {
+        this->cameraPathRecording(cameraPathRecording);
+    }
+
+    bool lodPipelined = _lodPipeline != nullptr;
+    if (ImGui::Checkbox("Pipelined LOD", &lodPipelined)) {
+        this->lodPipelined(lodPipelined);
+    }
+
+    bool temporalCoherence = _planets.empty() || _planets.front()->getSphereQuadTree().temporalCoherence();
+    if (ImGui::Checkbox("LOD temporal coherence", &temporalCoherence)) {
+        std::unique_lock<std::mutex> lodLock = pauseLod();
+        for (auto& planet: _planets) {
+            planet->getSphereQuadTree().temporalCoherence(temporalCoherence);
+        }
+    }
+
+    bool lodPrefetch = _planets.empty() || _planets.front()->getSphereQuadTree().getPrefetchSettings().lookahead != 0;
+    if (ImGui::Checkbox("LOD prefetch", &lodPrefetch)) {
+        std::unique_lock<std::mutex> lodLock = pauseLod();
+        for (auto& planet: _planets) {
+            Core::SphereQuadTree::PrefetchSettings prefetchSettings = planet->getSphereQuadTree().getPrefetchSettings();
+            prefetchSettings.lookahead = lodPrefetch ? Core::SphereQuadTree::PrefetchSettings().lookahead : 0;
+            planet->getSphereQuadTree().setPrefetchSettings(prefetchSettings);
+        }
+    }
+
+    bool lodGoverned = _lodGoverned;
+    if (ImGui::Checkbox("LOD governor", &lodGoverned)) {
+        this->lodGoverned(lodGoverned);
+    }
+
+    Core::LodGovernor::Settings lodGovernorSettings = _lodGovernor.getSettings();
+    float targetFrameTime = lodGovernorSettings.targetFrameTime * 1000.0f;
+    if (ImGui::SliderFloat("Target (ms)", &targetFrameTime, 4.0f, 50.0f, "%.1f")) {
+        lodGovernorSettings.targetFrameTime = targetFrameTime / 1000.0f;
+        _lodGovernor.setSettings(lodGovernorSettings);
+    }
+
+    // Shared by the planets, the LOD thread applies the new limits at its next update
+    Core::LodBudget::Limits lodBudgetLimits = _lodBudget->getLimits();
+    int maxNodesNb = static_cast<int>(lodBudgetLimits.nodesNb);
+    int maxVerticesSize = static_cast<int>(lodBudgetLimits.verticesSize / 1000);
+    int maxTilesSize = static_cast<int>(lodBudgetLimits.texturesSize / 1000);
+
+    ImGui::Text("LOD budget (0 is unlimited):");
+    bool lodBudgetChanged = ImGui::InputInt("Nodes", &maxNodesNb, 1000, 10000);
+    lodBudgetChanged |= ImGui::InputInt("Vertices (Kb)", &maxVerticesSize, 1000, 10000);
+    lodBudgetChanged |= ImGui::InputInt("Tiles (Kb)", &maxTilesSize, 1000, 10000);
+
+    if (lodBudgetChanged) {
+        lodBudgetLimits.nodesNb = static_cast<uint32_t>(std::max(maxNodesNb, 0));
+        lodBudgetLimits.verticesSize = static_cast<uint64_t>(std::max(maxVerticesSize, 0)) * 1000;
+        lodBudgetLimits.texturesSize = static_cast<uint64_t>(std::max(maxTilesSize, 0)) * 1000;
+        _lodBudget->setLimits(lodBudgetLimits);
+    }
+
     ImGui::End();
 }
 
@@ -259,19 +432,185 @@ void Application::displayEditorWindow() {
     ImGui::PushItemWidth(200);
 
     float maxHeight = planet->getMaxHeight();
+    // The gradient map doesn't depend on the max height, the shaders scale it
     if (ImGui::SliderFloat("Max height", &maxHeight, 0.0f, 500.0f, "%.0f")) {
+        std::unique_lock<std::mutex> lodLock = pauseLod();
         planet->setMaxHeight(maxHeight);
-        _renderer->createNormalMapFromHeightMap(planet->getHeightMap(), planet->getNormalMap(), planet->getMaxHeight());
     }
 
     float size = planet->getSize();
     if (ImGui::SliderFloat("Size", &size, 0.0f, 500.0f, "%.0f")) {
+        std::unique_lock<std::mutex> lodLock = pauseLod();
         planet->setSize(size);
     }
 
+    ImGui::Separator();
+
+    int seed = static_cast<int>(_heightMapParameters.seed);
+    if (ImGui::InputInt("Seed", &seed)) {
+        _heightMapParameters.seed = static_cast<uint32_t>(seed);
+    }
+
+    bool ridged = _heightMapParameters.noiseType == Core::HeightMapGenerator::NoiseType::RIDGED;
+    if (ImGui::Checkbox("Ridged", &ridged)) {
+        _heightMapParameters.noiseType = ridged ? Core::HeightMapGenerator::NoiseType::RIDGED : Core::HeightMapGenerator::NoiseType::FBM;
+    }
+
+    int octaves = static_cast<int>(_heightMapParameters.octaves);
+    if (ImGui::SliderInt("Octaves", &octaves, 1, 16)) {
+        _heightMapParameters.octaves = static_cast<uint32_t>(octaves);
+    }
+
+    ImGui::SliderFloat("Frequency", &_heightMapParameters.frequency, 0.1f, 10.0f, "%.2f");
+    ImGui::SliderFloat("Domain warp", &_heightMapParameters.warpStrength, 0.0f, 1.0f, "%.2f");
+
+    if (ImGui::Button("Generate height map")) {
+        Graphics::Planet::HeightMapSource heightMapSource;
+        heightMapSource.parameters = _heightMapParameters;
+        heightMapSource.formats = planet->getHeightMapSource().formats;
+
+        // The LOD thread reads the height map while it's not paused
+        std::unique_lock<std::mutex> lodLock = pauseLod();
+        if (!planet->setHeightMapSource(heightMapSource)) {
+            // TODO: replace this with logger
+            std::cerr << "Application::displayEditorWindow: failed to generate height map" << std::endl;
+        }
+        if (_lodPipeline != nullptr) {
+            _lodPipeline->invalidate();
+        }
+    }
+
+    ImGui::Separator();
+
+    Core::TexelFormat::Formats formats = planet->getHeightMapSource().formats;
+
+    int heightMapFormat = static_cast<int>(formats.heightMap);
+    int gradientMapFormat = static_cast<int>(formats.gradientMap);
+    bool heightMapFormatChanged = ImGui::Combo("Height map format", &heightMapFormat, "R16\0R16F\0R32F\0");
+    bool gradientMapFormatChanged = ImGui::Combo("Gradient map format", &gradientMapFormat, "RG16F\0RG32F\0");
+
+    if (heightMapFormatChanged || gradientMapFormatChanged) {
+        Graphics::Planet::HeightMapSource heightMapSource = planet->getHeightMapSource();
+        heightMapSource.formats.heightMap = static_cast<Core::TexelFormat::Height>(heightMapFormat);
+        heightMapSource.formats.gradientMap = static_cast<Core::TexelFormat::Gradient>(gradientMapFormat);
+
+        std::unique_lock<std::mutex> lodLock = pauseLod();
+        if (!planet->setHeightMapSource(heightMapSource)) {
+            // TODO: replace this with logger
+            std::cerr << "Application::displayEditorWindow: failed to change the textures formats" << std::endl;
+        }
+        if (_lodPipeline != nullptr) {
+            _lodPipeline->invalidate();
+        }
+    }
+
+    // Both textures are cube maps of the same size, the mipmaps add a third of the level 0
+    size_t texelsNb = static_cast<size_t>(planet->getHeightMap().getWidth()) * planet->getHeightMap().getHeight() * Core::CubeMap::facesNb * 4 / 3;
+    size_t texturesSize = texelsNb * (Core::TexelFormat::getSize(formats.heightMap) + Core::TexelFormat::getSize(formats.gradientMap));
+    ImGui::Text("Textures: %.1f MB", texturesSize / (1024.0f * 1024.0f));
+
+    const Core::VirtualHeightMap* virtualHeightMap = planet->getSphereQuadTree().getVirtualHeightMap();
+    if (virtualHeightMap != nullptr) {
+        const Core::VirtualHeightMap::Statistics& statistics = planet->getHeightTilesStatistics();
+        ImGui::Text("Height tiles: %u / %u resident, %u pending", statistics.residentTilesNb, virtualHeightMap->getSlotsNb(), statistics.pendingTilesNb);
+        ImGui::Text("Tiles loaded: %llu, evicted: %llu", (unsigned long long)statistics.loadsNb, (unsigned long long)statistics.evictionsNb);
+        ImGui::Text("Tiles prefetched: %u, used: %llu", statistics.prefetchedTilesNb, (unsigned long long)statistics.prefetchHitsNb);
+    }
+
+    ImGui::PopItemWidth();
+
+    ImGui::End();
+}
+
+void Application::displayProfilerWindow() {
+    ImGui::SetNextWindowPos(ImVec2(420, 10), ImGuiSetCond_FirstUseEver);
+    ImGui::SetNextWindowSize(ImVec2(840, 250), ImGuiSetCond_FirstUseEver);
+    if (!ImGui::Begin("Profiler", nullptr, ImVec2(0, 0)))
+    {
+        ImGui::End();
+        return;
+    }
+
+#if !defined(PLANET_PROFILER)
+    ImGui::Text("The profiler is not compiled, build with -DPLANET_PROFILER=ON");
+    ImGui::End();
+#else
+    ImGui::PushItemWidth(200);
+    ImGui::SliderInt("Frames", &_profilerFramesNb, 1, 30);
     ImGui::PopItemWidth();
 
+    ImGui::SameLine();
+    if (ImGui::Button("Export Chrome trace")) {
+        if (System::Profiler::exportChromeTrace("profiler_trace.json")) {
+            std::cout << "Profiler trace saved in profiler_trace.json" << std::endl;
+        }
+    }
+
+    std::vector<uint64_t> framesTimes;
+    std::vector<System::Profiler::Zone> zones;
+    System::Profiler::getFrames(static_cast<uint32_t>(_profilerFramesNb), framesTimes, zones);
+
+    if (framesTimes.size() < 2) {
+        ImGui::End();
+        return;
+    }
+
+    // Flame graph of the last frames, one block of rows per thread
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    float width = ImGui::GetContentRegionAvail().x;
+    float rowHeight = ImGui::GetTextLineHeight() + 4.0f;
+
+    uint64_t startTime = framesTimes.front();
+    float scale = width / static_cast<float>(framesTimes.back() - startTime);
+
+    // Frames separators
+    for (uint64_t frameTime: framesTimes) {
+        float x = origin.x + (frameTime - startTime) * scale;
+        drawList->AddLine(ImVec2(x, origin.y), ImVec2(x, origin.y + ImGui::GetContentRegionAvail().y), ImColor(255, 255, 255, 60));
+    }
+
+    float threadY = origin.y;
+    uint32_t threadDepth = 0;
+    uint32_t threadId = zones.empty() ? 0 : zones.front().threadId;
+
+    for (const auto& zone: zones) {
+        if (zone.threadId != threadId) {
+            threadY += (threadDepth + 1) * rowHeight + 4.0f;
+            threadDepth = 0;
+            threadId = zone.threadId;
+        }
+        threadDepth = std::max(threadDepth, zone.depth);
+
+        float x0 = origin.x + (static_cast<float>(std::max(zone.start, startTime) - startTime)) * scale;
+        float x1 = origin.x + (static_cast<float>(std::min(zone.end, framesTimes.back()) - startTime)) * scale;
+        if (x1 - x0 < 1.0f) {
+            continue;
+        }
+
+        ImVec2 min(x0, threadY + zone.depth * rowHeight);
+        ImVec2 max(x1, min.y + rowHeight - 1.0f);
+
+        // Same color for the same zone name
+        uint32_t hash = 2166136261u;
+        for (const char* c = zone.name; *c; ++c) {
+            hash = (hash ^ static_cast<uint8_t>(*c)) * 16777619u;
+        }
+
+        drawList->AddRectFilled(min, max, ImColor::HSV((hash % 360) / 360.0f, 0.5f, 0.7f));
+        if (ImGui::CalcTextSize(zone.name).x < x1 - x0 - 4.0f) {
+            drawList->AddText(ImVec2(x0 + 2.0f, min.y + 2.0f), ImColor(255, 255, 255), zone.name);
+        }
+
+        if (ImGui::IsMouseHoveringRect(min, max)) {
+            ImGui::SetTooltip("%s: %.3f ms", zone.name, (zone.end - zone.start) / 1000000.0f);
+        }
+    }
+
+    ImGui::Dummy(ImVec2(width, threadY + (threadDepth + 1) * rowHeight - origin.y));
+
     ImGui::End();
+#endif
 }
 
 void Application::updateCameraPosition(float elapsedTime) {
@@ -320,5 +659,85 @@ void Application::updateCameraRotation(Window::Event& event) {
     );
 }
 
-} // Namespace Core
+void Application::cameraPathRecording(bool recording) {
+    if (recording == _cameraPathRecording) {
+        return;
+    }
+
+    _cameraPathRecording = recording;
+
+    if (recording) {
+        _cameraPath.clear();
+        _cameraPathTime = 0.0f;
+        return;
+    }
+
+    if (_cameraPath.saveToFile("camera_path.txt")) {
+        std::cout << "Camera path saved in camera_path.txt" << std::endl;
+    }
+}
+
+void Application::lodPipelined(bool pipelined) {
+    if (!pipelined) {
+        if (_lodPipeline != nullptr) {
+            // The height tiles of the last update must be uploaded before the planets update themselves
+            _lodPipeline->stop();
+
+            const Core::LodPipeline::Snapshot* snapshot = _lodPipeline->acquireSnapshot();
+            if (snapshot != nullptr) {
+                for (uint32_t i = 0; i < _planets.size() && i < snapshot->planets.size(); ++i) {
+                    _planets[i]->upload(snapshot->planets[i]);
+                }
+            }
+
+            _lodPipeline = nullptr;
+        }
+        return;
+    }
+
+    if (_lodPipeline != nullptr) {
+        return;
+    }
+
+    _lodPipeline = Core::LodPipeline::create([this](Graphics::Camera& camera, std::vector<Core::SphereQuadTree::Snapshot>& snapshots) {
+        snapshots.resize(_planets.size());
+        for (uint32_t i = 0; i < _planets.size(); ++i) {
+            _planets[i]->getSphereQuadTree().update(camera, snapshots[i]);
+        }
+    });
+}
+
+std::unique_lock<std::mutex> Application::pauseLod() {
+    if (_lodPipeline == nullptr) {
+        return std::unique_lock<std::mutex>();
+    }
+
+    return _lodPipeline->pause();
+}
+
+void Application::updateLodGovernor(float frameTime) {
+    if (!_lodGoverned) {
+        return;
+    }
+
+    // The LOD thread updates the quadtrees while the frame is rendered, the slowest one sets the frame time
+    if (_lodPipeline != nullptr) {
+        frameTime = std::max(frameTime, _lodPipeline->getMetrics().updateTime / 1000.0f);
+    }
 
+    float lodScale = _lodGovernor.update(frameTime);
+    for (auto& planet: _planets) {
+        planet->getSphereQuadTree().setLodScale(lodScale);
+    }
+}
+
+void Application::lodGoverned(bool governed) {
+    _lodGoverned = governed;
+    _lodGovernor.reset();
+
+    for (auto& planet: _planets) {
+        planet->getSphereQuadTree().setLodScale(_lodGovernor.getScale());
+    }
+}
+
+} // Namespace Core
@@ -0,0 +1,375 @@
+#include <cstdio> // std::sscanf
+#include <cstring> // std::strcmp, std::memcpy
+#include <fstream> // std::ifstream
+#include <iostream> // std::cerr, std::cout
+#include <sstream> // std::istringstream
+
+// Define STB_IMAGE_WRITE_IMPLEMENTATION before stb_image_write.h to create the implementation
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include <stb_image_write.h> // stbi_write_png
+
+#include <Graphics/API/Builder/Framebuffer.hpp> // Graphics::API::Builder::Framebuffer
+#include <Graphics/API/Builder/Texture.hpp> // Graphics::API::Builder::Texture
+
+#include <Core/BatchApplication.hpp> // Core::BatchApplication
+
+namespace Core {
+
+static bool parseVec3(const std::string& value, glm::vec3& vec) {
+    return std::sscanf(value.c_str(), "%f,%f,%f", &vec.x, &vec.y, &vec.z) == 3;
+}
+
+static bool endsWith(const std::string& str, const std::string& suffix) {
+    return str.size() >= suffix.size() &&
+        str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+bool BatchApplication::isRequested(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--jobs") == 0 ||
+            std::strcmp(argv[i], "--job") == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool BatchApplication::init(int argc, char** argv) {
+    if (!parseArguments(argc, argv)) {
+        return false;
+    }
+
+    if (_jobs.empty()) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::init: No job to render" << std::endl;
+        return false;
+    }
+
+    _context = Window::OffscreenContext::create(_size);
+    if (_context == nullptr) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::init: failed to create offscreen context" << std::endl;
+        return false;
+    }
+
+    _renderer = Graphics::Renderer::create();
+    if (_renderer == nullptr) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::init: failed to create renderer" << std::endl;
+        return false;
+    }
+
+    if (!initFramebuffer()) {
+        return false;
+    }
+
+    _camera.setNear(1.0f);
+    _camera.setFar(9999999.0f);
+    _camera.setAspect((float)_size.x / (float)_size.y);
+
+    const Job& firstJob = _jobs.front();
+    Graphics::Planet::HeightMapSource heightMapSource;
+    heightMapSource.parameters.seed = firstJob.seed;
+
+    std::unique_ptr<Graphics::Planet> planet = Graphics::Planet::create(_renderer.get(), firstJob.size, firstJob.maxHeight, heightMapSource);
+    if (planet == nullptr) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::init: failed to create planet" << std::endl;
+        return false;
+    }
+
+    _planets.push_back(std::move(planet));
+
+    _pixels.resize(_size.x * _size.y * 4);
+    _flippedPixels.resize(_pixels.size());
+
+    return true;
+}
+
+bool BatchApplication::run() {
+    uint32_t failedJobsNb = 0;
+
+    for (uint32_t i = 0; i < _jobs.size(); ++i) {
+        const Job& job = _jobs[i];
+
+        if (!renderJob(job) || !writeImage(job)) {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::run: job " << i << " failed" << std::endl;
+            ++failedJobsNb;
+            continue;
+        }
+
+        std::cout << "[" << (i + 1) << "/" << _jobs.size() << "] " << job.output << std::endl;
+    }
+
+    return failedJobsNb == 0;
+}
+
+bool BatchApplication::parseArguments(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::parseArguments: Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        std::string value = argv[++i];
+
+        if (argument == "--size") {
+            if (std::sscanf(value.c_str(), "%dx%d", &_size.x, &_size.y) != 2 ||
+                _size.x <= 0 || _size.y <= 0) {
+                // TODO: replace this with logger
+                std::cerr << "BatchApplication::parseArguments: Invalid size \"" << value << "\", expected WIDTHxHEIGHT" << std::endl;
+                return false;
+            }
+        }
+        else if (argument == "--jobs") {
+            if (!parseJobsFile(value)) {
+                return false;
+            }
+        }
+        else if (argument == "--job") {
+            Job job;
+            if (!parseJob(value, job)) {
+                return false;
+            }
+            _jobs.push_back(job);
+        }
+        else {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::parseArguments: Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool BatchApplication::parseJobsFile(const std::string& fileName) {
+    std::ifstream file(fileName);
+    if (!file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::parseJobsFile: Can't open jobs file \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    std::string line;
+    uint32_t lineNb = 0;
+    while (std::getline(file, line)) {
+        ++lineNb;
+
+        // Skip empty lines and comments
+        size_t firstChar = line.find_first_not_of(" \t\r");
+        if (firstChar == std::string::npos || line[firstChar] == '#') {
+            continue;
+        }
+
+        Job job;
+        if (!parseJob(line, job)) {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::parseJobsFile: Invalid job at line " << lineNb << " of \"" << fileName << "\"" << std::endl;
+            return false;
+        }
+        _jobs.push_back(job);
+    }
+
+    return true;
+}
+
+bool BatchApplication::parseJob(const std::string& jobDescription, Job& job) const {
+    std::istringstream stream(jobDescription);
+    std::string token;
+
+    while (stream >> token) {
+        size_t separator = token.find('=');
+        if (separator == std::string::npos) {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::parseJob: Expected key=value, got \"" << token << "\"" << std::endl;
+            return false;
+        }
+
+        std::string key = token.substr(0, separator);
+        std::string value = token.substr(separator + 1);
+        bool valid = true;
+
+        if (key == "size") {
+            valid = std::sscanf(value.c_str(), "%f", &job.size) == 1 && job.size > 0.0f;
+        }
+        else if (key == "maxHeight") {
+            valid = std::sscanf(value.c_str(), "%f", &job.maxHeight) == 1;
+        }
+        else if (key == "seed") {
+            valid = std::sscanf(value.c_str(), "%u", &job.seed) == 1;
+        }
+        else if (key == "pos") {
+            valid = parseVec3(value, job.pos);
+        }
+        else if (key == "lookAt") {
+            valid = parseVec3(value, job.lookAt);
+        }
+        else if (key == "fov") {
+            valid = std::sscanf(value.c_str(), "%f", &job.fov) == 1;
+        }
+        else if (key == "out") {
+            job.output = value;
+        }
+        else {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::parseJob: Unknown key \"" << key << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::parseJob: Invalid value \"" << value << "\" for key \"" << key << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    if (job.output.empty()) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::parseJob: Missing output file (out=FILE)" << std::endl;
+        return false;
+    }
+
+    if (endsWith(job.output, ".png")) {
+        job.format = Job::Format::PNG;
+    }
+    else if (endsWith(job.output, ".raw")) {
+        job.format = Job::Format::RAW;
+    }
+    else {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::parseJob: Unsupported output format for \"" << job.output << "\" (.png or .raw)" << std::endl;
+        return false;
+    }
+
+    if (job.pos == job.lookAt) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::parseJob: Camera position and look at position can't be the same" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool BatchApplication::initFramebuffer() {
+    {
+        Graphics::API::Builder::Texture textureBuilder;
+
+        textureBuilder.setType(GL_TEXTURE_2D);
+        textureBuilder.setFormat(GL_RGBA);
+        textureBuilder.setInternalFormat(GL_RGBA8);
+        textureBuilder.setDataType(GL_UNSIGNED_BYTE);
+        textureBuilder.setWidth(_size.x);
+        textureBuilder.setHeight(_size.y);
+        textureBuilder.addImage(GL_TEXTURE_2D);
+        textureBuilder.setParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        textureBuilder.setParameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+        if (!textureBuilder.build(_colorTexture)) {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::initFramebuffer: failed to create color texture" << std::endl;
+            return false;
+        }
+    }
+
+    Graphics::API::Builder::Framebuffer framebufferBuilder;
+    framebufferBuilder.addColorAttachment(&_colorTexture);
+    framebufferBuilder.setDepthAttachment(GL_DEPTH_COMPONENT24, _size.x, _size.y);
+
+    if (!framebufferBuilder.build(_framebuffer)) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::initFramebuffer: failed to create framebuffer" << std::endl;
+        return false;
+    }
+
+    _framebuffer.bind();
+    bool complete = _framebuffer.isComplete();
+    _framebuffer.unBind();
+
+    if (!complete) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::initFramebuffer: framebuffer is not complete" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool BatchApplication::renderJob(const Job& job) {
+    auto& planet = _planets.front();
+
+    // Only update what changed since the previous job
+    if (planet->getSize() != job.size) {
+        planet->setSize(job.size);
+    }
+    if (planet->getMaxHeight() != job.maxHeight) {
+        planet->setMaxHeight(job.maxHeight);
+    }
+    if (planet->getHeightMapSource().parameters.seed != job.seed) {
+        Graphics::Planet::HeightMapSource heightMapSource = planet->getHeightMapSource();
+        heightMapSource.parameters.seed = job.seed;
+
+        if (!planet->setHeightMapSource(heightMapSource)) {
+            return false;
+        }
+    }
+
+    _camera.setFov(job.fov);
+    _camera.setPos(job.pos);
+    _camera.lookAt(job.lookAt);
+
+    // The quadtrees are fully split in one update
+    planet->update(_camera);
+
+    _framebuffer.use();
+    glViewport(0, 0, _size.x, _size.y);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    _renderer->render(_camera, _planets);
+
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, _size.x, _size.y, GL_RGBA, GL_UNSIGNED_BYTE, _pixels.data());
+
+    _framebuffer.unBind();
+
+    return glGetError() == GL_NO_ERROR;
+}
+
+bool BatchApplication::writeImage(const Job& job) {
+    // OpenGL rows start from the bottom of the image
+    size_t rowSize = _size.x * 4;
+    for (int y = 0; y < _size.y; ++y) {
+        std::memcpy(
+            _flippedPixels.data() + (y * rowSize),
+            _pixels.data() + ((_size.y - y - 1) * rowSize),
+            rowSize
+        );
+    }
+
+    if (job.format == Job::Format::PNG) {
+        if (!stbi_write_png(job.output.c_str(), _size.x, _size.y, 4, _flippedPixels.data(), static_cast<int>(rowSize))) {
+            // TODO: replace this with logger
+            std::cerr << "BatchApplication::writeImage: Can't write png \"" << job.output << "\"" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::ofstream file(job.output, std::ios::binary);
+    if (!file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "BatchApplication::writeImage: Can't open \"" << job.output << "\"" << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(_flippedPixels.data()), _flippedPixels.size());
+
+    return file.good();
+}
+
+} // Namespace Core
@@ -0,0 +1,130 @@
+#include <algorithm> // std::upper_bound
+#include <cstdio> // std::sscanf
+#include <fstream> // std::ifstream, std::ofstream
+#include <iostream> // std::cerr
+
+#include <glm/common.hpp> // glm::mix
+
+#include <Core/CameraPath.hpp> // Core::CameraPath
+
+namespace Core {
+
+bool CameraPath::loadFromFile(const std::string& fileName) {
+    std::ifstream file(fileName);
+    if (!file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "CameraPath::loadFromFile: Can't open camera path file \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    _keyFrames.clear();
+
+    std::string line;
+    uint32_t lineNb = 0;
+    while (std::getline(file, line)) {
+        ++lineNb;
+
+        // Skip empty lines and comments
+        size_t firstChar = line.find_first_not_of(" \t\r");
+        if (firstChar == std::string::npos || line[firstChar] == '#') {
+            continue;
+        }
+
+        KeyFrame keyFrame;
+        if (std::sscanf(
+            line.c_str(),
+            "%f %f,%f,%f %f,%f,%f",
+            &keyFrame.time,
+            &keyFrame.pos.x, &keyFrame.pos.y, &keyFrame.pos.z,
+            &keyFrame.lookAt.x, &keyFrame.lookAt.y, &keyFrame.lookAt.z
+        ) != 7 ||
+            keyFrame.pos == keyFrame.lookAt ||
+            (!_keyFrames.empty() && keyFrame.time < _keyFrames.back().time)) {
+            // TODO: replace this with logger
+            std::cerr << "CameraPath::loadFromFile: Invalid key frame at line " << lineNb << " of \"" << fileName << "\"" << std::endl;
+            return false;
+        }
+
+        _keyFrames.push_back(keyFrame);
+    }
+
+    return true;
+}
+
+bool CameraPath::saveToFile(const std::string& fileName) const {
+    std::ofstream file(fileName);
+    if (!file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "CameraPath::saveToFile: Can't open \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    file << "# time x,y,z lookAtX,lookAtY,lookAtZ" << std::endl;
+    for (const auto& keyFrame: _keyFrames) {
+        file << keyFrame.time << " "
+            << keyFrame.pos.x << "," << keyFrame.pos.y << "," << keyFrame.pos.z << " "
+            << keyFrame.lookAt.x << "," << keyFrame.lookAt.y << "," << keyFrame.lookAt.z << std::endl;
+    }
+
+    return file.good();
+}
+
+void CameraPath::addKeyFrame(const KeyFrame& keyFrame) {
+    _keyFrames.push_back(keyFrame);
+}
+
+void CameraPath::clear() {
+    _keyFrames.clear();
+}
+
+bool CameraPath::isEmpty() const {
+    return _keyFrames.empty();
+}
+
+float CameraPath::getDuration() const {
+    return _keyFrames.empty() ? 0.0f : _keyFrames.back().time;
+}
+
+const std::vector<CameraPath::KeyFrame>& CameraPath::getKeyFrames() const {
+    return _keyFrames;
+}
+
+void CameraPath::apply(float time, Graphics::Camera& camera) const {
+    if (_keyFrames.empty()) {
+        return;
+    }
+
+    // First key frame after time
+    auto next = std::upper_bound(
+        _keyFrames.begin(),
+        _keyFrames.end(),
+        time,
+        [](float time, const KeyFrame& keyFrame) {
+            return time < keyFrame.time;
+        }
+    );
+
+    glm::vec3 pos;
+    glm::vec3 lookAt;
+
+    if (next == _keyFrames.begin()) {
+        pos = next->pos;
+        lookAt = next->lookAt;
+    }
+    else if (next == _keyFrames.end()) {
+        pos = _keyFrames.back().pos;
+        lookAt = _keyFrames.back().lookAt;
+    }
+    else {
+        auto previous = next - 1;
+        float ratio = (time - previous->time) / (next->time - previous->time);
+
+        pos = glm::mix(previous->pos, next->pos, ratio);
+        lookAt = glm::mix(previous->lookAt, next->lookAt, ratio);
+    }
+
+    camera.setPos(pos);
+    camera.lookAt(lookAt);
+}
+
+} // Namespace Core
@@ -0,0 +1,57 @@
+#include <cmath> // std::abs
+
+#include <Core/CubeMap.hpp> // Core::CubeMap
+
+namespace Core {
+
+constexpr uint32_t CubeMap::facesNb;
+
+glm::vec3 CubeMap::getDirection(Face face, float s, float t) {
+    // OpenGL specification, table "Selection of cube map images"
+    switch (face) {
+        case Face::POSITIVE_X:
+            return {1.0f, -t, -s};
+        case Face::NEGATIVE_X:
+            return {-1.0f, -t, s};
+        case Face::POSITIVE_Y:
+            return {s, 1.0f, t};
+        case Face::NEGATIVE_Y:
+            return {s, -1.0f, -t};
+        case Face::POSITIVE_Z:
+            return {s, -t, 1.0f};
+        case Face::NEGATIVE_Z:
+        default:
+            return {-s, -t, -1.0f};
+    }
+}
+
+glm::vec3 CubeMap::getDirection(Face face, uint32_t x, uint32_t y, uint32_t size) {
+    float s = 2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(size) - 1.0f;
+    float t = 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(size) - 1.0f;
+
+    return getDirection(face, s, t);
+}
+
+CubeMap::Face CubeMap::getFace(const glm::vec3& direction, float& s, float& t) {
+    float absX = std::abs(direction.x);
+    float absY = std::abs(direction.y);
+    float absZ = std::abs(direction.z);
+
+    // The major axis selects the face
+    if (absX >= absY && absX >= absZ) {
+        t = -direction.y / absX;
+        s = direction.x > 0.0f ? -direction.z / absX : direction.z / absX;
+        return direction.x > 0.0f ? Face::POSITIVE_X : Face::NEGATIVE_X;
+    }
+    else if (absY >= absZ) {
+        s = direction.x / absY;
+        t = direction.y > 0.0f ? direction.z / absY : -direction.z / absY;
+        return direction.y > 0.0f ? Face::POSITIVE_Y : Face::NEGATIVE_Y;
+    }
+
+    t = -direction.y / absZ;
+    s = direction.z > 0.0f ? direction.x / absZ : -direction.x / absZ;
+    return direction.z > 0.0f ? Face::POSITIVE_Z : Face::NEGATIVE_Z;
+}
+
+} // Namespace Core
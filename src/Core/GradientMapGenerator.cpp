@@ -0,0 +1,325 @@
+#include <algorithm> // std::min, std::max
+#include <cstring> // std::memcpy
+#include <utility> // std::swap
+
+#include <System/Profiler.hpp> // PROFILE_SCOPE
+
+#include <Core/GradientMapGenerator.hpp> // Core::GradientMapGenerator
+
+/*
+ * The kernels of GradientMapGeneratorAVX2.cpp do the same operations in the same order,
+ * any change here must be done there too
+*/
+
+namespace Core {
+
+constexpr uint32_t GradientMapGenerator::tileRowsNb;
+
+// Sum of the weights of a side of the Sobel filter, divided by the distance of the central differences
+static const float centralDifferencesScale = 4.0f;
+
+// Rows of a face generated by a job
+struct GradientJob {
+    CubeMap::Face face;
+    uint32_t firstRow;
+    uint32_t lastRow;
+};
+
+static bool isEmpty(const GradientMapGenerator::Rect& rect) {
+    return rect.xMin >= rect.xMax || rect.yMin >= rect.yMax;
+}
+
+static void addToRect(GradientMapGenerator::Rect& rect, uint32_t xMin, uint32_t yMin, uint32_t xMax, uint32_t yMax) {
+    if (isEmpty(rect)) {
+        rect = {xMin, yMin, xMax, yMax};
+        return;
+    }
+
+    rect.xMin = std::min(rect.xMin, xMin);
+    rect.yMin = std::min(rect.yMin, yMin);
+    rect.xMax = std::max(rect.xMax, xMax);
+    rect.yMax = std::max(rect.yMax, yMax);
+}
+
+GradientMapGenerator::GradientMapGenerator(uint32_t size, Filter filter):
+    _size(size), _filter(filter), _avx2Enabled(isAVX2Supported()) {
+    initBorders();
+}
+
+bool GradientMapGenerator::isAVX2Supported() {
+    // Same instructions as the height map kernels
+    return HeightMapGenerator::isAVX2Supported();
+}
+
+uint32_t GradientMapGenerator::getSize() const {
+    return _size;
+}
+
+GradientMapGenerator::Filter GradientMapGenerator::getFilter() const {
+    return _filter;
+}
+
+void GradientMapGenerator::setAVX2Enabled(bool enabled) {
+    _avx2Enabled = enabled && isAVX2Supported();
+}
+
+bool GradientMapGenerator::isAVX2Enabled() const {
+    return _avx2Enabled;
+}
+
+void GradientMapGenerator::generate(const HeightMapGenerator::Faces& heights, Faces& gradients, System::JobSystem& jobSystem) const {
+    PROFILE_SCOPE("GradientMapGenerator::generate");
+
+    Rects rects;
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        gradients[face].resize(static_cast<size_t>(_size) * _size);
+        rects[face] = {0, 0, _size, _size};
+    }
+
+    generateRects(heights, rects, gradients, jobSystem);
+}
+
+GradientMapGenerator::Rects GradientMapGenerator::update(
+    const HeightMapGenerator::Faces& heights,
+    CubeMap::Face face,
+    const Rect& rect,
+    Faces& gradients,
+    System::JobSystem& jobSystem
+) const {
+    PROFILE_SCOPE("GradientMapGenerator::update");
+
+    Rects rects;
+    rects.fill({0, 0, 0, 0});
+
+    Rect edited = {std::min(rect.xMin, _size), std::min(rect.yMin, _size), std::min(rect.xMax, _size), std::min(rect.yMax, _size)};
+    if (isEmpty(edited)) {
+        return rects;
+    }
+
+    // The texels around the edited heights on the face
+    uint32_t faceIndex = static_cast<uint32_t>(face);
+    addToRect(
+        rects[faceIndex],
+        edited.xMin > 0 ? edited.xMin - 1 : 0,
+        edited.yMin > 0 ? edited.yMin - 1 : 0,
+        std::min(edited.xMax + 1, _size),
+        std::min(edited.yMax + 1, _size)
+    );
+
+    // The texels of the other faces reading an edited height around their face
+    int64_t size = _size;
+    for (uint32_t otherFace = 0; otherFace < CubeMap::facesNb; ++otherFace) {
+        if (otherFace == faceIndex) {
+            continue;
+        }
+
+        for (int64_t y = -1; y <= size; ++y) {
+            for (int64_t x = -1; x <= size; ++x) {
+                // Only the texels around the face
+                if (y >= 0 && y < size && x == 0) {
+                    x = size;
+                }
+
+                const Texel& texel = _borders[otherFace][getBorderIndex(x, y)];
+                uint32_t texelX = texel.index % _size;
+                uint32_t texelY = texel.index / _size;
+
+                if (texel.face != faceIndex ||
+                    texelX < edited.xMin || texelX >= edited.xMax ||
+                    texelY < edited.yMin || texelY >= edited.yMax) {
+                    continue;
+                }
+
+                addToRect(
+                    rects[otherFace],
+                    static_cast<uint32_t>(std::max<int64_t>(x - 1, 0)),
+                    static_cast<uint32_t>(std::max<int64_t>(y - 1, 0)),
+                    static_cast<uint32_t>(std::min<int64_t>(x + 2, size)),
+                    static_cast<uint32_t>(std::min<int64_t>(y + 2, size))
+                );
+            }
+        }
+    }
+
+    generateRects(heights, rects, gradients, jobSystem);
+
+    return rects;
+}
+
+void GradientMapGenerator::generateScalar(
+    Filter filter,
+    const float* top,
+    const float* middle,
+    const float* bottom,
+    glm::vec2* gradients,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; ++i) {
+        if (filter == Filter::SOBEL) {
+            float topLeft = top[i];
+            float topCenter = top[i + 1];
+            float topRight = top[i + 2];
+            float left = middle[i];
+            float right = middle[i + 2];
+            float bottomLeft = bottom[i];
+            float bottomCenter = bottom[i + 1];
+            float bottomRight = bottom[i + 2];
+
+            // Horizontal sobel
+            // 1  0  -1
+            // 2  0  -2
+            // 1  0  -1
+            gradients[i].x = topLeft - topRight + (2.0f * left) - (2.0f * right) + bottomLeft - bottomRight;
+
+            // Vertical sobel
+            // 1  2  1
+            // 0  0  0
+            //-1 -2 -1
+            gradients[i].y = topLeft + (2.0f * topCenter) + topRight - bottomLeft - (2.0f * bottomCenter) - bottomRight;
+        }
+        else {
+            gradients[i].x = (middle[i] - middle[i + 2]) * centralDifferencesScale;
+            gradients[i].y = (top[i + 1] - bottom[i + 1]) * centralDifferencesScale;
+        }
+    }
+}
+
+void GradientMapGenerator::initBorders() {
+    int64_t size = _size;
+
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        _borders[face].resize(4 * _size + 4);
+
+        for (int64_t y = -1; y <= size; ++y) {
+            for (int64_t x = -1; x <= size; ++x) {
+                if (y >= 0 && y < size && x == 0) {
+                    x = size;
+                }
+
+                // Texel of the neighbor face under the center of the texel outside of the face,
+                // the same texel as the one sampled by gradient.frag
+                float s = 2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(_size) - 1.0f;
+                float t = 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(_size) - 1.0f;
+                glm::vec3 direction = CubeMap::getDirection(static_cast<CubeMap::Face>(face), s, t);
+
+                float neighborS = 0.0f;
+                float neighborT = 0.0f;
+                CubeMap::Face neighborFace = CubeMap::getFace(direction, neighborS, neighborT);
+
+                int64_t neighborX = static_cast<int64_t>((neighborS + 1.0f) * 0.5f * static_cast<float>(_size));
+                int64_t neighborY = static_cast<int64_t>((neighborT + 1.0f) * 0.5f * static_cast<float>(_size));
+                neighborX = std::min<int64_t>(std::max<int64_t>(neighborX, 0), size - 1);
+                neighborY = std::min<int64_t>(std::max<int64_t>(neighborY, 0), size - 1);
+
+                _borders[face][getBorderIndex(x, y)] = {
+                    static_cast<uint32_t>(neighborFace),
+                    static_cast<uint32_t>(neighborY * size + neighborX)
+                };
+            }
+        }
+    }
+}
+
+uint32_t GradientMapGenerator::getBorderIndex(int64_t x, int64_t y) const {
+    int64_t size = _size;
+
+    if (y < 0) {
+        return static_cast<uint32_t>(x + 1);
+    }
+    if (y >= size) {
+        return static_cast<uint32_t>(size + 2 + x + 1);
+    }
+    if (x < 0) {
+        return static_cast<uint32_t>(2 * (size + 2) + y);
+    }
+
+    return static_cast<uint32_t>(2 * (size + 2) + size + y);
+}
+
+void GradientMapGenerator::generateRects(
+    const HeightMapGenerator::Faces& heights,
+    const Rects& rects,
+    Faces& gradients,
+    System::JobSystem& jobSystem
+) const {
+    std::vector<GradientJob> jobs;
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        const Rect& rect = rects[face];
+        if (isEmpty(rect)) {
+            continue;
+        }
+
+        for (uint32_t row = rect.yMin; row < rect.yMax; row += tileRowsNb) {
+            jobs.push_back({static_cast<CubeMap::Face>(face), row, std::min(row + tileRowsNb, rect.yMax)});
+        }
+    }
+
+    jobSystem.parallelFor(static_cast<uint32_t>(jobs.size()), [this, &heights, &rects, &gradients, &jobs](uint32_t jobIndex) {
+        PROFILE_SCOPE("GradientMapGenerator::generateTile");
+
+        const GradientJob& job = jobs[jobIndex];
+        uint32_t face = static_cast<uint32_t>(job.face);
+        const Rect& rect = rects[face];
+        uint32_t count = rect.xMax - rect.xMin;
+
+        // Three rows around the generated row, with one more texel on each side
+        std::vector<float> rowsData(3 * (count + 2));
+        float* rows[3] = {rowsData.data(), rowsData.data() + count + 2, rowsData.data() + 2 * (count + 2)};
+
+        readRow(heights, job.face, static_cast<int64_t>(job.firstRow) - 1, rect.xMin, rect.xMax, rows[0]);
+        readRow(heights, job.face, job.firstRow, rect.xMin, rect.xMax, rows[1]);
+
+        for (uint32_t row = job.firstRow; row < job.lastRow; ++row) {
+            readRow(heights, job.face, static_cast<int64_t>(row) + 1, rect.xMin, rect.xMax, rows[2]);
+
+            glm::vec2* rowGradients = gradients[face].data() + static_cast<size_t>(row) * _size + rect.xMin;
+            uint32_t first = 0;
+
+#if defined(PLANET_AVX2)
+            if (_avx2Enabled) {
+                first = count & ~7u;
+                generateAVX2(_filter, rows[0], rows[1], rows[2], rowGradients, first);
+            }
+#endif
+
+            generateScalar(_filter, rows[0] + first, rows[1] + first, rows[2] + first, rowGradients + first, count - first);
+
+            // The middle row becomes the top row and the bottom row the middle row
+            std::swap(rows[0], rows[1]);
+            std::swap(rows[1], rows[2]);
+        }
+    });
+}
+
+void GradientMapGenerator::readRow(
+    const HeightMapGenerator::Faces& heights,
+    CubeMap::Face face,
+    int64_t y,
+    uint32_t xMin,
+    uint32_t xMax,
+    float* row
+) const {
+    int64_t size = _size;
+    const std::vector<Texel>& borders = _borders[static_cast<uint32_t>(face)];
+
+    auto readBorder = [this, &heights, &borders](int64_t borderX, int64_t borderY) {
+        const Texel& texel = borders[getBorderIndex(borderX, borderY)];
+        return heights[texel.face][texel.index];
+    };
+
+    // The rows above and below the face are in the borders
+    if (y < 0 || y >= size) {
+        for (int64_t x = static_cast<int64_t>(xMin) - 1; x <= static_cast<int64_t>(xMax); ++x) {
+            row[x - xMin + 1] = readBorder(x, y);
+        }
+        return;
+    }
+
+    const float* faceRow = heights[static_cast<uint32_t>(face)].data() + static_cast<size_t>(y) * _size;
+
+    row[0] = xMin > 0 ? faceRow[xMin - 1] : readBorder(-1, y);
+    std::memcpy(row + 1, faceRow + xMin, (xMax - xMin) * sizeof(float));
+    row[xMax - xMin + 1] = xMax < _size ? faceRow[xMax] : readBorder(size, y);
+}
+
+} // Namespace Core
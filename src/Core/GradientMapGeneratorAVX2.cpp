@@ -0,0 +1,74 @@
+// Compiled with -mavx2 (/arch:AVX2 with MSVC) when PLANET_AVX2 is defined,
+// only called if GradientMapGenerator::isAVX2Supported
+#if defined(PLANET_AVX2)
+
+#include <immintrin.h> // AVX2 intrinsics
+
+#include <Core/GradientMapGenerator.hpp> // Core::GradientMapGenerator
+
+/*
+ * 8 texels at a time version of the kernel of GradientMapGenerator.cpp
+ * The operations are done in the same order (and without FMA), so the gradients are the same as the scalar kernel
+*/
+
+namespace Core {
+
+// Interleave the x and y gradients of 8 texels
+static void storeGradients(__m256 x, __m256 y, glm::vec2* gradients) {
+    // x0 y0 x1 y1 | x4 y4 x5 y5 and x2 y2 x3 y3 | x6 y6 x7 y7
+    __m256 low = _mm256_unpacklo_ps(x, y);
+    __m256 high = _mm256_unpackhi_ps(x, y);
+
+    float* data = reinterpret_cast<float*>(gradients);
+    _mm256_storeu_ps(data, _mm256_permute2f128_ps(low, high, 0x20));
+    _mm256_storeu_ps(data + 8, _mm256_permute2f128_ps(low, high, 0x31));
+}
+
+void GradientMapGenerator::generateAVX2(
+    Filter filter,
+    const float* top,
+    const float* middle,
+    const float* bottom,
+    glm::vec2* gradients,
+    uint32_t count
+) {
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 scale = _mm256_set1_ps(4.0f);
+
+    for (uint32_t i = 0; i + 8 <= count; i += 8) {
+        if (filter == Filter::SOBEL) {
+            __m256 topLeft = _mm256_loadu_ps(top + i);
+            __m256 topCenter = _mm256_loadu_ps(top + i + 1);
+            __m256 topRight = _mm256_loadu_ps(top + i + 2);
+            __m256 left = _mm256_loadu_ps(middle + i);
+            __m256 right = _mm256_loadu_ps(middle + i + 2);
+            __m256 bottomLeft = _mm256_loadu_ps(bottom + i);
+            __m256 bottomCenter = _mm256_loadu_ps(bottom + i + 1);
+            __m256 bottomRight = _mm256_loadu_ps(bottom + i + 2);
+
+            __m256 x = _mm256_sub_ps(topLeft, topRight);
+            x = _mm256_add_ps(x, _mm256_mul_ps(two, left));
+            x = _mm256_sub_ps(x, _mm256_mul_ps(two, right));
+            x = _mm256_add_ps(x, bottomLeft);
+            x = _mm256_sub_ps(x, bottomRight);
+
+            __m256 y = _mm256_add_ps(topLeft, _mm256_mul_ps(two, topCenter));
+            y = _mm256_add_ps(y, topRight);
+            y = _mm256_sub_ps(y, bottomLeft);
+            y = _mm256_sub_ps(y, _mm256_mul_ps(two, bottomCenter));
+            y = _mm256_sub_ps(y, bottomRight);
+
+            storeGradients(x, y, gradients + i);
+        }
+        else {
+            __m256 x = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(middle + i), _mm256_loadu_ps(middle + i + 2)), scale);
+            __m256 y = _mm256_mul_ps(_mm256_sub_ps(_mm256_loadu_ps(top + i + 1), _mm256_loadu_ps(bottom + i + 1)), scale);
+
+            storeGradients(x, y, gradients + i);
+        }
+    }
+}
+
+} // Namespace Core
+
+#endif
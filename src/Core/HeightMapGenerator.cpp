@@ -0,0 +1,298 @@
+#include <algorithm> // std::min
+#include <cmath> // std::floor, std::fabs
+#include <random> // std::mt19937
+#include <utility> // std::swap
+
+#if defined(_MSC_VER)
+    #include <intrin.h> // __cpuid, __cpuidex, _xgetbv
+#endif
+
+#include <glm/geometric.hpp> // glm::normalize
+
+#include <System/Profiler.hpp> // PROFILE_SCOPE
+
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+
+/*
+ * The kernels of HeightMapGeneratorAVX2.cpp do the same operations in the same order,
+ * any change here must be done there too
+*/
+
+namespace Core {
+
+constexpr uint32_t HeightMapGenerator::tileRowsNb;
+
+// Skew and unskew factors of the 3D simplex grid
+static const float skewFactor = 1.0f / 3.0f;
+static const float unskewFactor = 1.0f / 6.0f;
+
+// Offsets of the three domain warping fBm, so they are not correlated
+static const float warpOffsets[3][3] = {
+    {5.2f, 1.3f, 2.8f},
+    {1.7f, 9.2f, 3.1f},
+    {8.3f, 2.8f, 7.4f}
+};
+
+// Dot product with one of the 12 gradients of the cube edges (improved Perlin noise gradients)
+static float getGradient(int32_t hash, float x, float y, float z) {
+    int32_t h = hash & 15;
+    float u = h < 8 ? x : y;
+    float v = h < 4 ? y : (h == 12 || h == 14 ? x : z);
+
+    return ((h & 1) ? -u : u) + ((h & 2) ? -v : v);
+}
+
+static float getCornerContribution(int32_t hash, float x, float y, float z) {
+    float t = 0.6f - x * x - y * y - z * z;
+    t = t > 0.0f ? t : 0.0f;
+    float t2 = t * t;
+
+    return t2 * t2 * getGradient(hash, x, y, z);
+}
+
+// Simplex noise in [-1, 1]
+static float getSimplex(const int32_t* permutations, float x, float y, float z) {
+    // Simplex cell containing the point
+    float s = (x + y + z) * skewFactor;
+    float i = std::floor(x + s);
+    float j = std::floor(y + s);
+    float k = std::floor(z + s);
+
+    float t = (i + j + k) * unskewFactor;
+    float x0 = x - (i - t);
+    float y0 = y - (j - t);
+    float z0 = z - (k - t);
+
+    // Second and third corners of the simplex, depending on the largest coordinates
+    int32_t i1 = (x0 >= y0) & (x0 >= z0);
+    int32_t j1 = (y0 > x0) & (y0 >= z0);
+    int32_t k1 = (z0 > x0) & (z0 > y0);
+    int32_t i2 = (x0 >= y0) | (x0 >= z0);
+    int32_t j2 = (y0 > x0) | (y0 >= z0);
+    int32_t k2 = (z0 > x0) | (z0 > y0);
+
+    float x1 = x0 - static_cast<float>(i1) + unskewFactor;
+    float y1 = y0 - static_cast<float>(j1) + unskewFactor;
+    float z1 = z0 - static_cast<float>(k1) + unskewFactor;
+    float x2 = x0 - static_cast<float>(i2) + 2.0f * unskewFactor;
+    float y2 = y0 - static_cast<float>(j2) + 2.0f * unskewFactor;
+    float z2 = z0 - static_cast<float>(k2) + 2.0f * unskewFactor;
+    float x3 = x0 - 1.0f + 3.0f * unskewFactor;
+    float y3 = y0 - 1.0f + 3.0f * unskewFactor;
+    float z3 = z0 - 1.0f + 3.0f * unskewFactor;
+
+    int32_t ii = static_cast<int32_t>(i) & 255;
+    int32_t jj = static_cast<int32_t>(j) & 255;
+    int32_t kk = static_cast<int32_t>(k) & 255;
+
+    int32_t hash0 = permutations[ii + permutations[jj + permutations[kk]]];
+    int32_t hash1 = permutations[ii + i1 + permutations[jj + j1 + permutations[kk + k1]]];
+    int32_t hash2 = permutations[ii + i2 + permutations[jj + j2 + permutations[kk + k2]]];
+    int32_t hash3 = permutations[ii + 1 + permutations[jj + 1 + permutations[kk + 1]]];
+
+    float n0 = getCornerContribution(hash0, x0, y0, z0);
+    float n1 = getCornerContribution(hash1, x1, y1, z1);
+    float n2 = getCornerContribution(hash2, x2, y2, z2);
+    float n3 = getCornerContribution(hash3, x3, y3, z3);
+
+    return 32.0f * (n0 + n1 + n2 + n3);
+}
+
+// fBm in [-1, 1]
+static float getFbm(
+    const HeightMapGenerator::Parameters& parameters,
+    const int32_t* permutations,
+    float x,
+    float y,
+    float z,
+    uint32_t octaves
+) {
+    float sum = 0.0f;
+    float amplitude = 1.0f;
+    float amplitudes = 0.0f;
+    float frequency = parameters.frequency;
+
+    for (uint32_t octave = 0; octave < octaves; ++octave) {
+        sum += amplitude * getSimplex(permutations, x * frequency, y * frequency, z * frequency);
+
+        amplitudes += amplitude;
+        amplitude *= parameters.gain;
+        frequency *= parameters.lacunarity;
+    }
+
+    return sum / amplitudes;
+}
+
+// Ridged multifractal in [0, 1], each octave is weighted by the previous one so the valleys stay smooth
+static float getRidged(
+    const HeightMapGenerator::Parameters& parameters,
+    const int32_t* permutations,
+    float x,
+    float y,
+    float z
+) {
+    float sum = 0.0f;
+    float amplitude = 1.0f;
+    float amplitudes = 0.0f;
+    float frequency = parameters.frequency;
+    float weight = 1.0f;
+
+    for (uint32_t octave = 0; octave < parameters.octaves; ++octave) {
+        float signal = 1.0f - std::fabs(getSimplex(permutations, x * frequency, y * frequency, z * frequency));
+        signal = signal * signal;
+        signal = signal * weight;
+
+        float nextWeight = signal * 2.0f;
+        weight = nextWeight < 1.0f ? nextWeight : 1.0f;
+
+        sum += amplitude * signal;
+
+        amplitudes += amplitude;
+        amplitude *= parameters.gain;
+        frequency *= parameters.lacunarity;
+    }
+
+    return sum / amplitudes;
+}
+
+HeightMapGenerator::HeightMapGenerator(const Parameters& parameters):
+    _parameters(parameters), _avx2Enabled(isAVX2Supported()) {
+    if (_parameters.octaves == 0) {
+        _parameters.octaves = 1;
+    }
+    if (_parameters.warpOctaves == 0) {
+        _parameters.warpOctaves = 1;
+    }
+
+    // std::shuffle is implementation defined, the permutation must be the same on all platforms
+    std::mt19937 random(_parameters.seed);
+
+    for (int32_t i = 0; i < 256; ++i) {
+        _permutations[i] = i;
+    }
+    for (uint32_t i = 255; i > 0; --i) {
+        std::swap(_permutations[i], _permutations[random() % (i + 1)]);
+    }
+    for (uint32_t i = 0; i < 256; ++i) {
+        _permutations[i + 256] = _permutations[i];
+    }
+}
+
+bool HeightMapGenerator::isAVX2Supported() {
+#if !defined(PLANET_AVX2)
+    return false;
+#elif defined(_MSC_VER)
+    int info[4];
+
+    // AVX and registers saved by the OS
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+const HeightMapGenerator::Parameters& HeightMapGenerator::getParameters() const {
+    return _parameters;
+}
+
+void HeightMapGenerator::setAVX2Enabled(bool enabled) {
+    _avx2Enabled = enabled && isAVX2Supported();
+}
+
+bool HeightMapGenerator::isAVX2Enabled() const {
+    return _avx2Enabled;
+}
+
+void HeightMapGenerator::generate(Faces& faces, System::JobSystem& jobSystem) const {
+    PROFILE_SCOPE("HeightMapGenerator::generate");
+
+    uint32_t size = _parameters.size;
+    uint32_t tilesNb = (size + tileRowsNb - 1) / tileRowsNb;
+
+    for (auto& face: faces) {
+        face.resize(size * size);
+    }
+
+    jobSystem.parallelFor(CubeMap::facesNb * tilesNb, [this, &faces, size, tilesNb](uint32_t job) {
+        PROFILE_SCOPE("HeightMapGenerator::generateTile");
+
+        CubeMap::Face face = static_cast<CubeMap::Face>(job / tilesNb);
+        uint32_t firstRow = (job % tilesNb) * tileRowsNb;
+        uint32_t lastRow = std::min(firstRow + tileRowsNb, size);
+
+        std::vector<float> x(size);
+        std::vector<float> y(size);
+        std::vector<float> z(size);
+
+        for (uint32_t row = firstRow; row < lastRow; ++row) {
+            for (uint32_t column = 0; column < size; ++column) {
+                glm::vec3 direction = glm::normalize(CubeMap::getDirection(face, column, row, size));
+
+                x[column] = direction.x;
+                y[column] = direction.y;
+                z[column] = direction.z;
+            }
+
+            float* heights = faces[static_cast<uint32_t>(face)].data() + row * size;
+            generate(x.data(), y.data(), z.data(), heights, size);
+        }
+    });
+}
+
+void HeightMapGenerator::generate(const float* x, const float* y, const float* z, float* heights, uint32_t count) const {
+    uint32_t first = 0;
+
+#if defined(PLANET_AVX2)
+    if (_avx2Enabled) {
+        first = count & ~7u;
+        generateAVX2(_parameters, _permutations.data(), x, y, z, heights, first);
+    }
+#endif
+
+    generateScalar(_parameters, _permutations.data(), x + first, y + first, z + first, heights + first, count - first);
+}
+
+void HeightMapGenerator::generateScalar(
+    const Parameters& parameters,
+    const int32_t* permutations,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* heights,
+    uint32_t count
+) {
+    for (uint32_t i = 0; i < count; ++i) {
+        float pointX = x[i];
+        float pointY = y[i];
+        float pointZ = z[i];
+
+        if (parameters.warpStrength != 0.0f) {
+            float warpX = getFbm(parameters, permutations, pointX + warpOffsets[0][0], pointY + warpOffsets[0][1], pointZ + warpOffsets[0][2], parameters.warpOctaves);
+            float warpY = getFbm(parameters, permutations, pointX + warpOffsets[1][0], pointY + warpOffsets[1][1], pointZ + warpOffsets[1][2], parameters.warpOctaves);
+            float warpZ = getFbm(parameters, permutations, pointX + warpOffsets[2][0], pointY + warpOffsets[2][1], pointZ + warpOffsets[2][2], parameters.warpOctaves);
+
+            pointX = pointX + parameters.warpStrength * warpX;
+            pointY = pointY + parameters.warpStrength * warpY;
+            pointZ = pointZ + parameters.warpStrength * warpZ;
+        }
+
+        float height;
+        if (parameters.noiseType == NoiseType::RIDGED) {
+            height = getRidged(parameters, permutations, pointX, pointY, pointZ);
+        }
+        else {
+            height = 0.5f + 0.5f * getFbm(parameters, permutations, pointX, pointY, pointZ, parameters.octaves);
+        }
+
+        height = height > 0.0f ? height : 0.0f;
+        heights[i] = height < 1.0f ? height : 1.0f;
+    }
+}
+
+} // Namespace Core
@@ -0,0 +1,264 @@
+// Compiled with -mavx2 (/arch:AVX2 with MSVC) when PLANET_AVX2 is defined,
+// only called if HeightMapGenerator::isAVX2Supported
+#if defined(PLANET_AVX2)
+
+#include <immintrin.h> // AVX2 intrinsics
+
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+
+/*
+ * 8 points at a time version of the kernels of HeightMapGenerator.cpp
+ * The operations are done in the same order (and without FMA), so the heights are the same as the scalar kernels
+*/
+
+namespace Core {
+
+static const float skewFactor = 1.0f / 3.0f;
+static const float unskewFactor = 1.0f / 6.0f;
+
+static const float warpOffsets[3][3] = {
+    {5.2f, 1.3f, 2.8f},
+    {1.7f, 9.2f, 3.1f},
+    {8.3f, 2.8f, 7.4f}
+};
+
+static __m256 getGradient(__m256i hash, __m256 x, __m256 y, __m256 z) {
+    __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+
+    // u = h < 8 ? x : y
+    __m256 uMask = _mm256_castsi256_ps(_mm256_cmpgt_epi32(h, _mm256_set1_epi32(7)));
+    __m256 u = _mm256_blendv_ps(x, y, uMask);
+
+    // v = h < 4 ? y : (h == 12 || h == 14 ? x : z)
+    __m256 xMask = _mm256_castsi256_ps(_mm256_or_si256(
+        _mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+        _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))
+    ));
+    __m256 vMask = _mm256_castsi256_ps(_mm256_cmpgt_epi32(h, _mm256_set1_epi32(3)));
+    __m256 v = _mm256_blendv_ps(y, _mm256_blendv_ps(z, x, xMask), vMask);
+
+    // Bits 0 and 1 of the hash flip the signs of u and v
+    __m256 uSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+    __m256 vSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+
+    return _mm256_add_ps(_mm256_xor_ps(u, uSign), _mm256_xor_ps(v, vSign));
+}
+
+static __m256 getCornerContribution(__m256i hash, __m256 x, __m256 y, __m256 z) {
+    __m256 t = _mm256_sub_ps(_mm256_set1_ps(0.6f), _mm256_mul_ps(x, x));
+    t = _mm256_sub_ps(t, _mm256_mul_ps(y, y));
+    t = _mm256_sub_ps(t, _mm256_mul_ps(z, z));
+    t = _mm256_max_ps(t, _mm256_setzero_ps());
+    __m256 t2 = _mm256_mul_ps(t, t);
+
+    return _mm256_mul_ps(_mm256_mul_ps(t2, t2), getGradient(hash, x, y, z));
+}
+
+static __m256i getHash(const int32_t* permutations, __m256i i, __m256i j, __m256i k) {
+    __m256i hash = _mm256_i32gather_epi32(permutations, k, 4);
+    hash = _mm256_i32gather_epi32(permutations, _mm256_add_epi32(j, hash), 4);
+
+    return _mm256_i32gather_epi32(permutations, _mm256_add_epi32(i, hash), 4);
+}
+
+static __m256 getSimplex(const int32_t* permutations, __m256 x, __m256 y, __m256 z) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256i oneInt = _mm256_set1_epi32(1);
+
+    __m256 s = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(x, y), z), _mm256_set1_ps(skewFactor));
+    __m256 i = _mm256_floor_ps(_mm256_add_ps(x, s));
+    __m256 j = _mm256_floor_ps(_mm256_add_ps(y, s));
+    __m256 k = _mm256_floor_ps(_mm256_add_ps(z, s));
+
+    __m256 t = _mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(i, j), k), _mm256_set1_ps(unskewFactor));
+    __m256 x0 = _mm256_sub_ps(x, _mm256_sub_ps(i, t));
+    __m256 y0 = _mm256_sub_ps(y, _mm256_sub_ps(j, t));
+    __m256 z0 = _mm256_sub_ps(z, _mm256_sub_ps(k, t));
+
+    __m256 xGreaterEqualY = _mm256_cmp_ps(x0, y0, _CMP_GE_OQ);
+    __m256 xGreaterEqualZ = _mm256_cmp_ps(x0, z0, _CMP_GE_OQ);
+    __m256 yGreaterX = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+    __m256 yGreaterEqualZ = _mm256_cmp_ps(y0, z0, _CMP_GE_OQ);
+    __m256 zGreaterX = _mm256_cmp_ps(z0, x0, _CMP_GT_OQ);
+    __m256 zGreaterY = _mm256_cmp_ps(z0, y0, _CMP_GT_OQ);
+
+    __m256 i1 = _mm256_and_ps(_mm256_and_ps(xGreaterEqualY, xGreaterEqualZ), one);
+    __m256 j1 = _mm256_and_ps(_mm256_and_ps(yGreaterX, yGreaterEqualZ), one);
+    __m256 k1 = _mm256_and_ps(_mm256_and_ps(zGreaterX, zGreaterY), one);
+    __m256 i2 = _mm256_and_ps(_mm256_or_ps(xGreaterEqualY, xGreaterEqualZ), one);
+    __m256 j2 = _mm256_and_ps(_mm256_or_ps(yGreaterX, yGreaterEqualZ), one);
+    __m256 k2 = _mm256_and_ps(_mm256_or_ps(zGreaterX, zGreaterY), one);
+
+    const __m256 offset1 = _mm256_set1_ps(unskewFactor);
+    const __m256 offset2 = _mm256_set1_ps(2.0f * unskewFactor);
+    const __m256 offset3 = _mm256_set1_ps(3.0f * unskewFactor);
+
+    __m256 x1 = _mm256_add_ps(_mm256_sub_ps(x0, i1), offset1);
+    __m256 y1 = _mm256_add_ps(_mm256_sub_ps(y0, j1), offset1);
+    __m256 z1 = _mm256_add_ps(_mm256_sub_ps(z0, k1), offset1);
+    __m256 x2 = _mm256_add_ps(_mm256_sub_ps(x0, i2), offset2);
+    __m256 y2 = _mm256_add_ps(_mm256_sub_ps(y0, j2), offset2);
+    __m256 z2 = _mm256_add_ps(_mm256_sub_ps(z0, k2), offset2);
+    __m256 x3 = _mm256_add_ps(_mm256_sub_ps(x0, one), offset3);
+    __m256 y3 = _mm256_add_ps(_mm256_sub_ps(y0, one), offset3);
+    __m256 z3 = _mm256_add_ps(_mm256_sub_ps(z0, one), offset3);
+
+    const __m256i mask = _mm256_set1_epi32(255);
+    __m256i ii = _mm256_and_si256(_mm256_cvttps_epi32(i), mask);
+    __m256i jj = _mm256_and_si256(_mm256_cvttps_epi32(j), mask);
+    __m256i kk = _mm256_and_si256(_mm256_cvttps_epi32(k), mask);
+
+    __m256i hash0 = getHash(permutations, ii, jj, kk);
+    __m256i hash1 = getHash(
+        permutations,
+        _mm256_add_epi32(ii, _mm256_cvttps_epi32(i1)),
+        _mm256_add_epi32(jj, _mm256_cvttps_epi32(j1)),
+        _mm256_add_epi32(kk, _mm256_cvttps_epi32(k1))
+    );
+    __m256i hash2 = getHash(
+        permutations,
+        _mm256_add_epi32(ii, _mm256_cvttps_epi32(i2)),
+        _mm256_add_epi32(jj, _mm256_cvttps_epi32(j2)),
+        _mm256_add_epi32(kk, _mm256_cvttps_epi32(k2))
+    );
+    __m256i hash3 = getHash(
+        permutations,
+        _mm256_add_epi32(ii, oneInt),
+        _mm256_add_epi32(jj, oneInt),
+        _mm256_add_epi32(kk, oneInt)
+    );
+
+    __m256 n0 = getCornerContribution(hash0, x0, y0, z0);
+    __m256 n1 = getCornerContribution(hash1, x1, y1, z1);
+    __m256 n2 = getCornerContribution(hash2, x2, y2, z2);
+    __m256 n3 = getCornerContribution(hash3, x3, y3, z3);
+
+    __m256 sum = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(n0, n1), n2), n3);
+    return _mm256_mul_ps(_mm256_set1_ps(32.0f), sum);
+}
+
+static __m256 getFbm(
+    const HeightMapGenerator::Parameters& parameters,
+    const int32_t* permutations,
+    __m256 x,
+    __m256 y,
+    __m256 z,
+    uint32_t octaves
+) {
+    __m256 sum = _mm256_setzero_ps();
+    float amplitude = 1.0f;
+    float amplitudes = 0.0f;
+    float frequency = parameters.frequency;
+
+    for (uint32_t octave = 0; octave < octaves; ++octave) {
+        __m256 frequencies = _mm256_set1_ps(frequency);
+        __m256 noise = getSimplex(
+            permutations,
+            _mm256_mul_ps(x, frequencies),
+            _mm256_mul_ps(y, frequencies),
+            _mm256_mul_ps(z, frequencies)
+        );
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(amplitude), noise));
+
+        amplitudes += amplitude;
+        amplitude *= parameters.gain;
+        frequency *= parameters.lacunarity;
+    }
+
+    return _mm256_div_ps(sum, _mm256_set1_ps(amplitudes));
+}
+
+static __m256 getRidged(
+    const HeightMapGenerator::Parameters& parameters,
+    const int32_t* permutations,
+    __m256 x,
+    __m256 y,
+    __m256 z
+) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+    __m256 sum = _mm256_setzero_ps();
+    float amplitude = 1.0f;
+    float amplitudes = 0.0f;
+    float frequency = parameters.frequency;
+    __m256 weight = one;
+
+    for (uint32_t octave = 0; octave < parameters.octaves; ++octave) {
+        __m256 frequencies = _mm256_set1_ps(frequency);
+        __m256 noise = getSimplex(
+            permutations,
+            _mm256_mul_ps(x, frequencies),
+            _mm256_mul_ps(y, frequencies),
+            _mm256_mul_ps(z, frequencies)
+        );
+
+        __m256 signal = _mm256_sub_ps(one, _mm256_andnot_ps(signMask, noise));
+        signal = _mm256_mul_ps(signal, signal);
+        signal = _mm256_mul_ps(signal, weight);
+
+        weight = _mm256_min_ps(_mm256_mul_ps(signal, _mm256_set1_ps(2.0f)), one);
+
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(amplitude), signal));
+
+        amplitudes += amplitude;
+        amplitude *= parameters.gain;
+        frequency *= parameters.lacunarity;
+    }
+
+    return _mm256_div_ps(sum, _mm256_set1_ps(amplitudes));
+}
+
+void HeightMapGenerator::generateAVX2(
+    const Parameters& parameters,
+    const int32_t* permutations,
+    const float* x,
+    const float* y,
+    const float* z,
+    float* heights,
+    uint32_t count
+) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 warpStrength = _mm256_set1_ps(parameters.warpStrength);
+
+    for (uint32_t i = 0; i + 8 <= count; i += 8) {
+        __m256 pointX = _mm256_loadu_ps(x + i);
+        __m256 pointY = _mm256_loadu_ps(y + i);
+        __m256 pointZ = _mm256_loadu_ps(z + i);
+
+        if (parameters.warpStrength != 0.0f) {
+            __m256 warp[3];
+            for (uint32_t axis = 0; axis < 3; ++axis) {
+                warp[axis] = getFbm(
+                    parameters,
+                    permutations,
+                    _mm256_add_ps(pointX, _mm256_set1_ps(warpOffsets[axis][0])),
+                    _mm256_add_ps(pointY, _mm256_set1_ps(warpOffsets[axis][1])),
+                    _mm256_add_ps(pointZ, _mm256_set1_ps(warpOffsets[axis][2])),
+                    parameters.warpOctaves
+                );
+            }
+
+            pointX = _mm256_add_ps(pointX, _mm256_mul_ps(warpStrength, warp[0]));
+            pointY = _mm256_add_ps(pointY, _mm256_mul_ps(warpStrength, warp[1]));
+            pointZ = _mm256_add_ps(pointZ, _mm256_mul_ps(warpStrength, warp[2]));
+        }
+
+        __m256 height;
+        if (parameters.noiseType == NoiseType::RIDGED) {
+            height = getRidged(parameters, permutations, pointX, pointY, pointZ);
+        }
+        else {
+            height = _mm256_add_ps(half, _mm256_mul_ps(half, getFbm(parameters, permutations, pointX, pointY, pointZ, parameters.octaves)));
+        }
+
+        height = _mm256_max_ps(height, _mm256_setzero_ps());
+        height = _mm256_min_ps(height, _mm256_set1_ps(1.0f));
+
+        _mm256_storeu_ps(heights + i, height);
+    }
+}
+
+} // Namespace Core
+
+#endif
@@ -0,0 +1,149 @@
+#include <algorithm> // std::min, std::max
+
+#include <System/Profiler.hpp> // PROFILE_SCOPE
+
+#include <Core/HeightMipChain.hpp> // Core::HeightMipChain
+
+namespace Core {
+
+constexpr uint32_t HeightMipChain::blockRowsNb;
+
+// Texels [begin, end[ of the previous level under the texel i of a level of size size
+static void getFootprint(uint32_t i, uint32_t size, uint32_t previousSize, uint32_t& begin, uint32_t& end) {
+    begin = i * 2;
+    end = i + 1 == size ? previousSize : begin + 2;
+}
+
+std::vector<uint32_t> HeightMipChain::getSizes(uint32_t faceSize) {
+    std::vector<uint32_t> sizes = {faceSize};
+
+    while (sizes.back() > 1) {
+        sizes.push_back(sizes.back() / 2);
+    }
+
+    return sizes;
+}
+
+void HeightMipChain::generate(const Faces& faces, uint32_t faceSize, System::JobSystem& jobSystem) {
+    PROFILE_SCOPE("HeightMipChain::generate");
+
+    _sizes = getSizes(faceSize);
+    _offsets.assign(_sizes.size(), 0);
+    _faceTexelsNb = 0;
+    for (uint32_t level = 1; level < _sizes.size(); ++level) {
+        _offsets[level] = _faceTexelsNb;
+        _faceTexelsNb += static_cast<size_t>(_sizes[level]) * _sizes[level];
+    }
+
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        _heights[face].resize(_faceTexelsNb);
+        _minMax[face].resize(_faceTexelsNb);
+    }
+
+    // The levels depend on the previous one, the rows of a level are generated in parallel
+    for (uint32_t level = 1; level < _sizes.size(); ++level) {
+        uint32_t size = _sizes[level];
+        uint32_t previousSize = _sizes[level - 1];
+        uint32_t blocksNb = (size + blockRowsNb - 1) / blockRowsNb;
+
+        jobSystem.parallelFor(CubeMap::facesNb * blocksNb, [this, &faces, level, size, previousSize, blocksNb](uint32_t job) {
+            uint32_t face = job / blocksNb;
+            uint32_t firstRow = (job % blocksNb) * blockRowsNb;
+
+            // The level 0 has no min/max, its heights are used for both
+            const float* previousHeights = level == 1 ? faces[face] : _heights[face].data() + _offsets[level - 1];
+            const glm::vec2* previousMinMax = level == 1 ? nullptr : _minMax[face].data() + _offsets[level - 1];
+            float* heights = _heights[face].data() + _offsets[level];
+            glm::vec2* minMax = _minMax[face].data() + _offsets[level];
+
+            for (uint32_t y = firstRow; y < std::min(firstRow + blockRowsNb, size); ++y) {
+                uint32_t yBegin = 0;
+                uint32_t yEnd = 0;
+                getFootprint(y, size, previousSize, yBegin, yEnd);
+
+                const float* top = previousHeights + static_cast<size_t>(yBegin) * previousSize;
+                const float* bottom = top + previousSize;
+                size_t row = static_cast<size_t>(y) * size;
+
+                // Texels covering 2x2 texels, all of them if the previous size is even
+                uint32_t evenSize = 0;
+                if (yEnd - yBegin == 2) {
+                    evenSize = previousSize % 2 == 0 ? size : size - 1;
+                }
+
+                if (previousMinMax == nullptr) {
+                    for (uint32_t x = 0; x < evenSize; ++x) {
+                        float topLeft = top[x * 2];
+                        float topRight = top[x * 2 + 1];
+                        float bottomLeft = bottom[x * 2];
+                        float bottomRight = bottom[x * 2 + 1];
+
+                        heights[row + x] = (topLeft + topRight + bottomLeft + bottomRight) * 0.25f;
+                        minMax[row + x] = glm::vec2(
+                            std::min(std::min(topLeft, topRight), std::min(bottomLeft, bottomRight)),
+                            std::max(std::max(topLeft, topRight), std::max(bottomLeft, bottomRight))
+                        );
+                    }
+                }
+                else {
+                    const glm::vec2* topMinMax = previousMinMax + static_cast<size_t>(yBegin) * previousSize;
+                    const glm::vec2* bottomMinMax = topMinMax + previousSize;
+
+                    for (uint32_t x = 0; x < evenSize; ++x) {
+                        heights[row + x] = (top[x * 2] + top[x * 2 + 1] + bottom[x * 2] + bottom[x * 2 + 1]) * 0.25f;
+                        minMax[row + x] = glm::vec2(
+                            std::min(std::min(topMinMax[x * 2].x, topMinMax[x * 2 + 1].x), std::min(bottomMinMax[x * 2].x, bottomMinMax[x * 2 + 1].x)),
+                            std::max(std::max(topMinMax[x * 2].y, topMinMax[x * 2 + 1].y), std::max(bottomMinMax[x * 2].y, bottomMinMax[x * 2 + 1].y))
+                        );
+                    }
+                }
+
+                // The last texel of an odd row, or the texels of the last row covering 3 rows
+                for (uint32_t x = evenSize; x < size; ++x) {
+                    uint32_t xBegin = 0;
+                    uint32_t xEnd = 0;
+                    getFootprint(x, size, previousSize, xBegin, xEnd);
+
+                    float sum = 0.0f;
+                    glm::vec2 texelMinMax(1.0f, 0.0f);
+
+                    for (uint32_t texelY = yBegin; texelY < yEnd; ++texelY) {
+                        for (uint32_t texelX = xBegin; texelX < xEnd; ++texelX) {
+                            size_t texel = static_cast<size_t>(texelY) * previousSize + texelX;
+                            glm::vec2 previous = previousMinMax == nullptr ? glm::vec2(previousHeights[texel]) : previousMinMax[texel];
+
+                            sum += previousHeights[texel];
+                            texelMinMax.x = std::min(texelMinMax.x, previous.x);
+                            texelMinMax.y = std::max(texelMinMax.y, previous.y);
+                        }
+                    }
+
+                    heights[row + x] = sum / static_cast<float>((xEnd - xBegin) * (yEnd - yBegin));
+                    minMax[row + x] = texelMinMax;
+                }
+            }
+        });
+    }
+}
+
+uint32_t HeightMipChain::getLevelsNb() const {
+    return static_cast<uint32_t>(_sizes.size());
+}
+
+uint32_t HeightMipChain::getSize(uint32_t level) const {
+    return _sizes[level];
+}
+
+const float* HeightMipChain::getHeights(CubeMap::Face face, uint32_t level) const {
+    return _heights[static_cast<uint32_t>(face)].data() + _offsets[level];
+}
+
+const glm::vec2* HeightMipChain::getMinMax(CubeMap::Face face, uint32_t level) const {
+    return _minMax[static_cast<uint32_t>(face)].data() + _offsets[level];
+}
+
+size_t HeightMipChain::getFaceTexelsNb() const {
+    return _faceTexelsNb;
+}
+
+} // Namespace Core
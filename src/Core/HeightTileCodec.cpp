@@ -0,0 +1,408 @@
+#include <algorithm> // std::min, std::copy
+#include <cstring> // std::memcpy, std::memset
+#include <vector> // std::vector
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h> // SSE2 intrinsics
+#define PLANET_SSE2
+#endif
+
+#include <Core/HeightTileCodec.hpp> // Core::HeightTileCodec
+
+namespace Core {
+
+constexpr uint32_t HeightTileCodec::blockSize;
+constexpr uint32_t HeightTileCodec::maxMaxError;
+
+// Residuals of a block per lane
+static constexpr uint32_t lanesNb = 8;
+static constexpr uint32_t laneSize = HeightTileCodec::blockSize / lanesNb;
+
+static uint32_t getBlocksNb(uint32_t texelsNb) {
+    return (texelsNb + HeightTileCodec::blockSize - 1) / HeightTileCodec::blockSize;
+}
+
+static uint16_t encodeZigzag(uint16_t residual) {
+    return static_cast<uint16_t>((residual << 1) ^ (residual & 0x8000 ? 0xFFFF : 0));
+}
+
+static uint16_t decodeZigzag(uint16_t value) {
+    return static_cast<uint16_t>((value >> 1) ^ (value & 1 ? 0xFFFF : 0));
+}
+
+static uint32_t getBitsNb(uint16_t value) {
+    uint32_t bitsNb = 0;
+    while (value >> bitsNb) {
+        ++bitsNb;
+    }
+    return bitsNb;
+}
+
+// Zigzag encoded residuals, modulo 2^16 so the prediction is always reversible
+static void computeResiduals(
+    const uint16_t* values,
+    uint32_t width,
+    uint32_t height,
+    HeightTileCodec::Predictor predictor,
+    std::vector<uint16_t>& residuals
+) {
+    residuals.resize(static_cast<size_t>(width) * height);
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint16_t* row = values + static_cast<size_t>(y) * width;
+        const uint16_t* upRow = y > 0 ? row - width : nullptr;
+
+        for (uint32_t x = 0; x < width; ++x) {
+            uint16_t left = x > 0 ? row[x - 1] : 0;
+            uint16_t prediction = left;
+
+            if (upRow != nullptr) {
+                if (predictor == HeightTileCodec::Predictor::UP) {
+                    prediction = upRow[x];
+                }
+                else {
+                    prediction = static_cast<uint16_t>(upRow[x] + left - (x > 0 ? upRow[x - 1] : 0));
+                }
+            }
+
+            residuals[static_cast<size_t>(y) * width + x] = encodeZigzag(static_cast<uint16_t>(row[x] - prediction));
+        }
+    }
+}
+
+static uint32_t getBlockBitsNb(const std::vector<uint16_t>& residuals, uint32_t block) {
+    size_t begin = static_cast<size_t>(block) * HeightTileCodec::blockSize;
+    size_t end = std::min(begin + HeightTileCodec::blockSize, residuals.size());
+
+    uint16_t bits = 0;
+    for (size_t i = begin; i < end; ++i) {
+        bits |= residuals[i];
+    }
+
+    return getBitsNb(bits);
+}
+
+static size_t getPackedSize(const std::vector<uint16_t>& residuals) {
+    size_t size = 0;
+    for (uint32_t block = 0; block < getBlocksNb(static_cast<uint32_t>(residuals.size())); ++block) {
+        size += 1 + 2 * lanesNb * getBlockBitsNb(residuals, block);
+    }
+    return size;
+}
+
+// The residual i of the block is the residual i / 8 of the lane i % 8, the words of the lanes are interleaved
+static void packBlock(const uint16_t* residuals, uint32_t residualsNb, uint32_t bitsNb, uint16_t* words) {
+    std::memset(words, 0, lanesNb * bitsNb * sizeof(uint16_t));
+
+    for (uint32_t lane = 0; lane < lanesNb; ++lane) {
+        uint32_t bitPos = 0;
+
+        for (uint32_t i = 0; i < laneSize; ++i, bitPos += bitsNb) {
+            uint32_t residual = lane + i * lanesNb < residualsNb ? residuals[lane + i * lanesNb] : 0;
+            uint32_t word = bitPos / 16;
+            uint32_t offset = bitPos % 16;
+
+            words[word * lanesNb + lane] |= static_cast<uint16_t>(residual << offset);
+            if (offset + bitsNb > 16) {
+                words[(word + 1) * lanesNb + lane] |= static_cast<uint16_t>(residual >> (16 - offset));
+            }
+        }
+    }
+}
+
+static void unpackBlockScalar(const uint8_t* data, uint32_t bitsNb, uint16_t* residuals) {
+    // Copy so the words are aligned on 2 bytes
+    uint16_t words[lanesNb * 16];
+    std::memcpy(words, data, lanesNb * bitsNb * sizeof(uint16_t));
+
+    uint32_t mask = (1u << bitsNb) - 1;
+
+    for (uint32_t lane = 0; lane < lanesNb; ++lane) {
+        uint32_t bitPos = 0;
+
+        for (uint32_t i = 0; i < laneSize; ++i, bitPos += bitsNb) {
+            uint32_t word = bitPos / 16;
+            uint32_t offset = bitPos % 16;
+
+            uint32_t value = words[word * lanesNb + lane] >> offset;
+            if (offset + bitsNb > 16) {
+                value |= static_cast<uint32_t>(words[(word + 1) * lanesNb + lane]) << (16 - offset);
+            }
+
+            residuals[lane + i * lanesNb] = decodeZigzag(static_cast<uint16_t>(value & mask));
+        }
+    }
+}
+
+// Heights from the residuals, in place
+static void reconstructScalar(uint16_t* texels, uint32_t width, uint32_t height, HeightTileCodec::Predictor predictor) {
+    for (uint32_t y = 0; y < height; ++y) {
+        uint16_t* row = texels + static_cast<size_t>(y) * width;
+        const uint16_t* upRow = y > 0 ? row - width : nullptr;
+
+        // Difference with the height above, or height on the first row
+        uint16_t sum = 0;
+        for (uint32_t x = 0; x < width; ++x) {
+            if (upRow != nullptr && predictor == HeightTileCodec::Predictor::UP) {
+                row[x] = static_cast<uint16_t>(upRow[x] + row[x]);
+                continue;
+            }
+
+            sum = static_cast<uint16_t>(sum + row[x]);
+            row[x] = upRow != nullptr ? static_cast<uint16_t>(upRow[x] + sum) : sum;
+        }
+    }
+}
+
+static void dequantizeScalar(uint16_t* texels, size_t texelsNb, uint16_t step) {
+    for (size_t i = 0; i < texelsNb; ++i) {
+        texels[i] = static_cast<uint16_t>(std::min<uint32_t>(static_cast<uint32_t>(texels[i]) * step, 0xFFFF));
+    }
+}
+
+#if defined(PLANET_SSE2)
+
+static __m128i decodeZigzagSIMD(__m128i value) {
+    __m128i sign = _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(value, _mm_set1_epi16(1)));
+    return _mm_xor_si128(_mm_srli_epi16(value, 1), sign);
+}
+
+// Same as unpackBlockScalar, the 8 lanes are unpacked together
+static void unpackBlockSIMD(const uint8_t* data, uint32_t bitsNb, uint16_t* residuals) {
+    const __m128i* words = reinterpret_cast<const __m128i*>(data);
+    __m128i mask = _mm_set1_epi16(static_cast<short>((1u << bitsNb) - 1));
+    __m128i current = _mm_loadu_si128(words);
+    uint32_t word = 0;
+    uint32_t offset = 0;
+
+    for (uint32_t i = 0; i < laneSize; ++i) {
+        __m128i value = _mm_srl_epi16(current, _mm_cvtsi32_si128(static_cast<int>(offset)));
+
+        offset += bitsNb;
+        if (offset >= 16) {
+            offset -= 16;
+            ++word;
+
+            if (word < bitsNb) {
+                current = _mm_loadu_si128(words + word);
+                if (offset > 0) {
+                    value = _mm_or_si128(value, _mm_sll_epi16(current, _mm_cvtsi32_si128(static_cast<int>(bitsNb - offset))));
+                }
+            }
+        }
+
+        value = _mm_and_si128(value, mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(residuals + i * lanesNb), decodeZigzagSIMD(value));
+    }
+}
+
+// Inclusive prefix sum of 8 heights, carry has the previous sum in all its lanes
+static __m128i prefixSumSIMD(__m128i value, __m128i& carry) {
+    value = _mm_add_epi16(value, _mm_slli_si128(value, 2));
+    value = _mm_add_epi16(value, _mm_slli_si128(value, 4));
+    value = _mm_add_epi16(value, _mm_slli_si128(value, 8));
+    value = _mm_add_epi16(value, carry);
+
+    // Broadcast the last lane
+    carry = _mm_shufflehi_epi16(value, 0xFF);
+    carry = _mm_unpackhi_epi64(carry, carry);
+
+    return value;
+}
+
+static void reconstructSIMD(uint16_t* texels, uint32_t width, uint32_t height, HeightTileCodec::Predictor predictor) {
+    uint32_t vectorWidth = width & ~(lanesNb - 1);
+
+    for (uint32_t y = 0; y < height; ++y) {
+        uint16_t* row = texels + static_cast<size_t>(y) * width;
+        const uint16_t* upRow = y > 0 ? row - width : nullptr;
+
+        if (upRow != nullptr && predictor == HeightTileCodec::Predictor::UP) {
+            uint32_t x = 0;
+            for (; x < vectorWidth; x += lanesNb) {
+                __m128i residuals = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+                __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i*>(upRow + x));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), _mm_add_epi16(up, residuals));
+            }
+            for (; x < width; ++x) {
+                row[x] = static_cast<uint16_t>(upRow[x] + row[x]);
+            }
+            continue;
+        }
+
+        __m128i carry = _mm_setzero_si128();
+        uint32_t x = 0;
+        for (; x < vectorWidth; x += lanesNb) {
+            __m128i sum = prefixSumSIMD(_mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x)), carry);
+            if (upRow != nullptr) {
+                sum = _mm_add_epi16(sum, _mm_loadu_si128(reinterpret_cast<const __m128i*>(upRow + x)));
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), sum);
+        }
+
+        uint16_t sum = static_cast<uint16_t>(_mm_extract_epi16(carry, 0));
+        for (; x < width; ++x) {
+            sum = static_cast<uint16_t>(sum + row[x]);
+            row[x] = upRow != nullptr ? static_cast<uint16_t>(upRow[x] + sum) : sum;
+        }
+    }
+}
+
+static void dequantizeSIMD(uint16_t* texels, size_t texelsNb, uint16_t step) {
+    __m128i stepVector = _mm_set1_epi16(static_cast<short>(step));
+    __m128i ones = _mm_set1_epi16(-1);
+
+    size_t i = 0;
+    for (; i + lanesNb <= texelsNb; i += lanesNb) {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(texels + i));
+        __m128i low = _mm_mullo_epi16(value, stepVector);
+        __m128i high = _mm_mulhi_epu16(value, stepVector);
+
+        // Saturate to 0xFFFF when the product does not fit on 16 bits
+        __m128i overflow = _mm_xor_si128(_mm_cmpeq_epi16(high, _mm_setzero_si128()), ones);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(texels + i), _mm_or_si128(low, overflow));
+    }
+
+    dequantizeScalar(texels + i, texelsNb - i, step);
+}
+
+#endif
+
+bool HeightTileCodec::isSIMDSupported() {
+#if defined(PLANET_SSE2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t HeightTileCodec::getMaxEncodedSize(uint32_t width, uint32_t height) {
+    uint32_t blocksNb = getBlocksNb(width * height);
+    return sizeof(Header) + blocksNb * (1 + 2 * lanesNb * 16);
+}
+
+size_t HeightTileCodec::encode(const uint16_t* texels, uint32_t width, uint32_t height, uint32_t maxError, uint8_t* data) {
+    uint32_t texelsNb = width * height;
+    maxError = std::min(maxError, maxMaxError);
+    uint16_t step = static_cast<uint16_t>(2 * maxError + 1);
+
+    // floor((height + maxError) / step) * step is at most maxError from the height, the decoder saturates it to 0xFFFF
+    std::vector<uint16_t> values(texels, texels + texelsNb);
+    if (step > 1) {
+        for (uint16_t& value: values) {
+            value = static_cast<uint16_t>((value + maxError) / step);
+        }
+    }
+
+    // The smallest predictor is kept
+    std::vector<uint16_t> residuals;
+    std::vector<uint16_t> gradientResiduals;
+    computeResiduals(values.data(), width, height, Predictor::UP, residuals);
+    computeResiduals(values.data(), width, height, Predictor::GRADIENT, gradientResiduals);
+
+    Header header = {Predictor::UP, 0, step};
+    if (getPackedSize(gradientResiduals) < getPackedSize(residuals)) {
+        header.predictor = Predictor::GRADIENT;
+        residuals.swap(gradientResiduals);
+    }
+
+    std::memcpy(data, &header, sizeof(Header));
+
+    uint32_t blocksNb = getBlocksNb(texelsNb);
+    uint8_t* bitsNbs = data + sizeof(Header);
+    uint8_t* packedData = bitsNbs + blocksNb;
+
+    uint16_t words[lanesNb * 16];
+    for (uint32_t block = 0; block < blocksNb; ++block) {
+        uint32_t bitsNb = getBlockBitsNb(residuals, block);
+        uint32_t begin = block * blockSize;
+
+        packBlock(residuals.data() + begin, std::min(blockSize, texelsNb - begin), bitsNb, words);
+
+        bitsNbs[block] = static_cast<uint8_t>(bitsNb);
+        std::memcpy(packedData, words, lanesNb * bitsNb * sizeof(uint16_t));
+        packedData += lanesNb * bitsNb * sizeof(uint16_t);
+    }
+
+    return static_cast<size_t>(packedData - data);
+}
+
+bool HeightTileCodec::decode(const uint8_t* data, size_t size, uint32_t width, uint32_t height, uint16_t* texels, bool simd) {
+    uint32_t texelsNb = width * height;
+    uint32_t blocksNb = getBlocksNb(texelsNb);
+
+    if (size < sizeof(Header) + blocksNb) {
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.predictor != Predictor::UP && header.predictor != Predictor::GRADIENT) {
+        return false;
+    }
+    if (header.step == 0 || header.step % 2 == 0) {
+        return false;
+    }
+
+    const uint8_t* bitsNbs = data + sizeof(Header);
+    size_t packedSize = 0;
+    for (uint32_t block = 0; block < blocksNb; ++block) {
+        if (bitsNbs[block] > 16) {
+            return false;
+        }
+        packedSize += lanesNb * bitsNbs[block] * sizeof(uint16_t);
+    }
+    if (size != sizeof(Header) + blocksNb + packedSize) {
+        return false;
+    }
+
+#if defined(PLANET_SSE2)
+    auto unpackBlock = simd ? unpackBlockSIMD : unpackBlockScalar;
+#else
+    (void)simd;
+    auto unpackBlock = unpackBlockScalar;
+#endif
+
+    // The residuals are unpacked in the texels, the last block is unpacked in a copy if it's not full
+    const uint8_t* packedData = bitsNbs + blocksNb;
+    uint16_t lastBlock[blockSize];
+
+    for (uint32_t block = 0; block < blocksNb; ++block) {
+        uint32_t bitsNb = bitsNbs[block];
+        uint32_t begin = block * blockSize;
+        bool full = begin + blockSize <= texelsNb;
+        uint16_t* residuals = full ? texels + begin : lastBlock;
+
+        if (bitsNb == 0) {
+            std::memset(residuals, 0, blockSize * sizeof(uint16_t));
+        }
+        else {
+            unpackBlock(packedData, bitsNb, residuals);
+        }
+
+        if (!full) {
+            std::copy(lastBlock, lastBlock + (texelsNb - begin), texels + begin);
+        }
+
+        packedData += lanesNb * bitsNb * sizeof(uint16_t);
+    }
+
+#if defined(PLANET_SSE2)
+    if (simd) {
+        reconstructSIMD(texels, width, height, header.predictor);
+        if (header.step > 1) {
+            dequantizeSIMD(texels, texelsNb, header.step);
+        }
+        return true;
+    }
+#endif
+
+    reconstructScalar(texels, width, height, header.predictor);
+    if (header.step > 1) {
+        dequantizeScalar(texels, texelsNb, header.step);
+    }
+
+    return true;
+}
+
+} // Namespace Core
@@ -0,0 +1,265 @@
+#include <cstring> // std::memcmp, std::memcpy
+#include <iostream> // std::cerr
+#include <vector> // std::vector
+
+#include <Core/HeightTileCodec.hpp> // Core::HeightTileCodec
+
+#include <System/Profiler.hpp> // PROFILE_SCOPE
+
+#include <Core/HeightTileSet.hpp> // Core::HeightTileSet
+
+namespace Core {
+
+constexpr uint32_t HeightTileSet::version;
+
+static_assert(sizeof(HeightTileSet::Header) == 48, "The tile set header layout changed, increment HeightTileSet::version");
+static_assert(sizeof(HeightTileSet::Tile) == 16, "The tile set tile layout changed, increment HeightTileSet::version");
+
+static const char tileSetMagic[8] = {'P', 'L', 'A', 'N', 'E', 'T', 'T', 'S'};
+
+std::unique_ptr<HeightTileSet::Writer> HeightTileSet::Writer::create(const std::string& fileName, const Description& description) {
+    // Don't use std::make_unique because the constructor is private
+    std::unique_ptr<Writer> writer(new Writer());
+
+    if (!writer->init(fileName, description)) {
+        return nullptr;
+    }
+
+    return writer;
+}
+
+bool HeightTileSet::Writer::writeTile(CubeMap::Face face, uint32_t level, uint32_t x, uint32_t y, const uint16_t* texels) {
+    const char* data = reinterpret_cast<const char*>(texels);
+    uint32_t size = getTexelsNb() * sizeof(uint16_t);
+    uint64_t index = getTileIndex(_description, face, level, x, y);
+
+    // Encoded by the calling thread, outside of the lock
+    std::vector<uint8_t> packedTexels;
+    if (_description.format == Format::R16_PACKED) {
+        uint32_t tileTexelsSize = _description.tileSize + 2 * _description.border;
+
+        packedTexels.resize(HeightTileCodec::getMaxEncodedSize(tileTexelsSize, tileTexelsSize));
+        size = static_cast<uint32_t>(HeightTileCodec::encode(texels, tileTexelsSize, tileTexelsSize, _description.maxError, packedTexels.data()));
+        data = reinterpret_cast<const char*>(packedTexels.data());
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _file.write(data, size);
+    _tiles[index] = {_offset, size, 0};
+    _offset += size;
+
+    if (!_file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::Writer::writeTile: Failed to write \"" << _fileName << "\"" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool HeightTileSet::Writer::finish() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _file.seekp(sizeof(Header));
+    _file.write(reinterpret_cast<const char*>(_tiles.data()), _tiles.size() * sizeof(Tile));
+    _file.close();
+
+    if (_file.fail()) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::Writer::finish: Failed to write \"" << _fileName << "\"" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+const HeightTileSet::Description& HeightTileSet::Writer::getDescription() const {
+    return _description;
+}
+
+uint32_t HeightTileSet::Writer::getTexelsNb() const {
+    uint32_t size = _description.tileSize + 2 * _description.border;
+    return size * size;
+}
+
+bool HeightTileSet::Writer::init(const std::string& fileName, const Description& description) {
+    _fileName = fileName;
+    _description = description;
+
+    if (_description.tileSize == 0 || _description.levelsNb == 0 || _description.levelsNb > 16 ||
+        (_description.format != Format::R16 && _description.format != Format::R16_PACKED) ||
+        _description.maxError > HeightTileCodec::maxMaxError) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::Writer::init: Invalid tile set description" << std::endl;
+        return false;
+    }
+
+    _file.open(fileName, std::ios::binary);
+    if (!_file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::Writer::init: Can't open \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, tileSetMagic, sizeof(tileSetMagic));
+    header.version = version;
+    header.format = _description.format;
+    header.tileSize = _description.tileSize;
+    header.border = _description.border;
+    header.levelsNb = _description.levelsNb;
+    header.maxError = _description.format == Format::R16_PACKED ? _description.maxError : 0;
+
+    // The table is written again by finish, the missing tiles keep a size of 0
+    _tiles.assign(getTilesNb(_description), Tile{0, 0, 0});
+
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _file.write(reinterpret_cast<const char*>(_tiles.data()), _tiles.size() * sizeof(Tile));
+    _offset = sizeof(Header) + _tiles.size() * sizeof(Tile);
+
+    return _file.good();
+}
+
+std::unique_ptr<HeightTileSet> HeightTileSet::create(const std::string& fileName) {
+    // Don't use std::make_unique because the constructor is private
+    std::unique_ptr<HeightTileSet> tileSet(new HeightTileSet());
+
+    if (!tileSet->init(fileName)) {
+        return nullptr;
+    }
+
+    return tileSet;
+}
+
+uint64_t HeightTileSet::getTileIndex(const Description& description, CubeMap::Face face, uint32_t level, uint32_t x, uint32_t y) {
+    // (4^level - 1) / 3 tiles in the previous levels
+    uint64_t previousTilesNb = ((uint64_t(1) << (2 * level)) - 1) / 3;
+    uint64_t faceTilesNb = ((uint64_t(1) << (2 * description.levelsNb)) - 1) / 3;
+
+    return static_cast<uint64_t>(face) * faceTilesNb + previousTilesNb + (static_cast<uint64_t>(y) << level) + x;
+}
+
+uint64_t HeightTileSet::getTilesNb(const Description& description) {
+    return ((uint64_t(1) << (2 * description.levelsNb)) - 1) / 3 * CubeMap::facesNb;
+}
+
+const HeightTileSet::Description& HeightTileSet::getDescription() const {
+    return _description;
+}
+
+uint32_t HeightTileSet::getFaceSize(uint32_t level) const {
+    return _description.tileSize << level;
+}
+
+uint32_t HeightTileSet::getTileTexelsSize() const {
+    return _description.tileSize + 2 * _description.border;
+}
+
+bool HeightTileSet::hasTile(CubeMap::Face face, uint32_t level, uint32_t x, uint32_t y) const {
+    if (level >= _description.levelsNb || x >= (1u << level) || y >= (1u << level)) {
+        return false;
+    }
+
+    return _tiles[getTileIndex(_description, face, level, x, y)].size != 0;
+}
+
+bool HeightTileSet::readTile(CubeMap::Face face, uint32_t level, uint32_t x, uint32_t y, uint16_t* texels) const {
+    PROFILE_SCOPE("HeightTileSet::readTile");
+
+    if (!hasTile(face, level, x, y)) {
+        return false;
+    }
+
+    const Tile& tile = _tiles[getTileIndex(_description, face, level, x, y)];
+
+    if (_description.format == Format::R16_PACKED) {
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(_data + tile.offset);
+
+        if (!HeightTileCodec::decode(data, tile.size, getTileTexelsSize(), getTileTexelsSize(), texels)) {
+            // TODO: replace this with logger
+            std::cerr << "HeightTileSet::readTile: Invalid tile " << level << " " << x << " " << y << " of the face " << static_cast<uint32_t>(face) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    std::memcpy(texels, _data + tile.offset, tile.size);
+
+    return true;
+}
+
+bool HeightTileSet::init(const std::string& fileName) {
+    PROFILE_SCOPE("HeightTileSet::init");
+
+    _file = System::MappedFile::create(fileName);
+    if (_file == nullptr) {
+        return false;
+    }
+
+    _data = static_cast<const char*>(_file->getData());
+    size_t fileSize = _file->getSize();
+
+    if (fileSize < sizeof(Header)) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::init: \"" << fileName << "\" is not a height tile set" << std::endl;
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, _data, sizeof(Header));
+
+    if (std::memcmp(header.magic, tileSetMagic, sizeof(tileSetMagic)) != 0) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::init: \"" << fileName << "\" is not a height tile set" << std::endl;
+        return false;
+    }
+    if (header.version != version) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::init: \"" << fileName << "\" has version " << header.version;
+        std::cerr << ", version " << version << " is expected, build it again" << std::endl;
+        return false;
+    }
+    if ((header.format != Format::R16 && header.format != Format::R16_PACKED) ||
+        header.tileSize == 0 || header.levelsNb == 0 || header.levelsNb > 16) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::init: \"" << fileName << "\" has an unsupported format" << std::endl;
+        return false;
+    }
+
+    _description.tileSize = header.tileSize;
+    _description.border = header.border;
+    _description.levelsNb = header.levelsNb;
+    _description.format = header.format;
+    _description.maxError = header.maxError;
+
+    uint64_t tilesNb = getTilesNb(_description);
+    if (fileSize < sizeof(Header) + tilesNb * sizeof(Tile)) {
+        // TODO: replace this with logger
+        std::cerr << "HeightTileSet::init: \"" << fileName << "\" is truncated" << std::endl;
+        return false;
+    }
+
+    _tiles = reinterpret_cast<const Tile*>(_data + sizeof(Header));
+
+    // The packed tiles are validated when they are decoded
+    uint64_t tileSize = static_cast<uint64_t>(getTileTexelsSize()) * getTileTexelsSize() * sizeof(uint16_t);
+    if (_description.format == Format::R16_PACKED) {
+        tileSize = HeightTileCodec::getMaxEncodedSize(getTileTexelsSize(), getTileTexelsSize());
+    }
+
+    for (uint64_t i = 0; i < tilesNb; ++i) {
+        const Tile& tile = _tiles[i];
+        bool validSize = _description.format == Format::R16_PACKED ? tile.size <= tileSize : tile.size == tileSize;
+
+        if (tile.size != 0 && (!validSize || tile.offset > fileSize || tile.size > fileSize - tile.offset)) {
+            // TODO: replace this with logger
+            std::cerr << "HeightTileSet::init: \"" << fileName << "\" has an invalid tile" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // Namespace Core
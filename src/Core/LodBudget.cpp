@@ -0,0 +1,124 @@
+#include <algorithm> // std::max
+#include <utility> // std::move
+
+#include <Core/LodBudget.hpp> // Core::LodBudget
+
+namespace Core {
+
+static bool fitsLimit(uint64_t used, uint64_t size, uint64_t limit, float fraction) {
+    // A reservation doesn't fail for the resources it doesn't use
+    return limit == 0 || size == 0 || static_cast<double>(used + size) <= static_cast<double>(limit) * fraction;
+}
+
+static uint64_t getLimitExcess(uint64_t used, uint64_t limit) {
+    return limit != 0 && used > limit ? used - limit : 0;
+}
+
+LodBudget::LodBudget(const Limits& limits): _limits(limits) {}
+
+LodBudget::~LodBudget() {
+    if (_parent != nullptr) {
+        _parent->release(_usage);
+    }
+}
+
+bool LodBudget::reserve(const Usage& usage, float fraction) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (!fits(usage, fraction)) {
+        return false;
+    }
+    if (_parent != nullptr && !_parent->reserve(usage, fraction)) {
+        return false;
+    }
+
+    _usage.nodesNb += usage.nodesNb;
+    _usage.verticesSize += usage.verticesSize;
+    _usage.texturesSize += usage.texturesSize;
+
+    return true;
+}
+
+void LodBudget::release(const Usage& usage) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _usage.nodesNb -= usage.nodesNb;
+    _usage.verticesSize -= usage.verticesSize;
+    _usage.texturesSize -= usage.texturesSize;
+
+    if (_parent != nullptr) {
+        _parent->release(usage);
+    }
+}
+
+LodBudget::Usage LodBudget::getUsage() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _usage;
+}
+
+LodBudget::Usage LodBudget::getExcess() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Usage excess = {
+        static_cast<uint32_t>(getLimitExcess(_usage.nodesNb, _limits.nodesNb)),
+        getLimitExcess(_usage.verticesSize, _limits.verticesSize),
+        getLimitExcess(_usage.texturesSize, _limits.texturesSize)
+    };
+
+    if (_parent != nullptr) {
+        Usage parentExcess = _parent->getExcess();
+        excess.nodesNb = std::max(excess.nodesNb, parentExcess.nodesNb);
+        excess.verticesSize = std::max(excess.verticesSize, parentExcess.verticesSize);
+        excess.texturesSize = std::max(excess.texturesSize, parentExcess.texturesSize);
+    }
+
+    return excess;
+}
+
+LodBudget::Limits LodBudget::getLimits() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _limits;
+}
+
+void LodBudget::setLimits(const Limits& limits) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _limits = limits;
+}
+
+const std::shared_ptr<LodBudget>& LodBudget::getParent() const {
+    return _parent;
+}
+
+void LodBudget::setParent(std::shared_ptr<LodBudget> parent) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_parent != nullptr) {
+        _parent->release(_usage);
+    }
+
+    _parent = std::move(parent);
+
+    if (_parent != nullptr) {
+        _parent->add(_usage);
+    }
+}
+
+bool LodBudget::fits(const Usage& usage, float fraction) const {
+    return fitsLimit(_usage.nodesNb, usage.nodesNb, _limits.nodesNb, fraction) &&
+        fitsLimit(_usage.verticesSize, usage.verticesSize, _limits.verticesSize, fraction) &&
+        fitsLimit(_usage.texturesSize, usage.texturesSize, _limits.texturesSize, fraction);
+}
+
+void LodBudget::add(const Usage& usage) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    _usage.nodesNb += usage.nodesNb;
+    _usage.verticesSize += usage.verticesSize;
+    _usage.texturesSize += usage.texturesSize;
+
+    if (_parent != nullptr) {
+        _parent->add(usage);
+    }
+}
+
+} // Namespace Core
@@ -0,0 +1,67 @@
+#include <algorithm> // std::min, std::max
+
+#include <Core/LodGovernor.hpp> // Core::LodGovernor
+
+namespace Core {
+
+LodGovernor::LodGovernor(const Settings& settings): _settings(settings) {}
+
+float LodGovernor::update(float frameTime) {
+    if (_smoothedFrameTime <= 0.0f) {
+        _smoothedFrameTime = frameTime;
+    }
+    else {
+        _smoothedFrameTime += (frameTime - _smoothedFrameTime) * _settings.smoothing;
+    }
+
+    // Positive when the frames are faster than the target, so the LOD can increase
+    float error = (_settings.targetFrameTime - _smoothedFrameTime) / _settings.targetFrameTime;
+
+    _state = State::STABLE;
+    if (error > -_settings.band && error < _settings.band) {
+        return _scale;
+    }
+
+    float step = std::min(std::max(error * _settings.gain, -_settings.maxStep), _settings.maxStep);
+    float scale = std::min(std::max(_scale * (1.0f + step), _settings.minScale), _settings.maxScale);
+
+    if (scale > _scale) {
+        _state = State::INCREASING;
+    }
+    else if (scale < _scale) {
+        _state = State::DECREASING;
+    }
+
+    _scale = scale;
+
+    return _scale;
+}
+
+void LodGovernor::reset() {
+    _scale = 1.0f;
+    _smoothedFrameTime = 0.0f;
+    _state = State::STABLE;
+}
+
+const LodGovernor::Settings& LodGovernor::getSettings() const {
+    return _settings;
+}
+
+void LodGovernor::setSettings(const Settings& settings) {
+    _settings = settings;
+    _scale = std::min(std::max(_scale, _settings.minScale), _settings.maxScale);
+}
+
+float LodGovernor::getScale() const {
+    return _scale;
+}
+
+float LodGovernor::getSmoothedFrameTime() const {
+    return _smoothedFrameTime;
+}
+
+LodGovernor::State LodGovernor::getState() const {
+    return _state;
+}
+
+} // Namespace Core
@@ -0,0 +1,187 @@
+#include <algorithm> // std::max
+#include <iterator> // std::make_move_iterator
+#include <utility> // std::move, std::swap
+
+#include <System/Profiler.hpp> // PROFILE_SCOPE, System::Profiler
+
+#include <Core/LodPipeline.hpp> // Core::LodPipeline
+
+namespace Core {
+
+// Move the uploads of added after the ones of uploads
+static void appendUploads(VirtualHeightMap::Uploads& uploads, VirtualHeightMap::Uploads& added) {
+    if (uploads.slots.empty() && uploads.indirections.empty()) {
+        std::swap(uploads, added);
+        return;
+    }
+
+    uploads.slots.insert(uploads.slots.end(), std::make_move_iterator(added.slots.begin()), std::make_move_iterator(added.slots.end()));
+    uploads.indirections.insert(
+        uploads.indirections.end(),
+        std::make_move_iterator(added.indirections.begin()),
+        std::make_move_iterator(added.indirections.end())
+    );
+    uploads.statistics = added.statistics;
+}
+
+LodPipeline::LodPipeline(UpdateFunction update): _update(std::move(update)) {}
+
+LodPipeline::~LodPipeline() {
+    stop();
+}
+
+std::unique_ptr<LodPipeline> LodPipeline::create(UpdateFunction update) {
+    std::unique_ptr<LodPipeline> pipeline(new LodPipeline(std::move(update)));
+
+    if (!pipeline->init()) {
+        return nullptr;
+    }
+
+    return pipeline;
+}
+
+void LodPipeline::setCamera(const Graphics::Camera& camera) {
+    CameraState& cameraState = _cameras.getWriteBuffer();
+    cameraState.camera = camera;
+    cameraState.frame = ++_frame;
+    cameraState.timer.reset();
+    _cameras.publish();
+
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _cameraPublished = true;
+    }
+    _wakeCondition.notify_one();
+}
+
+const LodPipeline::Snapshot* LodPipeline::acquireSnapshot() {
+    if (!_snapshots.update()) {
+        return nullptr;
+    }
+
+    Snapshot& snapshot = _snapshots.getReadBuffer();
+    if (snapshot.generation != _generation.load(std::memory_order_relaxed)) {
+        ++_invalidatedSnapshotsNb;
+        _metrics.droppedSnapshotsNb = snapshot.skippedSnapshotsNb + _invalidatedSnapshotsNb;
+        return nullptr;
+    }
+
+    // The tiles of the snapshot were queued before it was published, the next ones may be queued too
+    {
+        std::lock_guard<std::mutex> lock(_heightTilesMutex);
+
+        for (uint32_t i = 0; i < snapshot.planets.size() && i < _heightTiles.size(); ++i) {
+            snapshot.planets[i].heightTiles.clear();
+            std::swap(snapshot.planets[i].heightTiles, _heightTiles[i]);
+        }
+    }
+
+    float latency = snapshot.cameraTimer.getElapsedTime() * 1000.0f;
+
+    ++_metrics.displayedSnapshotsNb;
+    _totalLatency += latency;
+
+    _metrics.latency = latency;
+    _metrics.averageLatency = _totalLatency / static_cast<float>(_metrics.displayedSnapshotsNb);
+    _metrics.maxLatency = std::max(_metrics.maxLatency, latency);
+    _metrics.framesLatency = _frame - snapshot.cameraFrame;
+    _metrics.updateTime = snapshot.updateTime * 1000.0f;
+    _metrics.updatesNb = snapshot.updatesNb;
+    _metrics.droppedSnapshotsNb = snapshot.skippedSnapshotsNb + _invalidatedSnapshotsNb;
+
+    return &snapshot;
+}
+
+std::unique_lock<std::mutex> LodPipeline::pause() {
+    return std::unique_lock<std::mutex>(_updateMutex);
+}
+
+void LodPipeline::invalidate() {
+    _generation.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(_heightTilesMutex);
+    for (auto& heightTiles: _heightTiles) {
+        heightTiles.clear();
+    }
+}
+
+void LodPipeline::stop() {
+    {
+        std::lock_guard<std::mutex> lock(_wakeMutex);
+        _stop = true;
+    }
+    _wakeCondition.notify_one();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+const LodPipeline::Metrics& LodPipeline::getMetrics() const {
+    return _metrics;
+}
+
+bool LodPipeline::init() {
+    _thread = std::thread(&LodPipeline::run, this);
+
+    return true;
+}
+
+void LodPipeline::run() {
+    System::Profiler::setThreadName("LOD");
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_wakeMutex);
+            _wakeCondition.wait(lock, [this]() { return _stop || _cameraPublished; });
+
+            if (_stop) {
+                return;
+            }
+
+            _cameraPublished = false;
+        }
+
+        _cameras.update();
+        CameraState& cameraState = _cameras.getReadBuffer();
+        Snapshot& snapshot = _snapshots.getWriteBuffer();
+
+        {
+            PROFILE_SCOPE("LodPipeline::update");
+
+            std::lock_guard<std::mutex> lock(_updateMutex);
+            System::Timer timer;
+
+            for (auto& planet: snapshot.planets) {
+                planet.heightTiles.clear();
+            }
+
+            _update(cameraState.camera, snapshot.planets);
+
+            // Queued before the snapshot is published, so it's acquired with its tiles
+            {
+                std::lock_guard<std::mutex> heightTilesLock(_heightTilesMutex);
+
+                _heightTiles.resize(snapshot.planets.size());
+                for (uint32_t i = 0; i < snapshot.planets.size(); ++i) {
+                    appendUploads(_heightTiles[i], snapshot.planets[i].heightTiles);
+                }
+            }
+
+            snapshot.updateTime = timer.getElapsedTime();
+            // The generation can only change while the update is paused
+            snapshot.generation = _generation.load(std::memory_order_relaxed);
+        }
+
+        snapshot.cameraFrame = cameraState.frame;
+        snapshot.cameraTimer = cameraState.timer;
+        snapshot.updatesNb = ++_updatesNb;
+        snapshot.skippedSnapshotsNb = _skippedSnapshotsNb;
+
+        if (!_snapshots.publish()) {
+            ++_skippedSnapshotsNb;
+        }
+    }
+}
+
+} // Namespace Core
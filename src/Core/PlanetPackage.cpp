@@ -0,0 +1,281 @@
+#include <cstring> // std::memcmp, std::memcpy
+#include <fstream> // std::ofstream
+#include <iostream> // std::cerr
+
+#include <Core/GradientMapGenerator.hpp> // Core::GradientMapGenerator
+#include <Core/HeightMipChain.hpp> // Core::HeightMipChain
+#include <Core/TexelFormat.hpp> // Core::TexelFormat
+#include <System/Profiler.hpp> // PROFILE_SCOPE
+
+#include <Core/PlanetPackage.hpp> // Core::PlanetPackage
+
+namespace Core {
+
+constexpr uint32_t PlanetPackage::version;
+constexpr uint32_t PlanetPackage::sectionAlignment;
+
+static_assert(sizeof(PlanetPackage::Header) == 72, "The package header layout changed, increment PlanetPackage::version");
+static_assert(sizeof(PlanetPackage::Section) == 24, "The package section layout changed, increment PlanetPackage::version");
+
+static const char packageMagic[8] = {'P', 'L', 'A', 'N', 'E', 'T', 'P', 'K'};
+// Rows of gradients encoded by a job
+static const uint32_t rowsGrainSize = 16;
+
+static uint64_t alignOffset(uint64_t offset) {
+    return (offset + PlanetPackage::sectionAlignment - 1) / PlanetPackage::sectionAlignment * PlanetPackage::sectionAlignment;
+}
+
+std::unique_ptr<PlanetPackage> PlanetPackage::create(const std::string& fileName) {
+    // Don't use std::make_unique because the constructor is private
+    std::unique_ptr<PlanetPackage> package(new PlanetPackage());
+
+    if (!package->init(fileName)) {
+        return nullptr;
+    }
+
+    return package;
+}
+
+void PlanetPackage::generate(const Description& description, System::JobSystem& jobSystem, Content& content) {
+    PROFILE_SCOPE("PlanetPackage::generate");
+
+    HeightMapGenerator generator(description.heightMapParameters);
+    generator.generate(content.heights, jobSystem);
+
+    uint32_t faceSize = description.heightMapParameters.size;
+
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        content.gradients[face].resize(faceSize * faceSize * 2);
+    }
+
+    // The gradients are read around the faces on the neighbor faces, like gradient.frag
+    {
+        GradientMapGenerator gradientGenerator(faceSize);
+        GradientMapGenerator::Faces gradients;
+        gradientGenerator.generate(content.heights, gradients, jobSystem);
+
+        jobSystem.parallelFor(CubeMap::facesNb * faceSize, [&content, &gradients, faceSize](uint32_t job) {
+            uint32_t face = job / faceSize;
+            size_t first = static_cast<size_t>(job % faceSize) * faceSize;
+
+            for (size_t texel = first; texel < first + faceSize; ++texel) {
+                TexelFormat::encodeGradient(gradients[face][texel], TexelFormat::Gradient::RG16F, content.gradients[face].data() + texel * 2);
+            }
+        }, rowsGrainSize);
+    }
+
+    // Same pyramid as the mipmaps of the height map texture
+    {
+        HeightMipChain mipChain;
+        HeightMipChain::Faces faces;
+        for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+            faces[face] = content.heights[face].data();
+        }
+
+        mipChain.generate(faces, faceSize, jobSystem);
+
+        for (uint32_t face = 0; face < CubeMap::facesNb && mipChain.getLevelsNb() > 1; ++face) {
+            const glm::vec2* minMax = mipChain.getMinMax(static_cast<CubeMap::Face>(face), 1);
+            content.minMax[face].assign(minMax, minMax + mipChain.getFaceTexelsNb());
+        }
+    }
+}
+
+bool PlanetPackage::write(const std::string& fileName, const Description& description, const Content& content) {
+    PROFILE_SCOPE("PlanetPackage::write");
+
+    uint32_t faceSize = description.heightMapParameters.size;
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        if (content.heights[face].size() != faceSize * faceSize ||
+            content.gradients[face].size() != faceSize * faceSize * 2 ||
+            content.minMax[face].size() != content.minMax[0].size()) {
+            // TODO: replace this with logger
+            std::cerr << "PlanetPackage::write: Faces don't have the size of the description" << std::endl;
+            return false;
+        }
+    }
+
+    Header header = {};
+    std::memcpy(header.magic, packageMagic, sizeof(packageMagic));
+    header.version = version;
+    header.sectionsNb = 3;
+    header.size = description.size;
+    header.maxHeight = description.maxHeight;
+    header.faceSize = faceSize;
+    header.seed = description.heightMapParameters.seed;
+    header.noiseType = static_cast<uint32_t>(description.heightMapParameters.noiseType);
+    header.octaves = description.heightMapParameters.octaves;
+    header.frequency = description.heightMapParameters.frequency;
+    header.lacunarity = description.heightMapParameters.lacunarity;
+    header.gain = description.heightMapParameters.gain;
+    header.warpStrength = description.heightMapParameters.warpStrength;
+    header.warpOctaves = description.heightMapParameters.warpOctaves;
+
+    Section sections[3] = {
+        {SectionType::HEIGHT_MAP, Format::R32F, 0, content.heights[0].size() * sizeof(float) * CubeMap::facesNb},
+        {SectionType::GRADIENT_MAP, Format::RG16F, 0, content.gradients[0].size() * sizeof(uint16_t) * CubeMap::facesNb},
+        {SectionType::MIN_MAX, Format::RG32F, 0, content.minMax[0].size() * sizeof(glm::vec2) * CubeMap::facesNb}
+    };
+
+    uint64_t offset = sizeof(Header) + sizeof(sections);
+    for (Section& section: sections) {
+        section.offset = alignOffset(offset);
+        offset = section.offset + section.size;
+    }
+
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "PlanetPackage::write: Can't open \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(sections), sizeof(sections));
+
+    auto writeSection = [&file](const Section& section, const auto& faces, size_t texelSize) {
+        // Padding up to the aligned offset
+        std::vector<char> padding(section.offset - static_cast<uint64_t>(file.tellp()), 0);
+        file.write(padding.data(), padding.size());
+
+        for (const auto& face: faces) {
+            file.write(reinterpret_cast<const char*>(face.data()), face.size() * texelSize);
+        }
+    };
+
+    writeSection(sections[0], content.heights, sizeof(float));
+    writeSection(sections[1], content.gradients, sizeof(uint16_t));
+    writeSection(sections[2], content.minMax, sizeof(glm::vec2));
+
+    if (!file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "PlanetPackage::write: Failed to write \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+const PlanetPackage::Description& PlanetPackage::getDescription() const {
+    return _description;
+}
+
+uint32_t PlanetPackage::getFaceSize() const {
+    return _faceSize;
+}
+
+const float* PlanetPackage::getHeights(CubeMap::Face face) const {
+    return _heights + static_cast<size_t>(face) * _faceSize * _faceSize;
+}
+
+const uint16_t* PlanetPackage::getGradients(CubeMap::Face face) const {
+    return _gradients + static_cast<size_t>(face) * _faceSize * _faceSize * 2;
+}
+
+uint32_t PlanetPackage::getMinMaxLevelsNb() const {
+    return static_cast<uint32_t>(_minMaxSizes.size());
+}
+
+uint32_t PlanetPackage::getMinMaxSize(uint32_t level) const {
+    return _minMaxSizes[level];
+}
+
+const glm::vec2* PlanetPackage::getMinMax(CubeMap::Face face, uint32_t level) const {
+    return _minMax + static_cast<size_t>(face) * _minMaxFaceSize + _minMaxOffsets[level];
+}
+
+bool PlanetPackage::init(const std::string& fileName) {
+    PROFILE_SCOPE("PlanetPackage::init");
+
+    _file = System::MappedFile::create(fileName);
+    if (_file == nullptr) {
+        return false;
+    }
+
+    const char* data = static_cast<const char*>(_file->getData());
+    size_t fileSize = _file->getSize();
+
+    if (fileSize < sizeof(Header)) {
+        // TODO: replace this with logger
+        std::cerr << "PlanetPackage::init: \"" << fileName << "\" is not a planet package" << std::endl;
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, data, sizeof(Header));
+
+    if (std::memcmp(header.magic, packageMagic, sizeof(packageMagic)) != 0) {
+        // TODO: replace this with logger
+        std::cerr << "PlanetPackage::init: \"" << fileName << "\" is not a planet package" << std::endl;
+        return false;
+    }
+    if (header.version != version) {
+        // TODO: replace this with logger
+        std::cerr << "PlanetPackage::init: \"" << fileName << "\" has version " << header.version;
+        std::cerr << ", version " << version << " is expected, bake it again" << std::endl;
+        return false;
+    }
+    if (header.faceSize == 0 || fileSize < sizeof(Header) + header.sectionsNb * sizeof(Section)) {
+        // TODO: replace this with logger
+        std::cerr << "PlanetPackage::init: \"" << fileName << "\" is truncated" << std::endl;
+        return false;
+    }
+
+    _faceSize = header.faceSize;
+    _description.size = header.size;
+    _description.maxHeight = header.maxHeight;
+    _description.heightMapParameters.seed = header.seed;
+    _description.heightMapParameters.size = header.faceSize;
+    _description.heightMapParameters.noiseType = static_cast<HeightMapGenerator::NoiseType>(header.noiseType);
+    _description.heightMapParameters.octaves = header.octaves;
+    _description.heightMapParameters.frequency = header.frequency;
+    _description.heightMapParameters.lacunarity = header.lacunarity;
+    _description.heightMapParameters.gain = header.gain;
+    _description.heightMapParameters.warpStrength = header.warpStrength;
+    _description.heightMapParameters.warpOctaves = header.warpOctaves;
+
+    _minMaxSizes = HeightMipChain::getSizes(_faceSize);
+    _minMaxOffsets.assign(_minMaxSizes.size(), 0);
+    for (uint32_t level = 1; level < _minMaxSizes.size(); ++level) {
+        _minMaxOffsets[level] = _minMaxFaceSize;
+        _minMaxFaceSize += _minMaxSizes[level] * _minMaxSizes[level];
+    }
+
+    uint64_t texelsNb = static_cast<uint64_t>(_faceSize) * _faceSize * CubeMap::facesNb;
+
+    for (uint32_t i = 0; i < header.sectionsNb; ++i) {
+        Section section;
+        std::memcpy(&section, data + sizeof(Header) + i * sizeof(Section), sizeof(Section));
+
+        if (section.offset % sectionAlignment != 0 || section.offset > fileSize || section.size > fileSize - section.offset) {
+            // TODO: replace this with logger
+            std::cerr << "PlanetPackage::init: \"" << fileName << "\" has an invalid section" << std::endl;
+            return false;
+        }
+
+        const char* sectionData = data + section.offset;
+        if (section.type == SectionType::HEIGHT_MAP && section.format == Format::R32F &&
+            section.size == texelsNb * sizeof(float)) {
+            _heights = reinterpret_cast<const float*>(sectionData);
+        }
+        else if (section.type == SectionType::GRADIENT_MAP && section.format == Format::RG16F &&
+            section.size == texelsNb * 2 * sizeof(uint16_t)) {
+            _gradients = reinterpret_cast<const uint16_t*>(sectionData);
+        }
+        else if (section.type == SectionType::MIN_MAX && section.format == Format::RG32F &&
+            section.size == _minMaxFaceSize * sizeof(glm::vec2) * CubeMap::facesNb) {
+            _minMax = reinterpret_cast<const glm::vec2*>(sectionData);
+        }
+        // Unknown sections are ignored, so sections can be added without changing the version
+    }
+
+    if (_heights == nullptr || _gradients == nullptr || _minMax == nullptr) {
+        // TODO: replace this with logger
+        std::cerr << "PlanetPackage::init: \"" << fileName << "\" misses a section or has an unsupported format" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+} // Namespace Core
@@ -1,6 +1,10 @@
+#include <algorithm> // std::min, std::max
+#include <cmath> // std::abs
 #include <iostream>
+#include <limits> // std::numeric_limits
 
 #include <Core/SphereQuadTree.hpp> // Graphics::Core::SphereQuadTree
+#include <System/Profiler.hpp> // PROFILE_SCOPE
 
 #include <Core/QuadTree.hpp> // Graphics::Core::QuadTree
 
@@ -40,27 +44,121 @@ QuadTree::QuadTree(
     calculateShapeAABB();
 }
 
-void QuadTree::update(Graphics::Camera& camera) {
-    if (isOccludedByHorizon(camera) || !isInsideFrustum(camera)) {
+uint32_t QuadTree::update(Graphics::Camera& camera) {
+    PROFILE_SCOPE("QuadTree::update");
+
+    const CameraMotion& motion = _planet.getCameraMotion();
+
+    // The camera didn't move enough to change the decisions of the quadtree and its children
+    if (_planet.isCoherentUpdate() && getRemainingMargin(motion) > 0.0f) {
+        requestHeightTiles();
+        return 0;
+    }
+
+    _coherence.motion = motion;
+    _coherence.reach = getReach(camera);
+
+    float horizonMargin = 0.0f;
+    float frustumMargin = 0.0f;
+    bool occluded = isOccludedByHorizon(camera.getPos(), horizonMargin);
+
+    if (occluded || !isInsideFrustum(camera, frustumMargin)) {
+        _visible = false;
+        _coherence.margin = occluded ? horizonMargin : frustumMargin;
+
         if (_split) {
             merge();
         }
-        return;
+        return 1;
     }
 
-    if (needSplit(camera)) {
-        split();
+    _visible = true;
+    requestHeightTile();
+
+    float distance = glm::distance(camera.getPos() / _planet.getSize(), _center);
+    // Refused by the budget, the next updates evaluate the quadtree again until it's split
+    bool deferred = false;
+
+    if (needSplit(distance)) {
+        deferred = !split(distance / _planet.getSplitDistance(_level));
     }
-    else if (needMerge(camera)) {
+    else if (needMerge(distance)) {
         merge();
     }
 
+    if (deferred) {
+        _planet.addDeferredSplit();
+    }
+
+    uint32_t evaluatedNodesNb = 1;
+    float margin = deferred ? 0.0f : std::min({horizonMargin, frustumMargin, getSplitMargin(distance)});
+    float reach = _coherence.reach;
+
     if (_split) {
-        _children.topLeft->update(camera);
-        _children.topRight->update(camera);
-        _children.bottomLeft->update(camera);
-        _children.bottomRight->update(camera);
+        for (QuadTree* child: {_children.topLeft.get(), _children.topRight.get(), _children.bottomLeft.get(), _children.bottomRight.get()}) {
+            evaluatedNodesNb += child->update(camera);
+
+            margin = std::min(margin, child->getRemainingMargin(motion));
+            reach = std::max(reach, child->getCurrentReach(motion));
+        }
     }
+
+    _coherence.margin = margin;
+    _coherence.reach = reach;
+
+    return evaluatedNodesNb;
+}
+
+void QuadTree::prefetch(const glm::vec3& cameraPos, const glm::vec3& predictedPos) {
+    if (_split) {
+        _children.topLeft->prefetch(cameraPos, predictedPos);
+        _children.topRight->prefetch(cameraPos, predictedPos);
+        _children.bottomLeft->prefetch(cameraPos, predictedPos);
+        _children.bottomRight->prefetch(cameraPos, predictedPos);
+        return;
+    }
+
+    // Nearest point of the predicted path, in planet size units
+    glm::vec3 start = cameraPos / _planet.getSize();
+    glm::vec3 path = predictedPos / _planet.getSize() - start;
+    float progress = glm::dot(_center - start, path) / glm::dot(path, path);
+
+    float distance = glm::distance(start + path * std::min(progress, 1.0f), _center);
+    float margin = 0.0f;
+
+    // The camera moves away from the leaf, or won't see it
+    if (progress <= 0.0f || isOccludedByHorizon(predictedPos, margin)) {
+        releasePrefetchedChildren();
+        return;
+    }
+
+    // The leaves rising over the horizon are not requested yet
+    prefetchHeightTile();
+
+    if (!needSplit(distance)) {
+        releasePrefetchedChildren();
+        return;
+    }
+
+    if (_prefetchedChildren == nullptr) {
+        if (!_planet.reservePrefetchedNodes(4)) {
+            return;
+        }
+
+        // The prefetch has a lower priority than all the splits, it can't take the budget they need
+        std::unique_ptr<Children> children = std::make_unique<Children>();
+        if (!createChildren(*children, 2.0f)) {
+            _planet.releasePrefetchedNodes(4);
+            return;
+        }
+
+        _prefetchedChildren = std::move(children);
+    }
+
+    _prefetchedChildren->topLeft->prefetch(cameraPos, predictedPos);
+    _prefetchedChildren->topRight->prefetch(cameraPos, predictedPos);
+    _prefetchedChildren->bottomLeft->prefetch(cameraPos, predictedPos);
+    _prefetchedChildren->bottomRight->prefetch(cameraPos, predictedPos);
 }
 
 void QuadTree::updateNeighBors() {
@@ -296,7 +394,45 @@ void QuadTree::setNeighbor(Face fromFace, NeighborOrientation neighborOrientatio
 
 }
 
+uint32_t QuadTree::getNodesNb() const {
+    if (!_split) {
+        return 1;
+    }
+
+    return 1 +
+        _children.topLeft->getNodesNb() +
+        _children.topRight->getNodesNb() +
+        _children.bottomLeft->getNodesNb() +
+        _children.bottomRight->getNodesNb();
+}
+
+QuadTree::Face QuadTree::getFace() const {
+    return _face;
+}
+
+uint32_t QuadTree::getLevel() const {
+    return _level;
+}
+
+const glm::vec3& QuadTree::getCenter() const {
+    return _center;
+}
+
+void QuadTree::getSphereCorners(glm::vec3& topLeft, glm::vec3& topRight, glm::vec3& bottomLeft, glm::vec3& bottomRight) const {
+    topLeft = _corners.topLeft.spherePos;
+    topRight = _corners.topRight.spherePos;
+    bottomLeft = _corners.bottomLeft.spherePos;
+    bottomRight = _corners.bottomRight.spherePos;
+}
+
+const QuadTree* QuadTree::readChild(ChildOrientation childOrientation) const {
+    // Acquire the child constructed by split
+    return _sharedChildren[static_cast<uint8_t>(childOrientation)].load(std::memory_order_acquire);
+}
+
 void QuadTree::addChildrenVertices(System::Vector<Vertex>& vertices, System::Vector<uint32_t>& indices) {
+    PROFILE_SCOPE("QuadTree::addChildrenVertices");
+
     if (!_split) {
         return;
     }
@@ -498,15 +634,17 @@ void QuadTree::addChildrenVertices(System::Vector<Vertex>& vertices, System::Vec
 void QuadTree::addDebugVertices(System::Vector<glm::vec3>& vertices, System::Vector<uint32_t>& indices) {
     uint32_t verticesNb = static_cast<uint32_t>(vertices.size());
 
-    vertices.push_back(_shapeBox.corners.topLeft); // 0
-    vertices.push_back(_shapeBox.corners.topRight); // 1
-    vertices.push_back(_shapeBox.corners.bottomLeft); // 2
-    vertices.push_back(_shapeBox.corners.bottomRight); // 3
+    float planetSize = _planet.getSize();
+    vertices.push_back(_shapeBox.corners.topLeft * planetSize); // 0
+    vertices.push_back(_shapeBox.corners.topRight * planetSize); // 1
+    vertices.push_back(_shapeBox.corners.bottomLeft * planetSize); // 2
+    vertices.push_back(_shapeBox.corners.bottomRight * planetSize); // 3
 
-    vertices.push_back(_shapeBox.cornersUp.topLeft); // 4
-    vertices.push_back(_shapeBox.cornersUp.topRight); // 5
-    vertices.push_back(_shapeBox.cornersUp.bottomLeft); // 6
-    vertices.push_back(_shapeBox.cornersUp.bottomRight); // 7
+    glm::vec3 extrusion = getHeightExtrusion();
+    vertices.push_back(_shapeBox.cornersUp.topLeft * planetSize + extrusion); // 4
+    vertices.push_back(_shapeBox.cornersUp.topRight * planetSize + extrusion); // 5
+    vertices.push_back(_shapeBox.cornersUp.bottomLeft * planetSize + extrusion); // 6
+    vertices.push_back(_shapeBox.cornersUp.bottomRight * planetSize + extrusion); // 7
 
     // Front
     {
@@ -575,26 +713,56 @@ void QuadTree::addDebugVertices(System::Vector<glm::vec3>& vertices, System::Vec
     }
 }
 
-void QuadTree::updateShapeAABB() {
-    calculateShapeAABB();
+// The cube of the quadtrees is centered on the planet
+static glm::vec3 getNormalizedCubeCoord(glm::vec3 cubeCoord) {
+    return normalize(cubeCoord);
+}
+
+void QuadTree::requestHeightTiles() const {
+    if (!_visible || _planet.getVirtualHeightMap() == nullptr) {
+        return;
+    }
+
+    requestHeightTile();
 
     if (_split) {
-        _children.topLeft->updateShapeAABB();
-        _children.topRight->updateShapeAABB();
-        _children.bottomLeft->updateShapeAABB();
-        _children.bottomRight->updateShapeAABB();
+        _children.topLeft->requestHeightTiles();
+        _children.topRight->requestHeightTiles();
+        _children.bottomLeft->requestHeightTiles();
+        _children.bottomRight->requestHeightTiles();
+    }
+}
+
+void QuadTree::requestHeightTile() const {
+    VirtualHeightMap* virtualHeightMap = _planet.getVirtualHeightMap();
+    if (virtualHeightMap == nullptr) {
+        return;
     }
+
+    // The quadtree covers exactly one tile of its level, the cube map is sampled with the cube position
+    glm::vec3 cubeCenter = _pos + (_widthDir + _heightDir) * (_size / 2.0f);
+    glm::vec3 direction = getNormalizedCubeCoord(cubeCenter);
+
+    virtualHeightMap->request(virtualHeightMap->getTile(direction, _level));
 }
 
-static glm::vec3 getNormalizedCubeCoord(glm::vec3 worldCubeCoord, float planetSize) {
-    return normalize((worldCubeCoord + (planetSize / 2.0f)) / planetSize * 2.0f - 1.0f);
+void QuadTree::prefetchHeightTile() const {
+    VirtualHeightMap* virtualHeightMap = _planet.getVirtualHeightMap();
+    if (virtualHeightMap == nullptr) {
+        return;
+    }
+
+    glm::vec3 cubeCenter = _pos + (_widthDir + _heightDir) * (_size / 2.0f);
+    glm::vec3 direction = getNormalizedCubeCoord(cubeCenter);
+
+    virtualHeightMap->prefetch(virtualHeightMap->getTile(direction, _level));
 }
 
 // Formulas: http://mathproofs.blogspot.kr/2005/07/mapping-cube-to-sphere.html
 glm::vec3 QuadTree::calculateSpherePos(const glm::vec3& cubePos) {
     // Map cube position [-1.0, 1.0] to sphere position [-1.0, 1.0]
-    // and scale [-1.0, 1.0] sphere position to planet scale
-    glm::vec3 pos = getNormalizedCubeCoord(cubePos, _planet.getSize());
+    // The planet size is applied when the positions are used
+    glm::vec3 pos = getNormalizedCubeCoord(cubePos);
 
     float x2 = pos.x * pos.x;
     float y2 = pos.y * pos.y;
@@ -604,7 +772,7 @@ glm::vec3 QuadTree::calculateSpherePos(const glm::vec3& cubePos) {
     pos.y = pos.y * sqrt(1.0f - (z2 * 0.5f) - (x2 * 0.5f) + ((z2 * x2) / 3.0f));
     pos.z = pos.z * sqrt(1.0f - (x2 * 0.5f) - (y2 * 0.5f) + ((x2 * y2) / 3.0f));
 
-    return normalize(pos) * _planet.getSize();
+    return normalize(pos);
 }
 
 void QuadTree::calculateShapeAABB() {
@@ -654,28 +822,80 @@ void QuadTree::calculateShapeAABB() {
         _shapeBox.cornersUp.bottomRight = _shapeBox.corners.bottomRight + bendingDir;
     }
 
-    // Add max heightmap height to the AABB box upper corners
-    {
-        _shapeBox.cornersUp.topLeft += _normal * _planet.getMaxHeight();
-        _shapeBox.cornersUp.topRight += _normal * _planet.getMaxHeight();
-        _shapeBox.cornersUp.bottomLeft += _normal * _planet.getMaxHeight();
-        _shapeBox.cornersUp.bottomRight += _normal * _planet.getMaxHeight();
-    }
-
+    _shapeBox.center = (_shapeBox.corners.topLeft + _shapeBox.corners.topRight + _shapeBox.corners.bottomLeft + _shapeBox.corners.bottomRight +
+        _shapeBox.cornersUp.topLeft + _shapeBox.cornersUp.topRight + _shapeBox.cornersUp.bottomLeft + _shapeBox.cornersUp.bottomRight) / 8.0f;
+    _shapeBox.radius = std::max({
+        glm::distance(_shapeBox.corners.topLeft, _shapeBox.center),
+        glm::distance(_shapeBox.corners.topRight, _shapeBox.center),
+        glm::distance(_shapeBox.corners.bottomLeft, _shapeBox.center),
+        glm::distance(_shapeBox.corners.bottomRight, _shapeBox.center),
+        glm::distance(_shapeBox.cornersUp.topLeft, _shapeBox.center),
+        glm::distance(_shapeBox.cornersUp.topRight, _shapeBox.center),
+        glm::distance(_shapeBox.cornersUp.bottomLeft, _shapeBox.center),
+        glm::distance(_shapeBox.cornersUp.bottomRight, _shapeBox.center)
+    });
 }
 
-bool QuadTree::needSplit(const Graphics::Camera& camera) {
-    float distance = glm::distance(camera.getPos(), _center);
+glm::vec3 QuadTree::getHeightExtrusion() const {
+    return _normal * _planet.getMaxHeight();
+}
 
+bool QuadTree::needSplit(float distance) {
     return !_split &&
     _level < _planet.getLevelsTable().size() &&
-    distance < _planet.getLevelsTable()[_level];
+    distance < _planet.getSplitDistance(_level);
 }
 
-void QuadTree::split() {
+bool QuadTree::split(float priority) {
+    PROFILE_SCOPE("QuadTree::split");
+
+    if (!_planet.reserveSplit(priority)) {
+        return false;
+    }
+
+    bool prefetched = _prefetchedChildren != nullptr;
+
+    if (prefetched) {
+        _children = std::move(*_prefetchedChildren);
+        _prefetchedChildren = nullptr;
+        _planet.releasePrefetchedNodes(4);
+    }
+    else if (!createChildren(_children, priority)) {
+        _planet.releaseSplit();
+        return false;
+    }
+
+    _planet.addSplit(prefetched);
+
+    _split = true;
+
+    updateNeighBors();
+
+    _sharedChildren[static_cast<uint8_t>(ChildOrientation::TOP_LEFT)].store(_children.topLeft.get(), std::memory_order_release);
+    _sharedChildren[static_cast<uint8_t>(ChildOrientation::TOP_RIGHT)].store(_children.topRight.get(), std::memory_order_release);
+    _sharedChildren[static_cast<uint8_t>(ChildOrientation::BOTTOM_RIGHT)].store(_children.bottomRight.get(), std::memory_order_release);
+    _sharedChildren[static_cast<uint8_t>(ChildOrientation::BOTTOM_LEFT)].store(_children.bottomLeft.get(), std::memory_order_release);
+
+    return true;
+}
+
+bool QuadTree::createChildren(Children& children, float priority) const {
+    // The children of a merge at the same place are reattached instead of generated again
+    if (_planet.takeCachedChildren(getKey(), children)) {
+        children.topLeft->reattach();
+        children.topRight->reattach();
+        children.bottomLeft->reattach();
+        children.bottomRight->reattach();
+        return true;
+    }
+
+    if (!_planet.reserveNodes(4, priority)) {
+        return false;
+    }
+
     float childrenSize = _size / 2;
 
-    _children.topLeft = std::make_unique<QuadTree>(
+    children.topLeft = std::make_unique<QuadTree>(
         _planet,
         _face,
         _level + 1,
@@ -685,7 +905,7 @@ void QuadTree::split() {
         _heightDir,
         _normal
         );
-    _children.topRight = std::make_unique<QuadTree>(
+    children.topRight = std::make_unique<QuadTree>(
         _planet,
         _face,
         _level + 1,
@@ -695,7 +915,7 @@ void QuadTree::split() {
         _heightDir,
         _normal
         );
-    _children.bottomLeft = std::make_unique<QuadTree>(
+    children.bottomLeft = std::make_unique<QuadTree>(
         _planet,
         _face,
         _level + 1,
@@ -705,7 +925,7 @@ void QuadTree::split() {
         _heightDir,
         _normal
         );
-    _children.bottomRight = std::make_unique<QuadTree>(
+    children.bottomRight = std::make_unique<QuadTree>(
         _planet,
         _face,
         _level + 1,
@@ -716,20 +936,43 @@ void QuadTree::split() {
         _normal
         );
 
-    _split = true;
-
-    updateNeighBors();
+    return true;
 }
 
-bool QuadTree::needMerge(const Graphics::Camera& camera) {
-    float distance = glm::distance(camera.getPos(), _center);
+void QuadTree::releasePrefetchedChildren() {
+    // The split quadtrees used their prefetched children
+    if (_split) {
+        _children.topLeft->releasePrefetchedChildren();
+        _children.topRight->releasePrefetchedChildren();
+        _children.bottomLeft->releasePrefetchedChildren();
+        _children.bottomRight->releasePrefetchedChildren();
+        return;
+    }
+
+    if (_prefetchedChildren == nullptr) {
+        return;
+    }
+
+    _prefetchedChildren->topLeft->releasePrefetchedChildren();
+    _prefetchedChildren->topRight->releasePrefetchedChildren();
+    _prefetchedChildren->bottomLeft->releasePrefetchedChildren();
+    _prefetchedChildren->bottomRight->releasePrefetchedChildren();
+
+    // The children taken from the nodes cache were split before, other threads may still read them
+    std::unique_ptr<Children> children = std::move(_prefetchedChildren);
+    _planet.releasePrefetchedNodes(4);
+    _planet.retireChildren(std::move(*children));
+}
 
+bool QuadTree::needMerge(float distance) {
     return _split &&
     _level >= 0 &&
-    distance > _planet.getLevelsTable()[_level];
+    distance > _planet.getSplitDistance(_level);
 }
 
 void QuadTree::merge() {
+    PROFILE_SCOPE("QuadTree::merge");
+
     if (_children.topLeft->_split) {
         _children.topLeft->merge();
     }
@@ -745,44 +988,110 @@ void QuadTree::merge() {
 
 
     _split = false;
+    _planet.releaseSplit();
 
     updateNeighBors();
 
-    _children.topLeft = nullptr;
-    _children.topRight = nullptr;
-    _children.bottomLeft = nullptr;
-    _children.bottomRight = nullptr;
+    // Only the update thread reads the prefetched children
+    _children.topLeft->releasePrefetchedChildren();
+    _children.topRight->releasePrefetchedChildren();
+    _children.bottomLeft->releasePrefetchedChildren();
+    _children.bottomRight->releasePrefetchedChildren();
+
+    // Other threads may still read the children, they are deleted once the readers are gone
+    for (auto& child: _sharedChildren) {
+        child.store(nullptr, std::memory_order_relaxed);
+    }
+
+    // Their merged children are already cached with their own key, so a next split can reattach the whole subtree
+    _planet.cacheChildren(getKey(), std::move(_children));
+}
+
+void QuadTree::reattach() {
+    // The neighbors may have been deleted since the quadtree was merged, split links the new ones
+    _neighbors = Neighbors();
+    _visible = false;
+    _coherence = Coherence();
+}
+
+uint64_t QuadTree::getKey() const {
+    // The quadtrees of a face are in [-0.5, 0.5] on the width and height directions, _size is 1 / 2^level
+    uint64_t x = static_cast<uint64_t>((glm::dot(_pos, _widthDir) + 0.5f) / _size + 0.5f);
+    uint64_t y = static_cast<uint64_t>((glm::dot(_pos, _heightDir) + 0.5f) / _size + 0.5f);
+
+    return static_cast<uint64_t>(_face) << 56 | static_cast<uint64_t>(_level) << 48 | y << 24 | x;
 }
 
-bool QuadTree::isInsideFrustum(Graphics::Camera& camera) const {
+bool QuadTree::isInsideFrustum(Graphics::Camera& camera, float& margin) const {
+    float planetSize = _planet.getSize();
+    glm::vec3 extrusion = getHeightExtrusion();
+
     return camera.getFrustum().isAABBInside(
-        _shapeBox.corners.topLeft,
-        _shapeBox.corners.topRight,
-        _shapeBox.corners.bottomLeft,
-        _shapeBox.corners.bottomRight,
-        _shapeBox.cornersUp.topLeft,
-        _shapeBox.cornersUp.topRight,
-        _shapeBox.cornersUp.bottomLeft,
-        _shapeBox.cornersUp.bottomRight
+        _shapeBox.corners.topLeft * planetSize,
+        _shapeBox.corners.topRight * planetSize,
+        _shapeBox.corners.bottomLeft * planetSize,
+        _shapeBox.corners.bottomRight * planetSize,
+        _shapeBox.cornersUp.topLeft * planetSize + extrusion,
+        _shapeBox.cornersUp.topRight * planetSize + extrusion,
+        _shapeBox.cornersUp.bottomLeft * planetSize + extrusion,
+        _shapeBox.cornersUp.bottomRight * planetSize + extrusion,
+        margin
     );
 }
 
-bool isBeyondHorizon(const glm::vec3& viewPos, const glm::vec3& planetCenterDir, const glm::vec3& point) {
-    glm::vec3 targetDir = point - viewPos;
-    float magnitudeSquared = pow(planetCenterDir.x, 2) + pow(planetCenterDir.y, 2) + pow(planetCenterDir.z, 2);
+bool QuadTree::isOccludedByHorizon(const glm::vec3& cameraPos, float& margin) const {
+    // A corner is beyond the horizon while dot(corner, cameraPos) < planetHalfSize²,
+    // the distance from the camera to this plane is the margin of the corner
+    float planetSize = _planet.getSize();
+    float planetHalfSize = planetSize / 2.0f;
+    float horizon = planetHalfSize * planetHalfSize;
+    glm::vec3 extrusion = getHeightExtrusion();
+
+    float topLeft = glm::dot(_shapeBox.cornersUp.topLeft * planetSize + extrusion, cameraPos) - horizon;
+    float topRight = glm::dot(_shapeBox.cornersUp.topRight * planetSize + extrusion, cameraPos) - horizon;
+    float bottomLeft = glm::dot(_shapeBox.cornersUp.bottomLeft * planetSize + extrusion, cameraPos) - horizon;
+    float bottomRight = glm::dot(_shapeBox.cornersUp.bottomRight * planetSize + extrusion, cameraPos) - horizon;
+
+    // Occluded until a corner is visible, visible until all the corners are occluded
+    float nearest = std::max({topLeft, topRight, bottomLeft, bottomRight});
+    bool occluded = nearest < 0.0f;
+
+    // The distance to the plane of a corner is its dot divided by its length, bounded by the AABB box
+    float cornersLength = (glm::length(_shapeBox.center) + _shapeBox.radius) * planetSize + std::abs(_planet.getMaxHeight());
+    margin = std::abs(nearest) / cornersLength;
+
+    return occluded;
+}
+
+float QuadTree::getSplitMargin(float distance) const {
+    if (_level >= _planet.getLevelsTable().size()) {
+        return std::numeric_limits<float>::max();
+    }
+
+    return std::abs(distance - _planet.getSplitDistance(_level)) * _planet.getSize();
+}
+
+float QuadTree::getReach(const Graphics::Camera& camera) const {
+    // The extrusion moves the upper corners by the max height at most
+    float planetSize = _planet.getSize();
 
-    return glm::dot(targetDir, planetCenterDir) > magnitudeSquared - 1.0f;
+    return glm::distance(_shapeBox.center * planetSize, camera.getPos()) + _shapeBox.radius * planetSize + std::abs(_planet.getMaxHeight());
 }
 
-bool QuadTree::isOccludedByHorizon(const Graphics::Camera& camera) const {
-    float planetHalfSize = _planet.getSize() / 2.0f;
-    glm::vec3 viewPos = camera.getPos() / planetHalfSize;
-    glm::vec3 planetCenterDir = -viewPos;
+float QuadTree::getRemainingMargin(const CameraMotion& motion) const {
+    float translation = static_cast<float>(motion.translation - _coherence.motion.translation);
+    float rotation = static_cast<float>(motion.rotation - _coherence.motion.rotation);
+    float lodScale = static_cast<float>(motion.lodScale - _coherence.motion.lodScale);
+
+    // The split distances decrease with the level, the one of the quadtree bounds the moves of its children ones
+    const LevelsTable& levelsTable = _planet.getLevelsTable();
+    float splitDistanceMotion = _level < levelsTable.size() ? lodScale * levelsTable[_level] * _planet.getSize() : 0.0f;
+
+    return _coherence.margin - (translation + rotation * (_coherence.reach + translation)) - splitDistanceMotion;
+}
 
-    return isBeyondHorizon(viewPos, planetCenterDir, _shapeBox.cornersUp.topLeft / planetHalfSize) &&
-    isBeyondHorizon(viewPos, planetCenterDir, _shapeBox.cornersUp.topRight / planetHalfSize) &&
-    isBeyondHorizon(viewPos, planetCenterDir, _shapeBox.cornersUp.bottomLeft / planetHalfSize) &&
-    isBeyondHorizon(viewPos, planetCenterDir, _shapeBox.cornersUp.bottomRight / planetHalfSize);
+float QuadTree::getCurrentReach(const CameraMotion& motion) const {
+    return _coherence.reach + static_cast<float>(motion.translation - _coherence.motion.translation);
 }
 
 } // Namespace Core
@@ -1,160 +1,119 @@
-#include <iostream> // std::cerr
+#include <algorithm> // std::min, std::max
+#include <cmath> // std::abs, std::sqrt
 
-#include <Graphics/API/Builder/Buffer.hpp> // Graphics::API::Builder::Buffer
-#include <Graphics/API/Builder/Texture.hpp> // Graphics::API::Builder::Texture
-#include <Graphics/Renderer.hpp> // Graphics::Renderer
-#include <System/Vector.hpp> // System::Vector
+#include <glm/geometric.hpp> // glm::length
+
+#include <System/Profiler.hpp> // PROFILE_SCOPE
 
 #include <Core/SphereQuadTree.hpp> // Graphics::Core::SphereQuadTree
 
 namespace Core {
 
-SphereQuadTree::SphereQuadTree(float size, float maxHeight): _size(size), _maxHeight(maxHeight) {}
-
-SphereQuadTree::SphereQuadTree(SphereQuadTree&& quadTree) {
-    if (quadTree._leftQuadTree != nullptr) {
-        _leftQuadTree = std::move(quadTree._leftQuadTree);
-    }
-    if (quadTree._rightQuadTree != nullptr) {
-        _rightQuadTree = std::move(quadTree._rightQuadTree);
-    }
-    if (quadTree._frontQuadTree != nullptr) {
-        _frontQuadTree = std::move(quadTree._frontQuadTree);
-    }
-    if (quadTree._backQuadTree != nullptr) {
-        _backQuadTree = std::move(quadTree._backQuadTree);
-    }
-    if (quadTree._topQuadTree != nullptr) {
-        _topQuadTree = std::move(quadTree._topQuadTree);
-    }
-    if (quadTree._bottomQuadTree != nullptr) {
-        _bottomQuadTree = std::move(quadTree._bottomQuadTree);
-    }
-
-    _buffer = std::move(quadTree._buffer);
-    _levelsTable = quadTree._levelsTable;
-    _maxHeight = quadTree._maxHeight;
-    _heightMap = std::move(quadTree._heightMap);
-    _normalMap = std::move(quadTree._normalMap);
+// Weight of the last update in the camera velocity
+static const float velocitySmoothing = 0.25f;
+// The camera is still if it moves less during the lookahead, in planet size units
+static const float minPrefetchDistance = 0.01f;
+// Bytes of the merged quadtrees kept by default
+static const size_t defaultNodesCacheSize = 1024 * 1024;
+// Part of the budget only the nearest splits can use, so the farthest ones are refused first
+static const float splitReserve = 0.1f;
+// A split quadtree emits 4 vertices and up to 3 triangles per child (see QuadTree::addChildrenVertices)
+static const uint64_t splitVerticesSize = 16 * sizeof(QuadTree::Vertex) + 36 * sizeof(uint32_t);
+// The budget scale decreases on each update deferring splits,
+// and increases back after budgetRecoveryUpdatesNb updates without any
+static const float minBudgetScale = 0.1f;
+static const float budgetScaleDecrease = 0.95f;
+static const float budgetScaleIncrease = 1.02f;
+static const uint32_t budgetRecoveryUpdatesNb = 30;
+
+static float getBudgetFraction(float priority) {
+    return 1.0f - splitReserve * std::min(std::max(priority, 0.0f), 2.0f);
 }
 
-SphereQuadTree& SphereQuadTree::operator=(SphereQuadTree&& quadTree) {
-    if (quadTree._leftQuadTree != nullptr) {
-        _leftQuadTree = std::move(quadTree._leftQuadTree);
-    }
-    if (quadTree._rightQuadTree != nullptr) {
-        _rightQuadTree = std::move(quadTree._rightQuadTree);
-    }
-    if (quadTree._frontQuadTree != nullptr) {
-        _frontQuadTree = std::move(quadTree._frontQuadTree);
-    }
-    if (quadTree._backQuadTree != nullptr) {
-        _backQuadTree = std::move(quadTree._backQuadTree);
-    }
-    if (quadTree._topQuadTree != nullptr) {
-        _topQuadTree = std::move(quadTree._topQuadTree);
-    }
-    if (quadTree._bottomQuadTree != nullptr) {
-        _bottomQuadTree = std::move(quadTree._bottomQuadTree);
-    }
-
-    _buffer = std::move(quadTree._buffer);
-    _levelsTable = quadTree._levelsTable;
-    _maxHeight = quadTree._maxHeight;
-    _heightMap = std::move(quadTree._heightMap);
-    _normalMap = std::move(quadTree._normalMap);
-
-    return *this;
+// The tiles are R16 (see Graphics::Planet::initVirtualHeightMap)
+static uint64_t getTileSlotSize(const VirtualHeightMap& virtualHeightMap) {
+    return static_cast<uint64_t>(virtualHeightMap.getSlotSize()) * virtualHeightMap.getSlotSize() * sizeof(uint16_t);
 }
 
-std::unique_ptr<SphereQuadTree> SphereQuadTree::create(const Graphics::Renderer* renderer, float size, float maxHeight) {
+SphereQuadTree::SphereQuadTree(float size, float maxHeight): _size(size), _maxHeight(maxHeight) {}
+
+std::unique_ptr<SphereQuadTree> SphereQuadTree::create(float size, float maxHeight) {
     // Don't use std::make_unique because the constructor is private
     std::unique_ptr<SphereQuadTree> sphereQuadTree(new SphereQuadTree(size, maxHeight));
 
-    if (!sphereQuadTree->init(renderer)) {
+    if (!sphereQuadTree->init()) {
         return nullptr;
     }
 
     return sphereQuadTree;
 }
 
+std::unique_ptr<SphereQuadTree> SphereQuadTree::create(std::shared_ptr<const PlanetPackage> package) {
+    const auto& description = package->getDescription();
+
+    std::unique_ptr<SphereQuadTree> sphereQuadTree = create(description.size, description.maxHeight);
+    if (sphereQuadTree != nullptr) {
+        sphereQuadTree->_package = std::move(package);
+    }
+
+    return sphereQuadTree;
+}
+
 void SphereQuadTree::update(Graphics::Camera& camera) {
-    // Add the quadtrees vertices to the SphereQuadTree buffer
-    {
-        uint32_t chunkSize = 500;
-        uint32_t verticesNb = _buffer.getVerticesNb() ? _buffer.getVerticesNb() : chunkSize;
-        uint32_t indicesNb = _buffer.getIndicesNb() ? _buffer.getIndicesNb() : chunkSize;
+    PROFILE_SCOPE("SphereQuadTree::update");
 
-        // Create indices and vertices buffers with chunks of 500
-        // (resize is perform only every 500 vertices/indices added in the vector)
-        // We also init the vector with the previous frame size to reduce the resizes
-        System::Vector<QuadTree::Vertex> vertices(chunkSize, verticesNb + chunkSize);
-        System::Vector<uint32_t> indices(chunkSize, indicesNb + chunkSize);
+    updateQuadTrees(camera);
+    updateMeshes();
+}
 
-        _leftQuadTree->update(camera);
-        _leftQuadTree->addChildrenVertices(vertices, indices);
+void SphereQuadTree::update(Graphics::Camera& camera, Snapshot& snapshot) {
+    PROFILE_SCOPE("SphereQuadTree::update");
 
-        _rightQuadTree->update(camera);
-        _rightQuadTree->addChildrenVertices(vertices, indices);
+    updateQuadTrees(camera);
 
-        _frontQuadTree->update(camera);
-        _frontQuadTree->addChildrenVertices(vertices, indices);
+    {
+        PROFILE_SCOPE("SphereQuadTree::updateMeshes");
 
-        _backQuadTree->update(camera);
-        _backQuadTree->addChildrenVertices(vertices, indices);
+        updateMesh(snapshot.mesh);
+        updateDebugMesh(snapshot.debugMesh);
+    }
+
+    if (_virtualHeightMap != nullptr) {
+        _virtualHeightMap->addUploads(snapshot.heightTiles);
+    }
+}
 
-        _topQuadTree->update(camera);
-        _topQuadTree->addChildrenVertices(vertices, indices);
+void SphereQuadTree::updateQuadTrees(Graphics::Camera& camera) {
+    PROFILE_SCOPE("SphereQuadTree::updateQuadTrees");
 
+    updateBudgetScale();
+
+    _updateLodScale = _lodScale.load(std::memory_order_relaxed) * _budgetScale;
+    _coherentUpdate = updateCameraMotion(camera) && _temporalCoherence;
+
+    _evaluatedNodesNb = _leftQuadTree->update(camera) +
+        _rightQuadTree->update(camera) +
+        _frontQuadTree->update(camera) +
+        _backQuadTree->update(camera) +
+        _topQuadTree->update(camera) +
         _bottomQuadTree->update(camera);
-        _bottomQuadTree->addChildrenVertices(vertices, indices);
-
-        _buffer.updateVertices(
-            (char*)vertices.data(),
-            static_cast<uint32_t>(vertices.size()) * sizeof(QuadTree::Vertex),
-            static_cast<uint32_t>(vertices.size()),
-            GL_DYNAMIC_DRAW
-            );
-        _buffer.updateIndices(
-            (char*)indices.data(),
-            static_cast<uint32_t>(indices.size()) * sizeof(uint32_t),
-            static_cast<uint32_t>(indices.size()),
-            GL_DYNAMIC_DRAW
-            );
-    }
 
-    // Add the quadtrees debug aabb boxes vertices to the SphereQuadTree buffer
-    {
-        uint32_t chunkSize = 500;
-        uint32_t verticesNb = _debugBuffer.getVerticesNb() ? _debugBuffer.getVerticesNb() : chunkSize;
-        uint32_t indicesNb = _debugBuffer.getIndicesNb() ? _debugBuffer.getIndicesNb() : chunkSize;
-
-        // Create indices and vertices buffers with chunks of 500
-        // (resize is perform only every 500 vertices/indices added in the vector)
-        // We also init the vector with the previous frame size to reduce the resizes
-        System::Vector<glm::vec3> vertices(chunkSize, verticesNb + chunkSize);
-        System::Vector<uint32_t> indices(chunkSize, indicesNb + chunkSize);
-
-        _leftQuadTree->addDebugVertices(vertices, indices);
-        _rightQuadTree->addDebugVertices(vertices, indices);
-        _frontQuadTree->addDebugVertices(vertices, indices);
-        _backQuadTree->addDebugVertices(vertices, indices);
-        _topQuadTree->addDebugVertices(vertices, indices);
-        _bottomQuadTree->addDebugVertices(vertices, indices);
-
-        _debugBuffer.updateVertices(
-            (char*)vertices.data(),
-            static_cast<uint32_t>(vertices.size()) * sizeof(glm::vec3),
-            static_cast<uint32_t>(vertices.size()),
-            GL_DYNAMIC_DRAW
-            );
-        _debugBuffer.updateIndices(
-            (char*)indices.data(),
-            static_cast<uint32_t>(indices.size()) * sizeof(uint32_t),
-            static_cast<uint32_t>(indices.size()),
-            GL_DYNAMIC_DRAW
-            );
+    prefetch(camera);
+
+    // Load the tiles requested and prefetched by the quadtrees
+    if (_virtualHeightMap != nullptr) {
+        updateTilesBudget();
+        _virtualHeightMap->update();
     }
+
+    collectRetiredNodes();
+}
+
+void SphereQuadTree::updateMeshes() {
+    PROFILE_SCOPE("SphereQuadTree::updateMeshes");
+
+    updateMesh(_mesh);
+    updateDebugMesh(_debugMesh);
 }
 
 float SphereQuadTree::getSize() const {
@@ -165,71 +124,203 @@ float SphereQuadTree::getMaxHeight() const {
     return (_maxHeight);
 }
 
-const Graphics::API::Buffer& SphereQuadTree::getBuffer() const {
-    return _buffer;
+const QuadTree::LevelsTable& SphereQuadTree::getLevelsTable() const {
+    return _levelsTable;
 }
 
-const Graphics::API::Buffer& SphereQuadTree::getDebugBuffer() const {
-    return _debugBuffer;
+const SphereQuadTree::Mesh<QuadTree::Vertex>& SphereQuadTree::getMesh() const {
+    return _mesh;
 }
 
-const QuadTree::LevelsTable& SphereQuadTree::getLevelsTable() const {
-    return _levelsTable;
+const SphereQuadTree::Mesh<glm::vec3>& SphereQuadTree::getDebugMesh() const {
+    return _debugMesh;
+}
+
+uint32_t SphereQuadTree::getNodesNb() const {
+    return _leftQuadTree->getNodesNb() +
+        _rightQuadTree->getNodesNb() +
+        _frontQuadTree->getNodesNb() +
+        _backQuadTree->getNodesNb() +
+        _topQuadTree->getNodesNb() +
+        _bottomQuadTree->getNodesNb();
 }
 
-const Graphics::API::Texture& SphereQuadTree::getHeightMap() const {
-    return _heightMap;
+uint32_t SphereQuadTree::getRetiredNodesNb() const {
+    return _nodesReclaimer->getRetiredNb();
 }
 
-const Graphics::API::Texture& SphereQuadTree::getNormalMap() const {
-    return _normalMap;
+uint32_t SphereQuadTree::getEvaluatedNodesNb() const {
+    return _evaluatedNodesNb;
+}
+
+const std::shared_ptr<const PlanetPackage>& SphereQuadTree::getPackage() const {
+    return _package;
+}
+
+VirtualHeightMap* SphereQuadTree::getVirtualHeightMap() const {
+    return _virtualHeightMap.get();
+}
+
+void SphereQuadTree::setVirtualHeightMap(std::unique_ptr<VirtualHeightMap> virtualHeightMap) {
+    if (_virtualHeightMap != nullptr) {
+        _budget->release({0, 0, _tileSlotsNb * getTileSlotSize(*_virtualHeightMap)});
+        _tileSlotsNb = 0;
+    }
+
+    _virtualHeightMap = std::move(virtualHeightMap);
+
+    if (_virtualHeightMap != nullptr) {
+        _virtualHeightMap->setPrefetchSlotsNb(_prefetchSettings.lookahead != 0 ? _prefetchSettings.tileSlotsNb : 0);
+    }
 }
 
 void SphereQuadTree::setMaxHeight(float maxHeight) {
+    // The quadtrees AABB boxes are extruded with the max height when they are tested
     _maxHeight = maxHeight;
-
-    _leftQuadTree->updateShapeAABB();
-    _rightQuadTree->updateShapeAABB();
-    _frontQuadTree->updateShapeAABB();
-    _backQuadTree->updateShapeAABB();
-    _topQuadTree->updateShapeAABB();
-    _bottomQuadTree->updateShapeAABB();
 }
 
 void SphereQuadTree::setSize(float size) {
+    // The quadtrees are computed for a planet of size 1, the size is applied when they are tested
     _size = size;
+}
 
-    _leftQuadTree = nullptr;
-    _rightQuadTree = nullptr;
-    _frontQuadTree = nullptr;
-    _backQuadTree = nullptr;
-    _topQuadTree = nullptr;
+float SphereQuadTree::getLodScale() const {
+    return _lodScale.load(std::memory_order_relaxed);
+}
 
-    initLevelsDistance();
-    initChildren();
+void SphereQuadTree::setLodScale(float lodScale) {
+    _lodScale.store(lodScale, std::memory_order_relaxed);
+}
+
+bool SphereQuadTree::temporalCoherence() const {
+    return _temporalCoherence;
+}
+
+void SphereQuadTree::temporalCoherence(bool enabled) {
+    _temporalCoherence = enabled;
+}
+
+const SphereQuadTree::PrefetchSettings& SphereQuadTree::getPrefetchSettings() const {
+    return _prefetchSettings;
+}
+
+void SphereQuadTree::setPrefetchSettings(const PrefetchSettings& settings) {
+    _prefetchSettings = settings;
+
+    if (_virtualHeightMap != nullptr) {
+        _virtualHeightMap->setPrefetchSlotsNb(_prefetchSettings.lookahead != 0 ? _prefetchSettings.tileSlotsNb : 0);
+    }
+
+    // The next prefetch keeps the quadtrees within the budget
+    if (_prefetchSettings.lookahead == 0 || _prefetchStatistics.prefetchedNodesNb > _prefetchSettings.maxNodesNb) {
+        releasePrefetchedChildren();
+    }
+}
+
+SphereQuadTree::PrefetchStatistics SphereQuadTree::getPrefetchStatistics() const {
+    return _prefetchStatistics;
+}
+
+size_t SphereQuadTree::getNodesCacheSize() const {
+    return _nodesCacheSize;
+}
+
+void SphereQuadTree::setNodesCacheSize(size_t size) {
+    _nodesCacheSize = size;
+
+    // Each entry holds the 4 children of a merged quadtree
+    _nodesCache->setCapacity(size / (4 * sizeof(QuadTree)), [this](QuadTree::Children evicted) {
+        retireChildren(std::move(evicted));
+    });
+}
+
+LodBudget& SphereQuadTree::getBudget() {
+    return *_budget;
+}
+
+const LodBudget& SphereQuadTree::getBudget() const {
+    return *_budget;
+}
+
+uint32_t SphereQuadTree::getDeferredSplitsNb() const {
+    return _deferredSplitsNb;
 }
 
-bool SphereQuadTree::init(const Graphics::Renderer* renderer) {
+float SphereQuadTree::getBudgetScale() const {
+    return _budgetScale;
+}
+
+SphereQuadTree::NodesCacheStatistics SphereQuadTree::getNodesCacheStatistics() const {
+    System::LruCache<uint64_t, QuadTree::Children>::Statistics statistics = _nodesCache->getStatistics();
+
+    return {static_cast<uint32_t>(_nodesCache->getSize() * 4), statistics.hitsNb, statistics.missesNb};
+}
+
+void SphereQuadTree::walk(const std::function<bool(const QuadTree& quadTree)>& visitor) const {
+    PROFILE_SCOPE("SphereQuadTree::walk");
+
+    // The quadtrees read after this can't be deleted until the guard is destroyed
+    System::EpochReclaimer<QuadTree>::ReadGuard guard = _nodesReclaimer->read();
+
+    std::vector<const QuadTree*> quadTrees = {
+        _leftQuadTree.get(),
+        _rightQuadTree.get(),
+        _frontQuadTree.get(),
+        _backQuadTree.get(),
+        _topQuadTree.get(),
+        _bottomQuadTree.get()
+    };
+
+    while (!quadTrees.empty()) {
+        const QuadTree* quadTree = quadTrees.back();
+        quadTrees.pop_back();
+
+        if (!visitor(*quadTree)) {
+            continue;
+        }
+
+        for (uint8_t orientation = 0; orientation < 4; ++orientation) {
+            const QuadTree* child = quadTree->readChild(static_cast<QuadTree::ChildOrientation>(orientation));
+            if (child != nullptr) {
+                quadTrees.push_back(child);
+            }
+        }
+    }
+}
+
+void SphereQuadTree::collectRetiredNodes() {
+    _nodesReclaimer->collect();
+}
+
+bool SphereQuadTree::init() {
+    _nodesReclaimer = std::make_unique<System::EpochReclaimer<QuadTree>>();
+    _nodesCache = std::make_unique<System::LruCache<uint64_t, QuadTree::Children>>(0);
+    _budget = std::make_unique<LodBudget>();
+    setNodesCacheSize(defaultNodesCacheSize);
+
     initLevelsDistance();
     initChildren();
 
-    return initHeightMap() && initNormalMap(renderer) && initBuffer() && initDebugBuffer();
+    return true;
 }
 
 void SphereQuadTree::initChildren() {
+    // The quadtrees don't depend on the planet size
+    float size = 1.0f;
+
     // Center sphere
     glm::vec3 baseOffset = {
-        -_size / 2.0f,
-        -_size / 2.0f,
-        _size / 2.0f
+        -size / 2.0f,
+        -size / 2.0f,
+        size / 2.0f
     };
 
     _leftQuadTree = std::make_unique<Core::QuadTree>(
         *this, // Planet
         QuadTree::Face::LEFT, // Face
         0, // Level
-        _size, // Size
-        glm::vec3(0.0f, 0.0f, -_size) + baseOffset, // Position
+        size, // Size
+        glm::vec3(0.0f, 0.0f, -size) + baseOffset, // Position
         glm::vec3(0.0f, 0.0f, 1.0f), // Width direction
         glm::vec3(0.0f, 1.0f, 0.0f), // Height direction
         glm::vec3(-1.0f, 0.0f, 0.0f) // Normal
@@ -238,8 +329,8 @@ void SphereQuadTree::initChildren() {
         *this, // Planet
         QuadTree::Face::RIGHT, // Face
         0, // Level
-        _size, // Size
-        glm::vec3(_size, 0.0f, 0.0f) + baseOffset, // Position
+        size, // Size
+        glm::vec3(size, 0.0f, 0.0f) + baseOffset, // Position
         glm::vec3(0.0f, 0.0f, -1.0f), // Width direction
         glm::vec3(0.0f, 1.0f, 0.0f), // Height direction
         glm::vec3(1.0f, 0.0f, 0.0f) // Normal
@@ -248,7 +339,7 @@ void SphereQuadTree::initChildren() {
         *this, // Planet
         QuadTree::Face::FRONT, // Face
         0, // Level
-        _size, // Size
+        size, // Size
         glm::vec3(0.0f) + baseOffset, // Position
         glm::vec3(1.0f, 0.0f, 0.0f), // Width direction
         glm::vec3(0.0f, 1.0f, 0.0f), // Height direction
@@ -258,8 +349,8 @@ void SphereQuadTree::initChildren() {
         *this, // Planet
         QuadTree::Face::BACK, // Face
         0, // Level
-        _size, // Size
-        glm::vec3(_size, 0.0f, -_size) + baseOffset, // Position
+        size, // Size
+        glm::vec3(size, 0.0f, -size) + baseOffset, // Position
         glm::vec3(-1.0f, 0.0f, 0.0f), // Width direction
         glm::vec3(0.0f, 1.0f, 0.0f), // Height direction
         glm::vec3(0.0f, 0.0f, -1.0f) // Normal
@@ -268,8 +359,8 @@ void SphereQuadTree::initChildren() {
         *this, // Planet
         QuadTree::Face::TOP, // Face
         0, // Level
-        _size, // Size
-        glm::vec3(0.0f, _size, 0.0f) + baseOffset, // Position
+        size, // Size
+        glm::vec3(0.0f, size, 0.0f) + baseOffset, // Position
         glm::vec3(1.0f, 0.0f, 0.0f), // Width direction
         glm::vec3(0.0f, 0.0f, -1.0f), // Height direction
         glm::vec3(0.0f, 1.0f, 0.0f) // Normal
@@ -278,8 +369,8 @@ void SphereQuadTree::initChildren() {
         *this, // Planet
         QuadTree::Face::BOTTOM, // Face
         0, // Level
-        _size, // Size
-        glm::vec3(0.0f, 0.0f, -_size) + baseOffset, // Position
+        size, // Size
+        glm::vec3(0.0f, 0.0f, -size) + baseOffset, // Position
         glm::vec3(1.0f, 0.0f, 0.0f), // Width direction
         glm::vec3(0.0f, 0.0f, 1.0f), // Height direction
         glm::vec3(0.0f, -1.0f, 0.0f) // Normal
@@ -323,70 +414,10 @@ void SphereQuadTree::initChildren() {
     );
 }
 
-bool SphereQuadTree::initHeightMap() {
-    Graphics::API::Builder::Texture textureBuilder;
-
-    textureBuilder.setType(GL_TEXTURE_CUBE_MAP);
-    textureBuilder.setFormat(GL_RGBA);
-    textureBuilder.setInternalFormat(GL_RGBA32F);
-    textureBuilder.setDataType(GL_FLOAT);
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X)->setFileName("resources/images/brush3.png");
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_NEGATIVE_X)->setFileName("resources/images/brush3.png");
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_Y)->setFileName("resources/images/brush3.png");
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y)->setFileName("resources/images/brush3.png");
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_Z)->setFileName("resources/images/brush3.png");
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z)->setFileName("resources/images/brush3.png");
-    textureBuilder.setParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    textureBuilder.setParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    textureBuilder.setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    textureBuilder.setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    textureBuilder.setParameter(GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-    if (!textureBuilder.build(_heightMap)) {
-        // TODO: replace this with logger
-        std::cerr << "SphereQuadTree::initHeightMap: failed to create height map texture" << std::endl;
-        return false;
-    }
-    return true;
-}
-
-bool SphereQuadTree::initNormalMap(const Graphics::Renderer* renderer) {
-    Graphics::API::Builder::Texture textureBuilder;
-
-    textureBuilder.setType(GL_TEXTURE_CUBE_MAP);
-    textureBuilder.setFormat(GL_RGBA);
-    textureBuilder.setInternalFormat(GL_RGBA32F);
-    textureBuilder.setDataType(GL_FLOAT);
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X);
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_NEGATIVE_X);
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_Y);
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y);
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_Z);
-    textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z);
-
-    textureBuilder.setParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    textureBuilder.setParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    textureBuilder.setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    textureBuilder.setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    textureBuilder.setParameter(GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-    textureBuilder.setWidth(_heightMap.getWidth());
-    textureBuilder.setHeight(_heightMap.getHeight());
-
-    if (!textureBuilder.build(_normalMap)) {
-        // TODO: replace this with logger
-        std::cerr << "SphereQuadTree::initNormalMap: failed to create normal map texture" << std::endl;
-        return false;
-    }
-
-    renderer->createNormalMapFromHeightMap(_heightMap, _normalMap, _maxHeight);
-
-    return true;
-}
-
 void SphereQuadTree::initLevelsDistance() {
+    // In planet size units, like the quadtrees
     uint32_t maxLevels = 5;
-    float distance = _size / 0.2f;
+    float distance = 1.0f / 0.2f;
 
     _levelsTable.clear();
 
@@ -402,91 +433,275 @@ void SphereQuadTree::initLevelsDistance() {
     }
 }
 
-bool SphereQuadTree::initBuffer() {
-    Graphics::API::Builder::Buffer bufferBuilder;
+System::EpochReclaimer<QuadTree>& SphereQuadTree::getNodesReclaimer() const {
+    return *_nodesReclaimer;
+}
 
-    // Cube position attribute
-    bufferBuilder.addAttribute({
-        0,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(QuadTree::Vertex),
-        offsetof(QuadTree::Vertex, cubePos)
-    });
-    // Sphere position attribute
-    bufferBuilder.addAttribute({
-        1,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(QuadTree::Vertex),
-        offsetof(QuadTree::Vertex, spherePos)
-    });
-    // Width direction attribute
-    bufferBuilder.addAttribute({
-        2,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(QuadTree::Vertex),
-        offsetof(QuadTree::Vertex, widthDir)
-    });
-    // Height direction attribute
-    bufferBuilder.addAttribute({
-        3,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(QuadTree::Vertex),
-        offsetof(QuadTree::Vertex, heightDir)
-    });
-    // QuadTree level attribute
-    bufferBuilder.addAttribute({
-        4,
-        1,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(QuadTree::Vertex),
-        offsetof(QuadTree::Vertex, quadTreeLevel)
+void SphereQuadTree::cacheChildren(uint64_t key, QuadTree::Children children) const {
+    // Over the limits, the merges release their quadtrees instead of keeping them from the splits
+    if (_budget->getExcess().nodesNb != 0) {
+        retireChildren(std::move(children));
+        return;
+    }
+
+    _nodesCache->insert(key, std::move(children), [this](QuadTree::Children evicted) {
+        retireChildren(std::move(evicted));
     });
+}
+
+bool SphereQuadTree::takeCachedChildren(uint64_t key, QuadTree::Children& children) const {
+    return _nodesCache->take(key, children);
+}
+
+void SphereQuadTree::retireChildren(QuadTree::Children children) const {
+    releaseNodes(4);
+
+    _nodesReclaimer->retire(std::move(children.topLeft));
+    _nodesReclaimer->retire(std::move(children.topRight));
+    _nodesReclaimer->retire(std::move(children.bottomLeft));
+    _nodesReclaimer->retire(std::move(children.bottomRight));
+}
+
+float SphereQuadTree::getSplitDistance(uint32_t level) const {
+    return _levelsTable[level] * _updateLodScale;
+}
+
+void SphereQuadTree::prefetch(const Graphics::Camera& camera) {
+    PROFILE_SCOPE("SphereQuadTree::prefetch");
+
+    glm::vec3 pos = camera.getPos();
+
+    if (!_cameraVelocity.valid) {
+        _cameraVelocity = {true, pos, glm::vec3(0.0f), 0};
+        return;
+    }
+
+    // Smoothed so an irregular update doesn't throw the prediction away
+    _cameraVelocity.velocity += (pos - _cameraVelocity.pos - _cameraVelocity.velocity) * velocitySmoothing;
+    _cameraVelocity.pos = pos;
+
+    // Over the limits, the prefetched quadtrees are released for the splits of the next updates
+    if (_budget->getExcess().nodesNb != 0) {
+        releasePrefetchedChildren();
+        return;
+    }
+
+    if (_prefetchSettings.lookahead == 0 || ++_cameraVelocity.updatesNb < _prefetchSettings.interval) {
+        return;
+    }
+
+    glm::vec3 offset = _cameraVelocity.velocity * static_cast<float>(_prefetchSettings.lookahead);
+    if (glm::length(offset) < minPrefetchDistance * _size) {
+        return;
+    }
+
+    glm::vec3 predictedPos = pos + offset;
+    _cameraVelocity.updatesNb = 0;
+    _newPrefetchedNodesNb = 0;
+
+    _leftQuadTree->prefetch(pos, predictedPos);
+    _rightQuadTree->prefetch(pos, predictedPos);
+    _frontQuadTree->prefetch(pos, predictedPos);
+    _backQuadTree->prefetch(pos, predictedPos);
+    _topQuadTree->prefetch(pos, predictedPos);
+    _bottomQuadTree->prefetch(pos, predictedPos);
+}
+
+void SphereQuadTree::releasePrefetchedChildren() {
+    if (_prefetchStatistics.prefetchedNodesNb == 0) {
+        return;
+    }
 
-    bufferBuilder.setVerticesUsage(GL_DYNAMIC_DRAW);
-    bufferBuilder.setIndicesUsage(GL_DYNAMIC_DRAW);
+    _leftQuadTree->releasePrefetchedChildren();
+    _rightQuadTree->releasePrefetchedChildren();
+    _frontQuadTree->releasePrefetchedChildren();
+    _backQuadTree->releasePrefetchedChildren();
+    _topQuadTree->releasePrefetchedChildren();
+    _bottomQuadTree->releasePrefetchedChildren();
+}
 
-    if (!bufferBuilder.build(_buffer)) {
-        // TODO: replace this with logger
-        std::cerr << "SphereQuadTree::initBuffer: failed to create VAO" << std::endl;
+bool SphereQuadTree::reservePrefetchedNodes(uint32_t nodesNb) const {
+    if (_prefetchStatistics.prefetchedNodesNb + nodesNb > _prefetchSettings.maxNodesNb ||
+        _newPrefetchedNodesNb + nodesNb > _prefetchSettings.maxNewNodesNb) {
         return false;
     }
 
+    _prefetchStatistics.prefetchedNodesNb += nodesNb;
+    _newPrefetchedNodesNb += nodesNb;
+
     return true;
 }
 
-bool SphereQuadTree::initDebugBuffer() {
-    Graphics::API::Builder::Buffer bufferBuilder;
+void SphereQuadTree::releasePrefetchedNodes(uint32_t nodesNb) const {
+    _prefetchStatistics.prefetchedNodesNb -= nodesNb;
+}
 
-    // Position attribute
-    bufferBuilder.addAttribute({
-        0,
-        3,
-        GL_FLOAT,
-        GL_FALSE,
-        sizeof(glm::vec3),
-        0
-    });
+void SphereQuadTree::addSplit(bool prefetched) const {
+    ++_prefetchStatistics.splitsNb;
 
-    bufferBuilder.setVerticesUsage(GL_DYNAMIC_DRAW);
-    bufferBuilder.setIndicesUsage(GL_DYNAMIC_DRAW);
+    if (prefetched) {
+        ++_prefetchStatistics.prefetchedSplitsNb;
+    }
+}
 
-    if (!bufferBuilder.build(_debugBuffer)) {
-        // TODO: replace this with logger
-        std::cerr << "SphereQuadTree::initDebugBuffer: failed to create VAO" << std::endl;
-        return false;
+bool SphereQuadTree::reserveSplit(float priority) const {
+    return _budget->reserve({0, splitVerticesSize, 0}, getBudgetFraction(priority));
+}
+
+void SphereQuadTree::releaseSplit() const {
+    _budget->release({0, splitVerticesSize, 0});
+}
+
+bool SphereQuadTree::reserveNodes(uint32_t nodesNb, float priority) const {
+    float fraction = getBudgetFraction(priority);
+
+    while (!_budget->reserve({nodesNb, 0, 0}, fraction)) {
+        if (!evictFarthestCachedChildren()) {
+            return false;
+        }
     }
 
     return true;
 }
 
+void SphereQuadTree::releaseNodes(uint32_t nodesNb) const {
+    _budget->release({nodesNb, 0, 0});
+}
+
+void SphereQuadTree::addDeferredSplit() const {
+    ++_deferredSplitsNb;
+}
+
+bool SphereQuadTree::evictFarthestCachedChildren() const {
+    glm::vec3 cameraPos = _coherenceState.pos / _size;
+
+    return _nodesCache->evictMax([&cameraPos](const QuadTree::Children& children) {
+        return glm::distance(cameraPos, (children.topLeft->getCenter() + children.bottomRight->getCenter()) * 0.5f);
+    }, [this](QuadTree::Children evicted) {
+        retireChildren(std::move(evicted));
+    });
+}
+
+void SphereQuadTree::updateBudgetScale() {
+    // The cached quadtrees are released first when the limits are lowered
+    LodBudget::Usage excess = _budget->getExcess();
+    while (excess.nodesNb != 0 && evictFarthestCachedChildren()) {
+        excess = _budget->getExcess();
+    }
+
+    if (_deferredSplitsNb != 0 || excess.nodesNb != 0 || excess.verticesSize != 0) {
+        _budgetScale = std::max(_budgetScale * budgetScaleDecrease, minBudgetScale);
+        _budgetUpdatesNb = 0;
+    }
+    else if (_budgetScale < 1.0f && ++_budgetUpdatesNb >= budgetRecoveryUpdatesNb) {
+        _budgetScale = std::min(_budgetScale * budgetScaleIncrease, 1.0f);
+        _budgetUpdatesNb = 0;
+    }
+
+    _deferredSplitsNb = 0;
+}
+
+void SphereQuadTree::updateTilesBudget() {
+    uint64_t slotSize = getTileSlotSize(*_virtualHeightMap);
+
+    // The slots above the lowered limits are released, the update evicts their tiles
+    LodBudget::Usage excess = _budget->getExcess();
+    uint32_t excessSlotsNb = static_cast<uint32_t>(std::min<uint64_t>((excess.texturesSize + slotSize - 1) / slotSize, _tileSlotsNb));
+    if (excessSlotsNb != 0) {
+        _budget->release({0, 0, excessSlotsNb * slotSize});
+        _tileSlotsNb -= excessSlotsNb;
+    }
+
+    // The slots are reserved when the tiles need them, the prefetched tiles included
+    VirtualHeightMap::Statistics statistics = _virtualHeightMap->getStatistics();
+    uint32_t neededSlotsNb = std::min(statistics.residentTilesNb + statistics.pendingTilesNb, _virtualHeightMap->getSlotsNb());
+
+    while (_tileSlotsNb < neededSlotsNb && _budget->reserve({0, 0, slotSize})) {
+        ++_tileSlotsNb;
+    }
+
+    _virtualHeightMap->setUsableSlotsNb(_tileSlotsNb);
+}
+
+bool SphereQuadTree::updateCameraMotion(const Graphics::Camera& camera) {
+    CoherenceState state;
+    state.valid = true;
+    state.pos = camera.getPos();
+    state.forward = camera.getForward();
+    state.up = camera.getUp();
+    state.right = camera.getRight();
+    state.fov = camera.getFov();
+    state.nearPlane = camera.getNear();
+    state.farPlane = camera.getFar();
+    state.aspect = camera.getAspect();
+    state.frustumLocked = camera.frustumLocked();
+    state.lodScale = _updateLodScale;
+    state.size = _size;
+    state.maxHeight = _maxHeight;
+
+    const CoherenceState& previous = _coherenceState;
+    bool coherent = previous.valid &&
+        state.fov == previous.fov &&
+        state.nearPlane == previous.nearPlane &&
+        state.farPlane == previous.farPlane &&
+        state.aspect == previous.aspect &&
+        state.frustumLocked == previous.frustumLocked &&
+        state.size == previous.size &&
+        state.maxHeight == previous.maxHeight;
+
+    if (coherent) {
+        // A rotation moves a point at distance 1 of the camera by at most the length of the axes displacements
+        glm::vec3 forwardMotion = state.forward - previous.forward;
+        glm::vec3 upMotion = state.up - previous.up;
+        glm::vec3 rightMotion = state.right - previous.right;
+
+        _cameraMotion.translation += glm::distance(state.pos, previous.pos);
+        _cameraMotion.rotation += std::sqrt(
+            glm::dot(forwardMotion, forwardMotion) +
+            glm::dot(upMotion, upMotion) +
+            glm::dot(rightMotion, rightMotion)
+        );
+        // The governor and the budget change the LOD scale by a few percents per update, they don't discard the coherence
+        _cameraMotion.lodScale += std::abs(state.lodScale - previous.lodScale);
+    }
+
+    _coherenceState = state;
+
+    return coherent;
+}
+
+const QuadTree::CameraMotion& SphereQuadTree::getCameraMotion() const {
+    return _cameraMotion;
+}
+
+bool SphereQuadTree::isCoherentUpdate() const {
+    return _coherentUpdate;
+}
+
+void SphereQuadTree::updateMesh(Mesh<QuadTree::Vertex>& mesh) const {
+    // Keep the memory of the previous update to reduce the resizes
+    mesh.vertices.clear();
+    mesh.indices.clear();
+
+    _leftQuadTree->addChildrenVertices(mesh.vertices, mesh.indices);
+    _rightQuadTree->addChildrenVertices(mesh.vertices, mesh.indices);
+    _frontQuadTree->addChildrenVertices(mesh.vertices, mesh.indices);
+    _backQuadTree->addChildrenVertices(mesh.vertices, mesh.indices);
+    _topQuadTree->addChildrenVertices(mesh.vertices, mesh.indices);
+    _bottomQuadTree->addChildrenVertices(mesh.vertices, mesh.indices);
+}
+
+void SphereQuadTree::updateDebugMesh(Mesh<glm::vec3>& mesh) const {
+    mesh.vertices.clear();
+    mesh.indices.clear();
+
+    _leftQuadTree->addDebugVertices(mesh.vertices, mesh.indices);
+    _rightQuadTree->addDebugVertices(mesh.vertices, mesh.indices);
+    _frontQuadTree->addDebugVertices(mesh.vertices, mesh.indices);
+    _backQuadTree->addDebugVertices(mesh.vertices, mesh.indices);
+    _topQuadTree->addDebugVertices(mesh.vertices, mesh.indices);
+    _bottomQuadTree->addDebugVertices(mesh.vertices, mesh.indices);
+}
+
 } // Namespace Core
 
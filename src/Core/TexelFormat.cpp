@@ -0,0 +1,61 @@
+#include <cstring> // std::memcpy
+
+#include <glm/gtc/packing.hpp> // glm::packHalf1x16, glm::packHalf2x16, glm::packUnorm1x16
+
+#include <Core/TexelFormat.hpp> // Core::TexelFormat
+
+namespace Core {
+
+size_t TexelFormat::getSize(Height format) {
+    switch (format) {
+        case Height::R16:
+        case Height::R16F:
+            return sizeof(uint16_t);
+        case Height::R32F:
+        default:
+            return sizeof(float);
+    }
+}
+
+size_t TexelFormat::getSize(Gradient format) {
+    switch (format) {
+        case Gradient::RG16F:
+            return 2 * sizeof(uint16_t);
+        case Gradient::RG32F:
+        default:
+            return 2 * sizeof(float);
+    }
+}
+
+void TexelFormat::encodeHeights(const float* heights, size_t texelsNb, Height format, void* texels) {
+    uint16_t* texels16 = static_cast<uint16_t*>(texels);
+
+    switch (format) {
+        case Height::R16:
+            for (size_t i = 0; i < texelsNb; ++i) {
+                texels16[i] = glm::packUnorm1x16(heights[i]);
+            }
+            break;
+        case Height::R16F:
+            for (size_t i = 0; i < texelsNb; ++i) {
+                texels16[i] = glm::packHalf1x16(heights[i]);
+            }
+            break;
+        case Height::R32F:
+        default:
+            std::memcpy(texels, heights, texelsNb * sizeof(float));
+            break;
+    }
+}
+
+void TexelFormat::encodeGradient(const glm::vec2& gradient, Gradient format, void* texel) {
+    if (format == Gradient::RG16F) {
+        uint32_t packed = glm::packHalf2x16(gradient);
+        std::memcpy(texel, &packed, sizeof(packed));
+    }
+    else {
+        std::memcpy(texel, &gradient, sizeof(gradient));
+    }
+}
+
+} // Namespace Core
@@ -0,0 +1,521 @@
+#include <algorithm> // std::sort, std::min, std::max
+#include <iostream> // std::cerr
+#include <utility> // std::move
+
+#include <System/Profiler.hpp> // PROFILE_SCOPE, System::Profiler
+
+#include <Core/VirtualHeightMap.hpp> // Core::VirtualHeightMap
+
+namespace Core {
+
+constexpr uint32_t VirtualHeightMap::noSlot;
+
+// Loads sent to the loading thread and not finished yet
+static const uint32_t maxLoadingTilesNb = 16;
+
+// The indirection table has one entry per tile of the finest level
+static const uint32_t maxLevelsNb = 13;
+
+// Frames a prefetched tile is kept for without being prefetched again, then the prediction is considered wrong
+static const uint64_t prefetchedFramesNb = 16;
+
+VirtualHeightMap::~VirtualHeightMap() {
+    {
+        std::lock_guard<std::mutex> lock(_loadsMutex);
+        _stopped = true;
+    }
+    _loadsCondition.notify_all();
+
+    if (_loadingThread.joinable()) {
+        _loadingThread.join();
+    }
+}
+
+std::unique_ptr<VirtualHeightMap> VirtualHeightMap::create(std::shared_ptr<const HeightTileSet> tileSet, uint32_t slotsNb) {
+    // Don't use std::make_unique because the constructor is private
+    std::unique_ptr<VirtualHeightMap> virtualHeightMap(new VirtualHeightMap());
+
+    if (!virtualHeightMap->init(std::move(tileSet), slotsNb)) {
+        return nullptr;
+    }
+
+    return virtualHeightMap;
+}
+
+VirtualHeightMap::Tile VirtualHeightMap::getTile(const glm::vec3& direction, uint32_t level) const {
+    float s = 0.0f;
+    float t = 0.0f;
+    CubeMap::Face face = CubeMap::getFace(direction, s, t);
+
+    level = std::min(level, _tileSet->getDescription().levelsNb - 1);
+    uint32_t tilesNb = 1u << level;
+
+    // From [-1, 1] to the tiles of the level
+    uint32_t x = static_cast<uint32_t>(std::min(std::max((s + 1.0f) * 0.5f * tilesNb, 0.0f), tilesNb - 1.0f));
+    uint32_t y = static_cast<uint32_t>(std::min(std::max((t + 1.0f) * 0.5f * tilesNb, 0.0f), tilesNb - 1.0f));
+
+    return {face, level, x, y};
+}
+
+void VirtualHeightMap::request(const Tile& tile) {
+    uint64_t key = getKey(tile);
+
+    auto entry = _tiles.find(key);
+    if (entry != _tiles.end()) {
+        entry->second.lastUsedFrame = _frame;
+
+        if (entry->second.prefetched) {
+            if (entry->second.state == TileState::RESIDENT) {
+                ++_statistics.prefetchHitsNb;
+            }
+            unprefetch(entry->second);
+        }
+        return;
+    }
+
+    TileState state = _tileSet->hasTile(tile.face, tile.level, tile.x, tile.y) ? TileState::REQUESTED : TileState::MISSING;
+    _tiles[key] = {tile, state, noSlot, _frame, false};
+}
+
+void VirtualHeightMap::prefetch(const Tile& tile) {
+    uint64_t key = getKey(tile);
+
+    auto entry = _tiles.find(key);
+    if (entry != _tiles.end()) {
+        // The tiles requested by the frames keep their last used frame, they are evicted first if they are not requested again
+        if (entry->second.prefetched) {
+            entry->second.lastUsedFrame = _frame;
+        }
+        return;
+    }
+
+    if (_statistics.prefetchedTilesNb >= _prefetchSlotsNb) {
+        return;
+    }
+
+    if (!_tileSet->hasTile(tile.face, tile.level, tile.x, tile.y)) {
+        _tiles[key] = {tile, TileState::MISSING, noSlot, _frame, false};
+        return;
+    }
+
+    _tiles[key] = {tile, TileState::REQUESTED, noSlot, _frame, true};
+    ++_statistics.prefetchedTilesNb;
+}
+
+void VirtualHeightMap::update() {
+    PROFILE_SCOPE("VirtualHeightMap::update");
+
+    _loadedSlots.clear();
+    for (auto& rect: _dirtyRects) {
+        rect = {0, 0, 0, 0};
+    }
+
+    collectLoads();
+    startLoads();
+
+    ++_frame;
+}
+
+const HeightTileSet& VirtualHeightMap::getTileSet() const {
+    return *_tileSet;
+}
+
+uint32_t VirtualHeightMap::getSlotsNb() const {
+    return _slotsNb;
+}
+
+uint32_t VirtualHeightMap::getPrefetchSlotsNb() const {
+    return _prefetchSlotsNb;
+}
+
+void VirtualHeightMap::setPrefetchSlotsNb(uint32_t prefetchSlotsNb) {
+    _prefetchSlotsNb = prefetchSlotsNb;
+}
+
+uint32_t VirtualHeightMap::getUsableSlotsNb() const {
+    return _usableSlotsNb;
+}
+
+void VirtualHeightMap::setUsableSlotsNb(uint32_t usableSlotsNb) {
+    _usableSlotsNb = std::min(usableSlotsNb, _slotsNb);
+}
+
+uint32_t VirtualHeightMap::getSlotSize() const {
+    return _slotSize;
+}
+
+const uint16_t* VirtualHeightMap::getSlotTexels(uint32_t slot) const {
+    return _slotsTexels.data() + static_cast<size_t>(slot) * _slotSize * _slotSize;
+}
+
+const std::vector<uint32_t>& VirtualHeightMap::getLoadedSlots() const {
+    return _loadedSlots;
+}
+
+uint32_t VirtualHeightMap::getIndirectionSize() const {
+    return _indirectionSize;
+}
+
+const VirtualHeightMap::IndirectionEntry* VirtualHeightMap::getIndirection(CubeMap::Face face) const {
+    return _indirection[static_cast<uint32_t>(face)].data();
+}
+
+const std::array<VirtualHeightMap::DirtyRect, CubeMap::facesNb>& VirtualHeightMap::getDirtyRects() const {
+    return _dirtyRects;
+}
+
+void VirtualHeightMap::addUploads(Uploads& uploads) const {
+    size_t slotTexelsNb = static_cast<size_t>(_slotSize) * _slotSize;
+    for (uint32_t slot: _loadedSlots) {
+        const uint16_t* texels = getSlotTexels(slot);
+        uploads.slots.push_back({slot, std::vector<uint16_t>(texels, texels + slotTexelsNb)});
+    }
+
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        const DirtyRect& rect = _dirtyRects[face];
+        if (rect.xMin == rect.xMax) {
+            continue;
+        }
+
+        Uploads::Indirection indirection = {static_cast<CubeMap::Face>(face), rect, {}};
+        indirection.entries.reserve(static_cast<size_t>(rect.xMax - rect.xMin) * (rect.yMax - rect.yMin));
+
+        for (uint32_t y = rect.yMin; y < rect.yMax; ++y) {
+            const IndirectionEntry* row = _indirection[face].data() + static_cast<size_t>(y) * _indirectionSize;
+            indirection.entries.insert(indirection.entries.end(), row + rect.xMin, row + rect.xMax);
+        }
+
+        uploads.indirections.push_back(std::move(indirection));
+    }
+
+    uploads.statistics = _statistics;
+}
+
+VirtualHeightMap::Statistics VirtualHeightMap::getStatistics() const {
+    return _statistics;
+}
+
+void VirtualHeightMap::Uploads::clear() {
+    slots.clear();
+    indirections.clear();
+}
+
+bool VirtualHeightMap::init(std::shared_ptr<const HeightTileSet> tileSet, uint32_t slotsNb) {
+    _tileSet = std::move(tileSet);
+
+    const auto& description = _tileSet->getDescription();
+    if (description.levelsNb > maxLevelsNb) {
+        // TODO: replace this with logger
+        std::cerr << "VirtualHeightMap::init: The tile set has " << description.levelsNb << " levels, the maximum is " << maxLevelsNb << std::endl;
+        return false;
+    }
+    if (slotsNb <= CubeMap::facesNb || slotsNb > UINT16_MAX) {
+        // TODO: replace this with logger
+        std::cerr << "VirtualHeightMap::init: Invalid number of slots " << slotsNb << std::endl;
+        return false;
+    }
+
+    _slotsNb = slotsNb;
+    _usableSlotsNb = slotsNb;
+    _slotSize = _tileSet->getTileTexelsSize();
+    _slotsTexels.resize(static_cast<size_t>(_slotsNb) * _slotSize * _slotSize);
+    _slotsKeys.assign(_slotsNb, UINT64_MAX);
+
+    _indirectionSize = 1u << (description.levelsNb - 1);
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        _indirection[face].assign(static_cast<size_t>(_indirectionSize) * _indirectionSize, {static_cast<uint16_t>(face), 0});
+        _dirtyRects[face] = {0, 0, _indirectionSize, _indirectionSize};
+    }
+
+    // The level 0 tiles are loaded now and never evicted, the other tiles fall back on them
+    for (uint32_t face = 0; face < CubeMap::facesNb; ++face) {
+        Tile tile = {static_cast<CubeMap::Face>(face), 0, 0, 0};
+
+        if (!_tileSet->readTile(tile.face, 0, 0, 0, _slotsTexels.data() + static_cast<size_t>(face) * _slotSize * _slotSize)) {
+            // TODO: replace this with logger
+            std::cerr << "VirtualHeightMap::init: The tile set misses the level 0 of the face " << face << std::endl;
+            return false;
+        }
+
+        _tiles[getKey(tile)] = {tile, TileState::RESIDENT, face, 0, false};
+        _slotsKeys[face] = getKey(tile);
+        _loadedSlots.push_back(face);
+    }
+
+    // Lowest slots first
+    for (uint32_t slot = _slotsNb; slot > CubeMap::facesNb; --slot) {
+        _freeSlots.push_back(slot - 1);
+    }
+
+    _statistics.residentTilesNb = CubeMap::facesNb;
+
+    _loadingThread = std::thread(&VirtualHeightMap::loadTiles, this);
+
+    return true;
+}
+
+uint64_t VirtualHeightMap::getKey(const Tile& tile) {
+    return (static_cast<uint64_t>(tile.face) << 56) |
+        (static_cast<uint64_t>(tile.level) << 48) |
+        (static_cast<uint64_t>(tile.y) << 24) |
+        tile.x;
+}
+
+void VirtualHeightMap::collectLoads() {
+    std::vector<Load> finishedLoads;
+    {
+        std::lock_guard<std::mutex> lock(_loadsMutex);
+        finishedLoads.swap(_finishedLoads);
+    }
+
+    for (const Load& load: finishedLoads) {
+        TileEntry& entry = _tiles[load.key];
+        --_loadingTilesNb;
+
+        if (!load.loaded) {
+            if (entry.prefetched) {
+                unprefetch(entry);
+            }
+
+            entry.state = TileState::MISSING;
+            entry.slot = noSlot;
+            _slotsKeys[load.slot] = UINT64_MAX;
+            _freeSlots.push_back(load.slot);
+            continue;
+        }
+
+        // Used by this frame, so startLoads can't evict it and reload its slot while the texels are uploaded
+        entry.state = TileState::RESIDENT;
+        entry.lastUsedFrame = _frame;
+        _loadedSlots.push_back(load.slot);
+        setIndirection(load.tile, load.slot);
+
+        ++_statistics.loadsNb;
+        ++_statistics.residentTilesNb;
+    }
+}
+
+void VirtualHeightMap::startLoads() {
+    // Requests of this frame, the coarsest levels first so there is always a close fallback, then the prefetched tiles
+    // The requests not renewed by this frame are dropped, the prefetched ones after prefetchedFramesNb
+    std::vector<TileEntry*> requests;
+    for (auto it = _tiles.begin(); it != _tiles.end();) {
+        TileEntry& entry = it->second;
+
+        // The resident tiles are kept as the other ones, but they don't use the prefetch budget anymore
+        if (entry.prefetched && entry.lastUsedFrame + prefetchedFramesNb < _frame) {
+            unprefetch(entry);
+        }
+
+        if (entry.state == TileState::REQUESTED && entry.lastUsedFrame < _frame && !entry.prefetched) {
+            it = _tiles.erase(it);
+            continue;
+        }
+        if (entry.state == TileState::REQUESTED) {
+            requests.push_back(&entry);
+        }
+
+        ++it;
+    }
+
+    _statistics.pendingTilesNb = static_cast<uint32_t>(requests.size()) + _loadingTilesNb;
+
+    uint32_t loadsNb = std::min<uint32_t>(static_cast<uint32_t>(requests.size()), maxLoadingTilesNb - std::min(_loadingTilesNb, maxLoadingTilesNb));
+
+    // The slots above the usable ones are freed by evicting the tiles not used by this frame
+    uint32_t usedSlotsNb = _slotsNb - static_cast<uint32_t>(_freeSlots.size());
+    uint32_t freeSlotsNb = usedSlotsNb < _usableSlotsNb ? std::min(_usableSlotsNb - usedSlotsNb, static_cast<uint32_t>(_freeSlots.size())) : 0;
+    uint32_t excessSlotsNb = usedSlotsNb > _usableSlotsNb ? usedSlotsNb - _usableSlotsNb : 0;
+
+    if (loadsNb == 0 && excessSlotsNb == 0) {
+        return;
+    }
+
+    std::partial_sort(requests.begin(), requests.begin() + loadsNb, requests.end(), [](const TileEntry* a, const TileEntry* b) {
+        if (a->prefetched != b->prefetched) {
+            return b->prefetched;
+        }
+
+        return a->tile.level < b->tile.level;
+    });
+
+    // Resident tiles not used by this frame, least recently used first
+    std::vector<uint32_t> victims;
+    if (freeSlotsNb < loadsNb || excessSlotsNb != 0) {
+        for (uint32_t slot = 0; slot < _slotsNb; ++slot) {
+            if (_slotsKeys[slot] == UINT64_MAX) {
+                continue;
+            }
+
+            const TileEntry& entry = _tiles[_slotsKeys[slot]];
+            if (entry.state == TileState::RESIDENT && entry.tile.level != 0 && entry.lastUsedFrame < _frame) {
+                victims.push_back(slot);
+            }
+        }
+
+        std::sort(victims.begin(), victims.end(), [this](uint32_t a, uint32_t b) {
+            return _tiles[_slotsKeys[a]].lastUsedFrame > _tiles[_slotsKeys[b]].lastUsedFrame;
+        });
+    }
+
+    for (; excessSlotsNb != 0 && !victims.empty(); --excessSlotsNb) {
+        evict(victims.back());
+        _freeSlots.push_back(victims.back());
+        victims.pop_back();
+    }
+
+    std::vector<Load> loads;
+    for (uint32_t i = 0; i < loadsNb; ++i) {
+        uint32_t slot = noSlot;
+
+        if (freeSlotsNb != 0) {
+            slot = _freeSlots.back();
+            _freeSlots.pop_back();
+            --freeSlotsNb;
+        }
+        else if (!victims.empty()) {
+            slot = victims.back();
+            victims.pop_back();
+            evict(slot);
+        }
+        else {
+            // All the slots are used by this frame
+            break;
+        }
+
+        TileEntry& entry = *requests[i];
+        uint64_t key = getKey(entry.tile);
+
+        entry.state = TileState::LOADING;
+        entry.slot = slot;
+        _slotsKeys[slot] = key;
+
+        loads.push_back({key, entry.tile, slot, false});
+    }
+
+    if (loads.empty()) {
+        return;
+    }
+
+    _loadingTilesNb += static_cast<uint32_t>(loads.size());
+
+    {
+        std::lock_guard<std::mutex> lock(_loadsMutex);
+        _pendingLoads.insert(_pendingLoads.end(), loads.begin(), loads.end());
+    }
+    _loadsCondition.notify_one();
+}
+
+void VirtualHeightMap::evict(uint32_t slot) {
+    uint64_t key = _slotsKeys[slot];
+    TileEntry& entry = _tiles[key];
+    Tile tile = entry.tile;
+
+    if (entry.prefetched) {
+        unprefetch(entry);
+    }
+
+    _tiles.erase(key);
+    _slotsKeys[slot] = UINT64_MAX;
+
+    resetIndirection(tile, slot);
+
+    ++_statistics.evictionsNb;
+    --_statistics.residentTilesNb;
+}
+
+void VirtualHeightMap::unprefetch(TileEntry& entry) {
+    entry.prefetched = false;
+    --_statistics.prefetchedTilesNb;
+}
+
+void VirtualHeightMap::setIndirection(const Tile& tile, uint32_t slot) {
+    uint32_t shift = _tileSet->getDescription().levelsNb - 1 - tile.level;
+    DirtyRect rect = {tile.x << shift, tile.y << shift, (tile.x + 1) << shift, (tile.y + 1) << shift};
+
+    auto& indirection = _indirection[static_cast<uint32_t>(tile.face)];
+    for (uint32_t y = rect.yMin; y < rect.yMax; ++y) {
+        for (uint32_t x = rect.xMin; x < rect.xMax; ++x) {
+            IndirectionEntry& entry = indirection[y * _indirectionSize + x];
+
+            // The finer resident tiles are kept
+            if (entry.level < tile.level) {
+                entry = {static_cast<uint16_t>(slot), static_cast<uint16_t>(tile.level)};
+            }
+        }
+    }
+
+    addDirtyRect(tile.face, rect);
+}
+
+void VirtualHeightMap::resetIndirection(const Tile& tile, uint32_t slot) {
+    // The level 0 tiles are always resident
+    IndirectionEntry ancestor = {static_cast<uint16_t>(tile.face), 0};
+    for (uint32_t level = tile.level; level-- > 1;) {
+        uint32_t shift = tile.level - level;
+        auto entry = _tiles.find(getKey({tile.face, level, tile.x >> shift, tile.y >> shift}));
+
+        if (entry != _tiles.end() && entry->second.state == TileState::RESIDENT) {
+            ancestor = {static_cast<uint16_t>(entry->second.slot), static_cast<uint16_t>(level)};
+            break;
+        }
+    }
+
+    uint32_t shift = _tileSet->getDescription().levelsNb - 1 - tile.level;
+    DirtyRect rect = {tile.x << shift, tile.y << shift, (tile.x + 1) << shift, (tile.y + 1) << shift};
+
+    auto& indirection = _indirection[static_cast<uint32_t>(tile.face)];
+    for (uint32_t y = rect.yMin; y < rect.yMax; ++y) {
+        for (uint32_t x = rect.xMin; x < rect.xMax; ++x) {
+            IndirectionEntry& entry = indirection[y * _indirectionSize + x];
+
+            if (entry.slot == slot) {
+                entry = ancestor;
+            }
+        }
+    }
+
+    addDirtyRect(tile.face, rect);
+}
+
+void VirtualHeightMap::addDirtyRect(CubeMap::Face face, const DirtyRect& rect) {
+    DirtyRect& dirtyRect = _dirtyRects[static_cast<uint32_t>(face)];
+
+    if (dirtyRect.xMin == dirtyRect.xMax) {
+        dirtyRect = rect;
+        return;
+    }
+
+    dirtyRect.xMin = std::min(dirtyRect.xMin, rect.xMin);
+    dirtyRect.yMin = std::min(dirtyRect.yMin, rect.yMin);
+    dirtyRect.xMax = std::max(dirtyRect.xMax, rect.xMax);
+    dirtyRect.yMax = std::max(dirtyRect.yMax, rect.yMax);
+}
+
+void VirtualHeightMap::loadTiles() {
+    System::Profiler::setThreadName("VirtualHeightMap loader");
+
+    while (true) {
+        Load load;
+        {
+            std::unique_lock<std::mutex> lock(_loadsMutex);
+            _loadsCondition.wait(lock, [this]() { return _stopped || !_pendingLoads.empty(); });
+
+            if (_stopped) {
+                return;
+            }
+
+            load = _pendingLoads.front();
+            _pendingLoads.erase(_pendingLoads.begin());
+        }
+
+        // The slot is only used by this thread until the load is collected
+        uint16_t* texels = _slotsTexels.data() + static_cast<size_t>(load.slot) * _slotSize * _slotSize;
+        load.loaded = _tileSet->readTile(load.tile.face, load.tile.level, load.tile.x, load.tile.y, texels);
+
+        std::lock_guard<std::mutex> lock(_loadsMutex);
+        _finishedLoads.push_back(load);
+    }
+}
+
+} // Namespace Core
@@ -1,3 +1,5 @@
+#include <System/Profiler.hpp> // PROFILE_SCOPE
+
 #include <Graphics/API/Buffer.hpp> // Graphics::API::Buffer
 
 namespace Graphics {
@@ -72,6 +74,8 @@ uint32_t Buffer::getIndicesNb() const {
 }
 
 void Buffer::updateVertices(char* data, uint32_t size, uint32_t verticesNb, GLenum usage) {
+    PROFILE_SCOPE("Buffer::updateVertices");
+
     bind();
 
     if (size > _verticesSize) {
@@ -86,6 +90,8 @@ void Buffer::updateVertices(char* data, uint32_t size, uint32_t verticesNb, GLen
 }
 
 void Buffer::updateIndices(char* data, uint32_t size, uint32_t indicesNb, GLenum usage) {
+    PROFILE_SCOPE("Buffer::updateIndices");
+
     bind();
 
     if (size > _indicesSize) {
@@ -1,3 +1,5 @@
+#include <cstring> // std::memcpy
+
 #include <Graphics/API/Builder/Buffer.hpp> // Graphics::API::Builder::Buffer
 
 namespace Graphics {
@@ -1,3 +1,4 @@
+#include <cstring> // std::memset
 #include <iostream> // std::cerr
 
 #include <Graphics/API/Builder/ShaderProgram.hpp> // Graphics::API::Builder::ShaderProgram
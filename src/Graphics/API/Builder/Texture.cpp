@@ -1,8 +1,8 @@
+#include <algorithm> // std::min, std::max
 #include <iostream> // std::cerr
+#include <thread> // std::thread
 
-// Define STB_IMAGE_IMPLEMENTATION before stb_image.h to create the implementation
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+#include <System/JobSystem.hpp> // System::JobSystem
 
 #include <Graphics/API/Builder/Texture.hpp> // Graphics::API::Builder::Texture
 
@@ -10,30 +10,11 @@ namespace Graphics {
 namespace API {
 namespace Builder {
 
-Texture::Image::Image(GLenum type): _type(type) {}
+Texture::Image::Image(GLenum type, GLint level): _type(type), _level(level) {}
 
-Texture::Image::~Image() {
-    if (_data != nullptr) {
-        STBI_FREE(_data);
-    }
-}
-
-bool Texture::Image::getData(void*& data, GLsizei& width, GLsizei& height) {
-    data = nullptr;
-    width = _texture->_width;
-    height = _texture->_height;
+bool Texture::Image::loadFile() {
+    _fileLoaded = true;
 
-    // Already loaded, just return it
-    if (_data != nullptr) {
-        data = _data;
-        return true;
-    }
-    // Don't need to load data
-    else if (_fileName.size() == 0) {
-        return true;
-    }
-
-    // Load image data
     // Set number of components of the data depending of the format
     int WantedCompNb = 0;
     switch (_texture->_format) {
@@ -45,38 +26,69 @@ bool Texture::Image::getData(void*& data, GLsizei& width, GLsizei& height) {
             break;
         default:
             // TODO: replace this with logger
-            std::cerr << "Texture::Image::getData: Format not supported for loading image data" << std::endl;
+            std::cerr << "Texture::Image::loadFile: Format not supported for loading image data" << std::endl;
             return false;
     }
 
-    // TODO: Use resources manager
-    int compNb = 0;
+    ImageCache::DataType dataType;
     if (_texture->_dataType == GL_FLOAT) {
-        _data = stbi_loadf(_fileName.c_str(), &_width, &_height, &compNb, WantedCompNb);
+        dataType = ImageCache::DataType::FLOAT;
     }
     else if (_texture->_dataType == GL_UNSIGNED_BYTE) {
-        _data = stbi_load(_fileName.c_str(), &_width, &_height, &compNb, WantedCompNb);
+        dataType = ImageCache::DataType::UNSIGNED_BYTE;
     }
     else {
         // TODO: replace this with logger
-        std::cerr << "Texture::Image::getData: Can't load image from file \"" << _fileName << "\"";
+        std::cerr << "Texture::Image::loadFile: Can't load image from file \"" << _fileName << "\"";
         std::cerr << ": Data type not supported" << std::endl;
         return false;
     }
 
-    if (_data == nullptr) {
+    _image = ImageCache::get(_fileName, WantedCompNb, dataType);
+    if (_image == nullptr) {
         // TODO: replace this with logger
-        std::cerr << "Texture::Image::getData: Failed to load texture \"" << _fileName << "\"" << std::endl;
+        std::cerr << "Texture::Image::loadFile: Failed to load texture \"" << _fileName << "\"" << std::endl;
         return false;
     }
-    else if (compNb != WantedCompNb) {
+    else if (_image->getFileComponentsNb() != WantedCompNb) {
         // TODO: replace this with logger
-        std::cerr << "Texture::Image::getData: Loaded image format do not correspond to given format for texture \"" << _fileName << "\"" << std::endl;
+        std::cerr << "Texture::Image::loadFile: Loaded image format do not correspond to given format for texture \"" << _fileName << "\"" << std::endl;
+    }
+
+    _width = _image->getWidth();
+    _height = _image->getHeight();
+
+    return true;
+}
+
+bool Texture::Image::getData(void*& data, GLsizei& width, GLsizei& height) {
+    data = nullptr;
+    width = _texture->_width;
+    height = _texture->_height;
+
+    // Data given by the caller
+    if (_externalData != nullptr) {
+        data = const_cast<void*>(_externalData);
+        width = _width;
+        height = _height;
+        return true;
+    }
+    // Don't need to load data
+    else if (_fileName.size() == 0) {
+        return true;
+    }
+
+    // Not loaded by the parallel decoding of Texture::build
+    if (!_fileLoaded) {
+        loadFile();
+    }
+    if (_image == nullptr) {
+        return false;
     }
 
     width = _width;
     height = _height;
-    data = _data;
+    data = const_cast<void*>(_image->getData());
 
     return true;
 }
@@ -88,6 +100,8 @@ bool Texture::build(API::Texture& texture) {
         return false;
     }
 
+    decodeImages();
+
     GLuint glTexture = 0;
     glGenTextures(1, &glTexture);
     glBindTexture(_type, glTexture);
@@ -95,6 +109,9 @@ bool Texture::build(API::Texture& texture) {
     GLsizei textureWidth = 0;
     GLsizei textureHeight = 0;
 
+    // The rows of the data are not aligned (the mipmaps rows can have any size)
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
     // Generate texture images
     for (Texture::Image& image: _images) {
         GLenum type = image._type;
@@ -108,9 +125,23 @@ bool Texture::build(API::Texture& texture) {
         if (!image.getData(data, width, height)) {
             // TODO: replace this with logger
             std::cerr << "Texture::build: Can't get image data" << std::endl;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
             return false;
         }
 
+        // The mipmaps are added after the level 0 images
+        if (image._level > 0) {
+            if (width != std::max(textureWidth >> image._level, 1) || height != std::max(textureHeight >> image._level, 1)) {
+                // TODO: replace this with logger
+                std::cerr << "Texture::build: Mipmap " << image._level << " doesn't have the size of the level 0 divided by 2^" << image._level << std::endl;
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+                return false;
+            }
+
+            glTexImage2D(type, image._level, _internalFormat, width, height, 0, _format, _dataType, data);
+            continue;
+        }
+
         // Check images have the same size
         if (!(!textureWidth && !textureHeight) &&
             (width != textureWidth || height != textureHeight)) {
@@ -118,15 +149,23 @@ bool Texture::build(API::Texture& texture) {
             std::cerr << "Texture::build: Images don't have the same size. ";
             std::cerr << "Image loaded with width " << textureWidth << " and height " << textureHeight;
             std::cerr << " but an other image has dimensions width " << width << " and height " << height << std::endl;
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
             return false;
         }
 
-        glTexImage2D(type, 0, _internalFormat, width, height, 0, _format, _dataType, data);
+        if (type == GL_TEXTURE_2D_ARRAY) {
+            glTexImage3D(type, 0, _internalFormat, width, height, _depth, 0, _format, _dataType, data);
+        }
+        else {
+            glTexImage2D(type, 0, _internalFormat, width, height, 0, _format, _dataType, data);
+        }
 
         textureWidth = width;
         textureHeight = height;
     }
 
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
     // Set texture parameters
     for (auto& param: _parameters) {
         glTexParameteri(_type, param.first, param.second);
@@ -147,6 +186,28 @@ bool Texture::build(API::Texture& texture) {
     return true;
 }
 
+void Texture::decodeImages() {
+    std::vector<Image*> fileImages;
+    for (Image& image: _images) {
+        if (image._externalData == nullptr && !image._fileName.empty()) {
+            fileImages.push_back(&image);
+        }
+    }
+
+    if (fileImages.size() < 2) {
+        return;
+    }
+
+    // The identical files are decoded once by the image cache, the other threads wait for it
+    // The errors are reported by getData
+    uint32_t threadsNb = std::min<uint32_t>(static_cast<uint32_t>(fileImages.size()), std::max(std::thread::hardware_concurrency(), 1u));
+    System::JobSystem jobSystem(threadsNb);
+
+    jobSystem.parallelFor(static_cast<uint32_t>(fileImages.size()), [&fileImages](uint32_t i) {
+        fileImages[i]->loadFile();
+    });
+}
+
 } // Namespace Builder
 } // Namespace API
 } // Namespace Graphics
@@ -0,0 +1,188 @@
+#include <future> // std::promise, std::shared_future
+#include <iostream> // std::cerr
+#include <map> // std::map
+#include <mutex> // std::mutex, std::lock_guard, std::unique_lock
+#include <tuple> // std::tie
+
+#include <sys/stat.h> // stat
+
+// Define STB_IMAGE_IMPLEMENTATION before stb_image.h to create the implementation
+// The failure reason is a global variable, it can't be written by several decoding threads
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_NO_FAILURE_STRINGS
+#include <stb_image.h>
+
+#include <System/Profiler.hpp> // PROFILE_SCOPE
+
+#include <Graphics/API/ImageCache.hpp> // Graphics::API::ImageCache
+
+namespace Graphics {
+namespace API {
+
+namespace {
+
+struct Key {
+    std::string fileName;
+    int64_t modificationTime;
+    int componentsNb;
+    ImageCache::DataType dataType;
+
+    bool operator<(const Key& key) const {
+        return std::tie(fileName, modificationTime, componentsNb, dataType) <
+            std::tie(key.fileName, key.modificationTime, key.componentsNb, key.dataType);
+    }
+};
+
+struct Entry {
+    std::weak_ptr<const ImageCache::Image> image;
+    // Valid while the image is decoded
+    std::shared_future<std::shared_ptr<const ImageCache::Image>> decoding;
+};
+
+} // Anonymous namespace
+
+static std::mutex entriesMutex;
+static std::map<Key, Entry> entries;
+static ImageCache::Statistics statistics = {0, 0};
+
+// -1 if the file doesn't exist, it will fail to decode
+static int64_t getModificationTime(const std::string& fileName) {
+    struct stat fileStat;
+    if (stat(fileName.c_str(), &fileStat) != 0) {
+        return -1;
+    }
+
+    return static_cast<int64_t>(fileStat.st_mtime);
+}
+
+// The caller locks entriesMutex
+// The images of the other modification times of an edited file are never requested again, their entries are removed here
+static void removeExpiredEntries() {
+    for (auto it = entries.begin(); it != entries.end();) {
+        if (it->second.image.expired() && !it->second.decoding.valid()) {
+            it = entries.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+ImageCache::Image::~Image() {
+    if (_data != nullptr) {
+        stbi_image_free(_data);
+    }
+}
+
+const void* ImageCache::Image::getData() const {
+    return _data;
+}
+
+int ImageCache::Image::getWidth() const {
+    return _width;
+}
+
+int ImageCache::Image::getHeight() const {
+    return _height;
+}
+
+int ImageCache::Image::getComponentsNb() const {
+    return _componentsNb;
+}
+
+int ImageCache::Image::getFileComponentsNb() const {
+    return _fileComponentsNb;
+}
+
+std::shared_ptr<const ImageCache::Image> ImageCache::get(const std::string& fileName, int componentsNb, DataType dataType) {
+    Key key = {fileName, getModificationTime(fileName), componentsNb, dataType};
+    std::promise<std::shared_ptr<const Image>> decoded;
+
+    {
+        std::unique_lock<std::mutex> lock(entriesMutex);
+        auto it = entries.find(key);
+
+        if (it != entries.end()) {
+            std::shared_ptr<const Image> image = it->second.image.lock();
+            if (image != nullptr) {
+                ++statistics.hits;
+                return image;
+            }
+
+            // Decoded by an other thread, wait for it
+            if (it->second.decoding.valid()) {
+                ++statistics.hits;
+                std::shared_future<std::shared_ptr<const Image>> decoding = it->second.decoding;
+
+                lock.unlock();
+                return decoding.get();
+            }
+        }
+
+        ++statistics.misses;
+        // Only the misses pay for the cleanup, they decode an image anyway
+        removeExpiredEntries();
+        entries[key].decoding = decoded.get_future().share();
+    }
+
+    std::shared_ptr<const Image> image = decode(fileName, componentsNb, dataType);
+
+    {
+        std::lock_guard<std::mutex> lock(entriesMutex);
+
+        // Not cached if the decoding failed, so the next get tries again
+        if (image == nullptr) {
+            entries.erase(key);
+        }
+        else {
+            Entry& entry = entries[key];
+            entry.image = image;
+            entry.decoding = std::shared_future<std::shared_ptr<const Image>>();
+        }
+    }
+
+    decoded.set_value(image);
+
+    return image;
+}
+
+ImageCache::Statistics ImageCache::getStatistics() {
+    std::lock_guard<std::mutex> lock(entriesMutex);
+    return statistics;
+}
+
+std::shared_ptr<const ImageCache::Image> ImageCache::decode(const std::string& fileName, int componentsNb, DataType dataType) {
+    PROFILE_SCOPE("ImageCache::decode");
+
+    std::shared_ptr<ImageCache::Image> image = std::make_shared<Image>();
+
+    int width = 0;
+    int height = 0;
+    int fileComponentsNb = 0;
+    void* data = nullptr;
+
+    // TODO: Use resources manager
+    if (dataType == DataType::FLOAT) {
+        data = stbi_loadf(fileName.c_str(), &width, &height, &fileComponentsNb, componentsNb);
+    }
+    else {
+        data = stbi_load(fileName.c_str(), &width, &height, &fileComponentsNb, componentsNb);
+    }
+
+    if (data == nullptr) {
+        // TODO: replace this with logger
+        std::cerr << "ImageCache::get: Failed to decode image \"" << fileName << "\"" << std::endl;
+        return nullptr;
+    }
+
+    image->_data = data;
+    image->_width = width;
+    image->_height = height;
+    image->_componentsNb = componentsNb;
+    image->_fileComponentsNb = fileComponentsNb;
+
+    return image;
+}
+
+} // Namespace API
+} // Namespace Graphics
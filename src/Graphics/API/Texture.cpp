@@ -68,6 +68,30 @@ void Texture::updateData(void* data, GLenum type) const {
     glTexImage2D(type, 0, _internalFormat, _width, _height, 0, _format, _dataType, data);
 }
 
+void Texture::updateLayer(
+    uint32_t layer,
+    uint32_t x,
+    uint32_t y,
+    uint32_t width,
+    uint32_t height,
+    uint32_t rowLength,
+    const void* data
+) const {
+    bind();
+
+    // The rows of a region are not aligned
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+    glTexSubImage3D(_type, 0, x, y, layer, width, height, 1, _format, _dataType, data);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+}
+
+void Texture::generateMipmaps() const {
+    bind();
+    glGenerateMipmap(_type);
+}
+
 uint32_t Texture::getWidth() const {
     return _width;
 }
@@ -1,3 +1,6 @@
+#include <algorithm> // std::min, std::max
+#include <limits> // std::numeric_limits
+
 #include <Graphics/Camera.hpp> // Graphics::Camera
 
 #include <Graphics/Frustum.hpp> // Graphics::Frustum
@@ -133,4 +136,54 @@ bool Frustum::isAABBInside(
     return true;
 }
 
+bool Frustum::isAABBInside(
+    const glm::vec3& posA,
+    const glm::vec3& posB,
+    const glm::vec3& posC,
+    const glm::vec3& posD,
+    const glm::vec3& posE,
+    const glm::vec3& posF,
+    const glm::vec3& posG,
+    const glm::vec3& posH,
+    float& margin
+) const {
+    // The box is outside if its farthest position in front of a plane is behind it
+    // The center is closer to the plane than the farthest position, its distance is used while it's in front
+    glm::vec3 center = (posA + posB + posC + posD + posE + posF + posG + posH) / 8.0f;
+    float insideMargin = std::numeric_limits<float>::max();
+    float outsideMargin = 0.0f;
+    bool inside = true;
+
+    for (auto& plane: _planes) {
+        float distance = plane.second.signedDistance(center);
+        if (distance >= 0) {
+            insideMargin = std::min(insideMargin, distance);
+            continue;
+        }
+
+        distance = std::max({
+            plane.second.signedDistance(posA),
+            plane.second.signedDistance(posB),
+            plane.second.signedDistance(posC),
+            plane.second.signedDistance(posD),
+            plane.second.signedDistance(posE),
+            plane.second.signedDistance(posF),
+            plane.second.signedDistance(posG),
+            plane.second.signedDistance(posH)
+        });
+
+        if (distance < 0) {
+            inside = false;
+            outsideMargin = std::max(outsideMargin, -distance);
+        }
+        else {
+            insideMargin = std::min(insideMargin, distance);
+        }
+    }
+
+    margin = inside ? insideMargin : outsideMargin;
+
+    return inside;
+}
+
 } // Namespace Graphics
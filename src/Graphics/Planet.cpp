@@ -0,0 +1,688 @@
+#include <array> // std::array
+#include <cmath> // std::exp2
+#include <iostream> // std::cerr
+#include <memory> // std::shared_ptr
+#include <vector> // std::vector
+
+#include <Core/GradientMapGenerator.hpp> // Core::GradientMapGenerator
+#include <Core/HeightMipChain.hpp> // Core::HeightMipChain
+#include <Graphics/API/Builder/Buffer.hpp> // Graphics::API::Builder::Buffer
+#include <Graphics/API/Builder/Texture.hpp> // Graphics::API::Builder::Texture
+#include <Graphics/Renderer.hpp> // Graphics::Renderer
+#include <System/Profiler.hpp> // PROFILE_SCOPE
+#include <System/JobSystem.hpp> // System::JobSystem
+
+#include <Graphics/Planet.hpp> // Graphics::Planet
+
+namespace Graphics {
+
+// Face size of the cube height map built from the height tiles, it's only used for the normals
+static constexpr uint32_t maxTilesCubeMapSize = 2048;
+// Tiles kept in the GPU tile cache, 34 MB with the default tile size
+static constexpr uint32_t tileCacheSlotsNb = 256;
+
+static GLint getInternalFormat(Core::TexelFormat::Height format) {
+    switch (format) {
+        case Core::TexelFormat::Height::R16:
+            return GL_R16;
+        case Core::TexelFormat::Height::R16F:
+            return GL_R16F;
+        case Core::TexelFormat::Height::R32F:
+        default:
+            return GL_R32F;
+    }
+}
+
+static GLenum getDataType(Core::TexelFormat::Height format) {
+    switch (format) {
+        case Core::TexelFormat::Height::R16:
+            return GL_UNSIGNED_SHORT;
+        case Core::TexelFormat::Height::R16F:
+            return GL_HALF_FLOAT;
+        case Core::TexelFormat::Height::R32F:
+        default:
+            return GL_FLOAT;
+    }
+}
+
+static GLint getInternalFormat(Core::TexelFormat::Gradient format) {
+    switch (format) {
+        case Core::TexelFormat::Gradient::RG16F:
+            return GL_RG16F;
+        case Core::TexelFormat::Gradient::RG32F:
+        default:
+            return GL_RG32F;
+    }
+}
+
+// Finest level of the tile set with all its tiles and a face size lower than maxTilesCubeMapSize
+static uint32_t getTilesCubeMapLevel(const Core::HeightTileSet& tileSet) {
+    for (uint32_t level = tileSet.getDescription().levelsNb; level-- > 1;) {
+        if (tileSet.getFaceSize(level) > maxTilesCubeMapSize) {
+            continue;
+        }
+
+        bool complete = true;
+        uint32_t tilesNb = 1u << level;
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb && complete; ++face) {
+            for (uint32_t i = 0; i < tilesNb * tilesNb && complete; ++i) {
+                complete = tileSet.hasTile(static_cast<Core::CubeMap::Face>(face), level, i % tilesNb, i / tilesNb);
+            }
+        }
+
+        if (complete) {
+            return level;
+        }
+    }
+
+    return 0;
+}
+
+// Copy the tiles of a level without their border, the heights are in [0, 1]
+static void readTilesLevel(const Core::HeightTileSet& tileSet, uint32_t level, Core::HeightMapGenerator::Faces& faces) {
+    const auto& description = tileSet.getDescription();
+    uint32_t faceSize = tileSet.getFaceSize(level);
+    uint32_t tileTexelsSize = tileSet.getTileTexelsSize();
+    uint32_t tilesNb = 1u << level;
+
+    std::vector<uint16_t> tile(static_cast<size_t>(tileTexelsSize) * tileTexelsSize);
+
+    for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+        faces[face].assign(static_cast<size_t>(faceSize) * faceSize, 0.0f);
+
+        for (uint32_t y = 0; y < tilesNb; ++y) {
+            for (uint32_t x = 0; x < tilesNb; ++x) {
+                if (!tileSet.readTile(static_cast<Core::CubeMap::Face>(face), level, x, y, tile.data())) {
+                    continue;
+                }
+
+                for (uint32_t row = 0; row < description.tileSize; ++row) {
+                    const uint16_t* src = tile.data() + static_cast<size_t>(row + description.border) * tileTexelsSize + description.border;
+                    float* dst = faces[face].data() + static_cast<size_t>(y * description.tileSize + row) * faceSize + x * description.tileSize;
+
+                    for (uint32_t column = 0; column < description.tileSize; ++column) {
+                        dst[column] = src[column] / 65535.0f;
+                    }
+                }
+            }
+        }
+    }
+}
+
+std::unique_ptr<Planet> Planet::create(
+    const Renderer* renderer,
+    float size,
+    float maxHeight,
+    const HeightMapSource& heightMapSource
+) {
+    // Don't use std::make_unique because the constructor is private
+    std::unique_ptr<Planet> planet(new Planet());
+
+    if (!planet->init(renderer, size, maxHeight, heightMapSource)) {
+        return nullptr;
+    }
+
+    return planet;
+}
+
+void Planet::update(Camera& camera) {
+    PROFILE_SCOPE("Planet::update");
+
+    _snapshot.heightTiles.clear();
+    _sphereQuadTree->update(camera, _snapshot);
+
+    upload(_snapshot);
+}
+
+void Planet::upload(const Core::SphereQuadTree::Snapshot& snapshot) {
+    PROFILE_SCOPE("Planet::upload");
+
+    uploadHeightTiles(snapshot.heightTiles);
+    uploadMesh(snapshot.mesh);
+    uploadDebugMesh(snapshot.debugMesh);
+}
+
+float Planet::getSize() const {
+    return _sphereQuadTree->getSize();
+}
+
+float Planet::getMaxHeight() const {
+    return _sphereQuadTree->getMaxHeight();
+}
+
+float Planet::getHeightMapLodScale() const {
+    // The quadtrees of the last levels split at a distance halved at each level, so the size of the displayed quads
+    // is proportional to their distance: the quads of the level l + 1 are displayed from the distance levelsTable[l] / 2,
+    // where they cover faceSize / 2^(l + 1) texels
+    // The LOD scale moves all the levels away or closer, the quads keep the same size in texels
+    const auto& levelsTable = _sphereQuadTree->getLevelsTable();
+    uint32_t level = static_cast<uint32_t>(levelsTable.size()) - 1;
+    float splitDistance = levelsTable[level] * _sphereQuadTree->getLodScale();
+
+    return static_cast<float>(_heightMap.getWidth()) / (std::exp2(static_cast<float>(level)) * splitDistance);
+}
+
+Core::SphereQuadTree& Planet::getSphereQuadTree() {
+    return *_sphereQuadTree;
+}
+
+const Core::SphereQuadTree& Planet::getSphereQuadTree() const {
+    return *_sphereQuadTree;
+}
+
+const API::Buffer& Planet::getBuffer() const {
+    return _buffer;
+}
+
+const API::Buffer& Planet::getDebugBuffer() const {
+    return _debugBuffer;
+}
+
+const API::Texture& Planet::getHeightMap() const {
+    return _heightMap;
+}
+
+const API::Texture& Planet::getGradientMap() const {
+    return _gradientMap;
+}
+
+bool Planet::hasVirtualHeightMap() const {
+    return _sphereQuadTree->getVirtualHeightMap() != nullptr;
+}
+
+const API::Texture& Planet::getHeightTiles() const {
+    return _heightTiles;
+}
+
+const API::Texture& Planet::getHeightIndirection() const {
+    return _heightIndirection;
+}
+
+const Core::VirtualHeightMap::Statistics& Planet::getHeightTilesStatistics() const {
+    return _heightTilesStatistics;
+}
+
+const Planet::HeightMapSource& Planet::getHeightMapSource() const {
+    return _heightMapSource;
+}
+
+void Planet::setMaxHeight(float maxHeight) {
+    _sphereQuadTree->setMaxHeight(maxHeight);
+}
+
+void Planet::setSize(float size) {
+    _sphereQuadTree->setSize(size);
+}
+
+bool Planet::setHeightMapSource(const HeightMapSource& heightMapSource) {
+    _heightMapSource = heightMapSource;
+
+    // The package replaces the planet size and max height, the height tiles are owned by the sphere quadtree
+    if (!_heightMapSource.packageFileName.empty() || _sphereQuadTree->getPackage() != nullptr ||
+        !_heightMapSource.tilesFileName.empty() || hasVirtualHeightMap()) {
+        if (!initSphereQuadTree(getSize(), getMaxHeight())) {
+            return false;
+        }
+    }
+
+    Core::HeightMapGenerator::Faces heights;
+    return initHeightMap(heights) && initGradientMap(heights) && initVirtualHeightMap();
+}
+
+bool Planet::init(const Renderer* renderer, float size, float maxHeight, const HeightMapSource& heightMapSource) {
+    _renderer = renderer;
+    _heightMapSource = heightMapSource;
+
+    Core::HeightMapGenerator::Faces heights;
+    return initSphereQuadTree(size, maxHeight) && initHeightMap(heights) && initGradientMap(heights) && initVirtualHeightMap() &&
+        initBuffer() && initDebugBuffer();
+}
+
+bool Planet::initSphereQuadTree(float size, float maxHeight) {
+    // The new sphere quadtree keeps the budget of the previous one
+    Core::LodBudget::Limits budgetLimits;
+    std::shared_ptr<Core::LodBudget> parentBudget = nullptr;
+    if (_sphereQuadTree != nullptr) {
+        budgetLimits = _sphereQuadTree->getBudget().getLimits();
+        parentBudget = _sphereQuadTree->getBudget().getParent();
+    }
+
+    if (!_heightMapSource.packageFileName.empty()) {
+        std::shared_ptr<const Core::PlanetPackage> package = Core::PlanetPackage::create(_heightMapSource.packageFileName);
+        if (package == nullptr) {
+            // TODO: replace this with logger
+            std::cerr << "Planet::initSphereQuadTree: failed to load package \"" << _heightMapSource.packageFileName << "\"" << std::endl;
+            return false;
+        }
+
+        _sphereQuadTree = Core::SphereQuadTree::create(std::move(package));
+    }
+    else {
+        _sphereQuadTree = Core::SphereQuadTree::create(size, maxHeight);
+    }
+
+    if (_sphereQuadTree == nullptr) {
+        // TODO: replace this with logger
+        std::cerr << "Planet::initSphereQuadTree: failed to create sphere quadtree" << std::endl;
+        return false;
+    }
+
+    _sphereQuadTree->getBudget().setLimits(budgetLimits);
+    _sphereQuadTree->getBudget().setParent(std::move(parentBudget));
+
+    if (_heightMapSource.packageFileName.empty() && !_heightMapSource.tilesFileName.empty()) {
+        std::shared_ptr<const Core::HeightTileSet> tileSet = Core::HeightTileSet::create(_heightMapSource.tilesFileName);
+        if (tileSet == nullptr) {
+            // TODO: replace this with logger
+            std::cerr << "Planet::initSphereQuadTree: failed to load height tiles \"" << _heightMapSource.tilesFileName << "\"" << std::endl;
+            return false;
+        }
+
+        std::unique_ptr<Core::VirtualHeightMap> virtualHeightMap = Core::VirtualHeightMap::create(std::move(tileSet), tileCacheSlotsNb);
+        if (virtualHeightMap == nullptr) {
+            // TODO: replace this with logger
+            std::cerr << "Planet::initSphereQuadTree: failed to create virtual height map" << std::endl;
+            return false;
+        }
+
+        _sphereQuadTree->setVirtualHeightMap(std::move(virtualHeightMap));
+    }
+
+    return true;
+}
+
+bool Planet::initHeightMap(Core::HeightMapGenerator::Faces& heights) {
+    PROFILE_SCOPE("Planet::initHeightMap");
+
+    API::Builder::Texture textureBuilder;
+
+    // Single channel, the shaders only read the red component
+    Core::TexelFormat::Height format = _heightMapSource.formats.heightMap;
+    textureBuilder.setType(GL_TEXTURE_CUBE_MAP);
+    textureBuilder.setInternalFormat(getInternalFormat(format));
+
+    System::JobSystem jobSystem;
+
+    // Must be kept until the texture is built
+    Core::HeightMipChain mipChain;
+    std::vector<std::vector<uint8_t>> texels;
+
+    // The heights in [0, 1] and their mipmaps are converted to the texture format, R32F levels are uploaded without copy
+    auto addFaces = [&textureBuilder, &jobSystem, &mipChain, &texels, format](const Core::HeightMipChain::Faces& faces, GLsizei size) {
+        textureBuilder.setFormat(GL_RED);
+        textureBuilder.setDataType(getDataType(format));
+
+        mipChain.generate(faces, size, jobSystem);
+
+        for (uint32_t level = 0; level < mipChain.getLevelsNb(); ++level) {
+            GLsizei levelSize = mipChain.getSize(level);
+            size_t texelsNb = static_cast<size_t>(levelSize) * levelSize;
+
+            for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+                const float* levelHeights = level == 0 ? faces[face] : mipChain.getHeights(static_cast<Core::CubeMap::Face>(face), level);
+                const void* data = levelHeights;
+
+                if (format != Core::TexelFormat::Height::R32F) {
+                    texels.emplace_back(texelsNb * Core::TexelFormat::getSize(format));
+                    Core::TexelFormat::encodeHeights(levelHeights, texelsNb, format, texels.back().data());
+                    data = texels.back().data();
+                }
+
+                textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, level)->setData(data, levelSize, levelSize);
+            }
+        }
+    };
+
+    const auto& package = _sphereQuadTree->getPackage();
+
+    // The faces are uploaded from the package mapping
+    if (package != nullptr) {
+        Core::HeightMipChain::Faces faces;
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            faces[face] = package->getHeights(static_cast<Core::CubeMap::Face>(face));
+        }
+
+        addFaces(faces, package->getFaceSize());
+    }
+    // The streamed tiles are displaced in the vertex shader, the cube height map is only used for the normals
+    else if (hasVirtualHeightMap()) {
+        const Core::HeightTileSet& tileSet = _sphereQuadTree->getVirtualHeightMap()->getTileSet();
+        uint32_t level = getTilesCubeMapLevel(tileSet);
+        uint32_t faceSize = tileSet.getFaceSize(level);
+
+        readTilesLevel(tileSet, level, heights);
+
+        Core::HeightMipChain::Faces faces;
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            faces[face] = heights[face].data();
+        }
+
+        addFaces(faces, faceSize);
+    }
+    else if (!_heightMapSource.fileName.empty()) {
+        // OpenGL converts the image to the texture format
+        textureBuilder.setFormat(GL_RGBA);
+        textureBuilder.setDataType(GL_FLOAT);
+
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face)->setFileName(_heightMapSource.fileName);
+        }
+    }
+    else {
+        Core::HeightMapGenerator generator(_heightMapSource.parameters);
+        generator.generate(heights, jobSystem);
+
+        Core::HeightMipChain::Faces faces;
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            faces[face] = heights[face].data();
+        }
+
+        addFaces(faces, _heightMapSource.parameters.size);
+    }
+
+    // The vertex shader chooses the mipmap, see getHeightMapLodScale
+    textureBuilder.setParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    textureBuilder.setParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    textureBuilder.setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    textureBuilder.setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    textureBuilder.setParameter(GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    if (!textureBuilder.build(_heightMap)) {
+        // TODO: replace this with logger
+        std::cerr << "Planet::initHeightMap: failed to create height map texture" << std::endl;
+        return false;
+    }
+
+    // The image heights are only on the GPU
+    if (mipChain.getLevelsNb() == 0) {
+        _heightMap.generateMipmaps();
+    }
+
+    return true;
+}
+
+bool Planet::initGradientMap(const Core::HeightMapGenerator::Faces& heights) {
+    PROFILE_SCOPE("Planet::initGradientMap");
+
+    API::Builder::Texture textureBuilder;
+
+    // Must be kept until the texture is built
+    Core::GradientMapGenerator::Faces gradients;
+
+    // The gradients don't depend on the max height, so the baked ones are always valid
+    const auto& package = _sphereQuadTree->getPackage();
+
+    textureBuilder.setType(GL_TEXTURE_CUBE_MAP);
+    textureBuilder.setInternalFormat(getInternalFormat(_heightMapSource.formats.gradientMap));
+    textureBuilder.setFormat(GL_RG);
+
+    if (package != nullptr) {
+        GLsizei size = package->getFaceSize();
+
+        // The package gradients are RG16F, OpenGL converts them if the texture is RG32F
+        textureBuilder.setDataType(GL_HALF_FLOAT);
+
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face)->setData(package->getGradients(static_cast<Core::CubeMap::Face>(face)), size, size);
+        }
+    }
+    else if (!heights[0].empty()) {
+        PROFILE_SCOPE("Planet::generateGradients");
+
+        GLsizei size = _heightMap.getWidth();
+        Core::GradientMapGenerator generator(static_cast<uint32_t>(size));
+        System::JobSystem jobSystem;
+        generator.generate(heights, gradients, jobSystem);
+
+        textureBuilder.setDataType(GL_FLOAT);
+
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face)->setData(gradients[face].data(), size, size);
+        }
+    }
+    else {
+        // The heights are only on the GPU
+        textureBuilder.setDataType(GL_UNSIGNED_BYTE);
+        textureBuilder.setWidth(_heightMap.getWidth());
+        textureBuilder.setHeight(_heightMap.getHeight());
+
+        for (uint32_t face = 0; face < Core::CubeMap::facesNb; ++face) {
+            textureBuilder.addImage(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face);
+        }
+    }
+
+    // The mipmaps average the gradients of the level 0, so the distant normals keep their slope
+    textureBuilder.setParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    textureBuilder.setParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    textureBuilder.setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    textureBuilder.setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    textureBuilder.setParameter(GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+
+    if (!textureBuilder.build(_gradientMap)) {
+        // TODO: replace this with logger
+        std::cerr << "Planet::initGradientMap: failed to create gradient map texture" << std::endl;
+        return false;
+    }
+
+    if (package == nullptr && heights[0].empty()) {
+        _renderer->createGradientMapFromHeightMap(_heightMap, _gradientMap);
+    }
+
+    _gradientMap.generateMipmaps();
+
+    return true;
+}
+
+bool Planet::initVirtualHeightMap() {
+    PROFILE_SCOPE("Planet::initVirtualHeightMap");
+
+    const Core::VirtualHeightMap* virtualHeightMap = _sphereQuadTree->getVirtualHeightMap();
+    if (virtualHeightMap == nullptr) {
+        _heightTiles.destroy();
+        _heightIndirection.destroy();
+        return true;
+    }
+
+    // The tiles are R16 like the tile set, linear filtering stays inside a tile thanks to its border
+    {
+        API::Builder::Texture textureBuilder;
+
+        textureBuilder.setType(GL_TEXTURE_2D_ARRAY);
+        textureBuilder.setInternalFormat(GL_R16);
+        textureBuilder.setFormat(GL_RED);
+        textureBuilder.setDataType(GL_UNSIGNED_SHORT);
+        textureBuilder.setWidth(virtualHeightMap->getSlotSize());
+        textureBuilder.setHeight(virtualHeightMap->getSlotSize());
+        textureBuilder.setDepth(virtualHeightMap->getSlotsNb());
+        textureBuilder.addImage();
+
+        textureBuilder.setParameter(GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        textureBuilder.setParameter(GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        textureBuilder.setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        textureBuilder.setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if (!textureBuilder.build(_heightTiles)) {
+            // TODO: replace this with logger
+            std::cerr << "Planet::initVirtualHeightMap: failed to create height tiles texture" << std::endl;
+            return false;
+        }
+    }
+
+    // Core::VirtualHeightMap::IndirectionEntry, read with texelFetch
+    {
+        API::Builder::Texture textureBuilder;
+
+        textureBuilder.setType(GL_TEXTURE_2D_ARRAY);
+        textureBuilder.setInternalFormat(GL_RG16UI);
+        textureBuilder.setFormat(GL_RG_INTEGER);
+        textureBuilder.setDataType(GL_UNSIGNED_SHORT);
+        textureBuilder.setWidth(virtualHeightMap->getIndirectionSize());
+        textureBuilder.setHeight(virtualHeightMap->getIndirectionSize());
+        textureBuilder.setDepth(Core::CubeMap::facesNb);
+        textureBuilder.addImage();
+
+        textureBuilder.setParameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        textureBuilder.setParameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        textureBuilder.setParameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        textureBuilder.setParameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        if (!textureBuilder.build(_heightIndirection)) {
+            // TODO: replace this with logger
+            std::cerr << "Planet::initVirtualHeightMap: failed to create height indirection texture" << std::endl;
+            return false;
+        }
+    }
+
+    // The level 0 tiles and the whole indirection table
+    Core::VirtualHeightMap::Uploads uploads;
+    virtualHeightMap->addUploads(uploads);
+    uploadHeightTiles(uploads);
+
+    return true;
+}
+
+bool Planet::initBuffer() {
+    API::Builder::Buffer bufferBuilder;
+
+    // Cube position attribute
+    bufferBuilder.addAttribute({
+        0,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Core::QuadTree::Vertex),
+        offsetof(Core::QuadTree::Vertex, cubePos)
+    });
+    // Sphere position attribute
+    bufferBuilder.addAttribute({
+        1,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Core::QuadTree::Vertex),
+        offsetof(Core::QuadTree::Vertex, spherePos)
+    });
+    // Width direction attribute
+    bufferBuilder.addAttribute({
+        2,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Core::QuadTree::Vertex),
+        offsetof(Core::QuadTree::Vertex, widthDir)
+    });
+    // Height direction attribute
+    bufferBuilder.addAttribute({
+        3,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Core::QuadTree::Vertex),
+        offsetof(Core::QuadTree::Vertex, heightDir)
+    });
+    // QuadTree level attribute
+    bufferBuilder.addAttribute({
+        4,
+        1,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(Core::QuadTree::Vertex),
+        offsetof(Core::QuadTree::Vertex, quadTreeLevel)
+    });
+
+    bufferBuilder.setVerticesUsage(GL_DYNAMIC_DRAW);
+    bufferBuilder.setIndicesUsage(GL_DYNAMIC_DRAW);
+
+    if (!bufferBuilder.build(_buffer)) {
+        // TODO: replace this with logger
+        std::cerr << "Planet::initBuffer: failed to create VAO" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool Planet::initDebugBuffer() {
+    API::Builder::Buffer bufferBuilder;
+
+    // Position attribute
+    bufferBuilder.addAttribute({
+        0,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(glm::vec3),
+        0
+    });
+
+    bufferBuilder.setVerticesUsage(GL_DYNAMIC_DRAW);
+    bufferBuilder.setIndicesUsage(GL_DYNAMIC_DRAW);
+
+    if (!bufferBuilder.build(_debugBuffer)) {
+        // TODO: replace this with logger
+        std::cerr << "Planet::initDebugBuffer: failed to create VAO" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+void Planet::uploadMesh(const Core::SphereQuadTree::Mesh<Core::QuadTree::Vertex>& mesh) {
+    _buffer.updateVertices(
+        (char*)mesh.vertices.data(),
+        mesh.vertices.size() * sizeof(Core::QuadTree::Vertex),
+        mesh.vertices.size(),
+        GL_DYNAMIC_DRAW
+        );
+    _buffer.updateIndices(
+        (char*)mesh.indices.data(),
+        mesh.indices.size() * sizeof(uint32_t),
+        mesh.indices.size(),
+        GL_DYNAMIC_DRAW
+        );
+}
+
+void Planet::uploadHeightTiles(const Core::VirtualHeightMap::Uploads& uploads) {
+    const Core::VirtualHeightMap* virtualHeightMap = _sphereQuadTree->getVirtualHeightMap();
+    if (virtualHeightMap == nullptr) {
+        return;
+    }
+
+    // A slot loaded twice is uploaded twice, the last tile stays in it
+    uint32_t slotSize = virtualHeightMap->getSlotSize();
+    for (const auto& slot: uploads.slots) {
+        _heightTiles.updateLayer(slot.slot, 0, 0, slotSize, slotSize, slotSize, slot.texels.data());
+    }
+
+    for (const auto& indirection: uploads.indirections) {
+        const auto& rect = indirection.rect;
+        _heightIndirection.updateLayer(
+            static_cast<uint32_t>(indirection.face),
+            rect.xMin,
+            rect.yMin,
+            rect.xMax - rect.xMin,
+            rect.yMax - rect.yMin,
+            rect.xMax - rect.xMin,
+            indirection.entries.data()
+        );
+    }
+
+    _heightTilesStatistics = uploads.statistics;
+}
+
+void Planet::uploadDebugMesh(const Core::SphereQuadTree::Mesh<glm::vec3>& mesh) {
+    _debugBuffer.updateVertices(
+        (char*)mesh.vertices.data(),
+        mesh.vertices.size() * sizeof(glm::vec3),
+        mesh.vertices.size(),
+        GL_DYNAMIC_DRAW
+        );
+    _debugBuffer.updateIndices(
+        (char*)mesh.indices.data(),
+        mesh.indices.size() * sizeof(uint32_t),
+        mesh.indices.size(),
+        GL_DYNAMIC_DRAW
+        );
+}
+
+} // Namespace Graphics
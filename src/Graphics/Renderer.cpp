@@ -2,19 +2,19 @@
 
 #include <glm/gtc/type_ptr.hpp> // glm::value_ptr
 
+#include <Graphics/API/Builder/Buffer.hpp> // Graphics::API::Builder::Buffer
 #include <Graphics/API/Builder/Framebuffer.hpp> // Graphics::API::Builder::Framebuffer
 #include <Graphics/API/Builder/ShaderProgram.hpp> // Graphics::API::Builder::ShaderProgram
 #include <Graphics/API/Framebuffer.hpp> // Graphics::API::Framebuffer
+#include <System/Profiler.hpp> // PROFILE_SCOPE
 
 #include <Graphics/Renderer.hpp> // Graphics::Renderer
 
 namespace Graphics {
 
-Renderer::Renderer(const Window::Window* window): _window(window) {}
-
-std::unique_ptr<Renderer> Renderer::create(const Window::Window* window) {
+std::unique_ptr<Renderer> Renderer::create() {
     // Don't use std::make_unique because the constructor is private
-    std::unique_ptr<Renderer> renderer(new Renderer(window));
+    std::unique_ptr<Renderer> renderer(new Renderer());
 
     if (!renderer->init()) {
         return nullptr;
@@ -23,10 +23,14 @@ std::unique_ptr<Renderer> Renderer::create(const Window::Window* window) {
     return renderer;
 }
 
-void Renderer::render(Camera& camera, const std::vector<std::unique_ptr<Core::SphereQuadTree>>& planets) {
+void Renderer::render(Camera& camera, const std::vector<std::unique_ptr<Planet>>& planets) {
+    PROFILE_SCOPE("Renderer::render");
+
     if (!_debug.wireframeDisplayed()) {
         glUniform1i(_mainShaderProgram.getUniformLocation("heightMap"), 0);
-        glUniform1i(_mainShaderProgram.getUniformLocation("normalMap"), 1);
+        glUniform1i(_mainShaderProgram.getUniformLocation("gradientMap"), 1);
+        glUniform1i(_mainShaderProgram.getUniformLocation("heightTiles"), 2);
+        glUniform1i(_mainShaderProgram.getUniformLocation("heightIndirection"), 3);
         renderPlanets(_mainShaderProgram, camera, planets);
     }
 
@@ -35,7 +39,9 @@ void Renderer::render(Camera& camera, const std::vector<std::unique_ptr<Core::Sp
         _debugShaderProgram.use();
 
         glUniform1i(_debugShaderProgram.getUniformLocation("heightMap"), 0);
-        glUniform1i(_debugShaderProgram.getUniformLocation("normalMap"), 1);
+        glUniform1i(_debugShaderProgram.getUniformLocation("gradientMap"), 1);
+        glUniform1i(_debugShaderProgram.getUniformLocation("heightTiles"), 2);
+        glUniform1i(_debugShaderProgram.getUniformLocation("heightIndirection"), 3);
 
         glUniform1i(_debugShaderProgram.getUniformLocation("wireframeDisplayed"), _debug.wireframeDisplayed());
         glUniform1i(_debugShaderProgram.getUniformLocation("verticesNormalsDisplayed"), _debug.verticesNormalsDisplayed());
@@ -57,55 +63,40 @@ Debug& Renderer::getDebug() {
     return _debug;
 }
 
-void Renderer::createNormalMapFromHeightMap(const API::Texture& heightMap, const API::Texture& normalMap, float maxHeight) const {
-    static Graphics::API::Framebuffer* fbo = nullptr;
-
-    // Init framebuffer
-    // TODO: Move in SphereQuadTree to prevent recreating the color attachments array ?
-    if (!fbo) {
-        fbo = new Graphics::API::Framebuffer();
-        Graphics::API::Builder::Framebuffer framebufferBuilder;
+void Renderer::createGradientMapFromHeightMap(const API::Texture& heightMap, const API::Texture& gradientMap) const {
+    // Save viewport to restore it after the gradient map rendering
+    GLint viewport[4] = {};
+    glGetIntegerv(GL_VIEWPORT, viewport);
 
-        framebufferBuilder.build(*fbo);
-    }
-
-    fbo->bind();
+    _gradientMapFramebuffer.bind();
 
     // Update color attachments
-    fbo->removeColorAttachments();
+    _gradientMapFramebuffer.removeColorAttachments();
     for (int i = 0; i < 6; ++i) {
-        fbo->addColorAttachment(&normalMap, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
+        _gradientMapFramebuffer.addColorAttachment(&gradientMap, GL_TEXTURE_CUBE_MAP_POSITIVE_X + i);
     }
 
     // Use the framebuffer to specify the attachments used in the fragment shader
-    fbo->use();
+    _gradientMapFramebuffer.use();
 
-    _normalMapShaderProgram.use();
+    _gradientMapShaderProgram.use();
 
-    glUniform1f(_normalMapShaderProgram.getUniformLocation("maxHeight"), maxHeight);
-    glUniform1f(_normalMapShaderProgram.getUniformLocation("imageSize"), (GLfloat)normalMap.getWidth());
+    glUniform1f(_gradientMapShaderProgram.getUniformLocation("imageSize"), (GLfloat)gradientMap.getWidth());
 
-    // Bind height map for read
-    glBindImageTexture(
-        0,
-        static_cast<GLuint>(heightMap),
-        0,
-        GL_TRUE,
-        0,
-        GL_READ_ONLY,
-        GL_RGBA32F
-    );
+    // Bind height map for read, it's sampled so any format can be used
+    heightMap.bind(GL_TEXTURE0);
 
-    glViewport(0, 0, normalMap.getWidth(), normalMap.getWidth());
+    glViewport(0, 0, gradientMap.getWidth(), gradientMap.getWidth());
 
-    // Render the normal map
+    // Render the gradient map
+    _screenTriangleBuffer.bind();
     glDrawArrays(GL_TRIANGLES, 0, 3);
 
-    fbo->unBind();
+    _gradientMapFramebuffer.unBind();
     _mainShaderProgram.use();
 
     // Reset viewport
-    glViewport(0, 0, _window->getSize().x, _window->getSize().y);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
 }
 
 bool Renderer::init() {
@@ -117,10 +108,10 @@ bool Renderer::init() {
     glEnable(GL_CULL_FACE);
     glCullFace(GL_BACK);
 
-    return initShaderProgram();
+    return initShaderProgram() && initScreenTriangleBuffer() && initGradientMapFramebuffer();
 }
 
-void Renderer::renderPlanets(API::ShaderProgram& shaderProgram, Camera& camera, const std::vector<std::unique_ptr<Core::SphereQuadTree>>& planets) {
+void Renderer::renderPlanets(API::ShaderProgram& shaderProgram, Camera& camera, const std::vector<std::unique_ptr<Planet>>& planets) {
     glUniformMatrix4fv(shaderProgram.getUniformLocation("view"),
         1,
         GL_FALSE,
@@ -129,13 +120,27 @@ void Renderer::renderPlanets(API::ShaderProgram& shaderProgram, Camera& camera,
         1,
         GL_FALSE,
         glm::value_ptr(camera.getProj()));
+    glUniform3fv(shaderProgram.getUniformLocation("cameraPos"), 1, glm::value_ptr(camera.getPos()));
 
     for (const auto& planet: planets) {
         glUniform1f(shaderProgram.getUniformLocation("planetSize"), planet->getSize());
         glUniform1f(shaderProgram.getUniformLocation("maxHeight"), planet->getMaxHeight());
+        glUniform1f(shaderProgram.getUniformLocation("heightMapLodScale"), planet->getHeightMapLodScale());
         planet->getBuffer().bind();
         planet->getHeightMap().bind(GL_TEXTURE0);
-        planet->getNormalMap().bind(GL_TEXTURE1);
+        planet->getGradientMap().bind(GL_TEXTURE1);
+
+        // The vertices are displaced with the streamed tiles
+        bool virtualHeightMap = planet->hasVirtualHeightMap();
+        glUniform1i(shaderProgram.getUniformLocation("virtualHeightMap"), virtualHeightMap);
+        if (virtualHeightMap) {
+            const auto& description = planet->getSphereQuadTree().getVirtualHeightMap()->getTileSet().getDescription();
+            glUniform1f(shaderProgram.getUniformLocation("heightTileSize"), (GLfloat)description.tileSize);
+            glUniform1f(shaderProgram.getUniformLocation("heightTileBorder"), (GLfloat)description.border);
+            planet->getHeightTiles().bind(GL_TEXTURE2);
+            planet->getHeightIndirection().bind(GL_TEXTURE3);
+        }
+
         glDrawElements(
             GL_TRIANGLES,
             (GLuint)planet->getBuffer().getIndicesNb(),
@@ -145,7 +150,7 @@ void Renderer::renderPlanets(API::ShaderProgram& shaderProgram, Camera& camera,
     }
 }
 
-void Renderer::renderPlanetsAABBDebug(Camera& camera, const std::vector<std::unique_ptr<Core::SphereQuadTree>>& planets) {
+void Renderer::renderPlanetsAABBDebug(Camera& camera, const std::vector<std::unique_ptr<Planet>>& planets) {
     // Disable back culling to see AABB when we are inside it
     // Setup blending
     glDisable(GL_CULL_FACE);
@@ -241,28 +246,55 @@ bool Renderer::initShaderProgram() {
     {
         API::Builder::ShaderProgram shaderProgramBuilder;
         if (!shaderProgramBuilder.setShader(GL_VERTEX_SHADER, "resources/shaders/screen-triangle.vert") ||
-            !shaderProgramBuilder.setShader(GL_FRAGMENT_SHADER, "resources/shaders/normal.frag")) {
+            !shaderProgramBuilder.setShader(GL_FRAGMENT_SHADER, "resources/shaders/gradient.frag")) {
             // TODO: replace this with logger
-            std::cerr << "Renderer::init: Can't init normal map shaders" << std::endl;
+            std::cerr << "Renderer::init: Can't init gradient map shaders" << std::endl;
             return false;
         }
 
-        if (!shaderProgramBuilder.build(_normalMapShaderProgram)) {
+        if (!shaderProgramBuilder.build(_gradientMapShaderProgram)) {
             // TODO: replace this with logger
-            std::cerr << "Renderer::init: Can't create normal map shader program" << std::endl;
+            std::cerr << "Renderer::init: Can't create gradient map shader program" << std::endl;
             return false;
         }
     }
 
-    // Make the ShaderProgram store "maxHeight" and "imageSize" locations because it's used in Renderer::createNormalMapFromHeightMap
+    // Make the ShaderProgram store the "imageSize" location because it's used in Renderer::createGradientMapFromHeightMap
     // which is const and can't modify the ShaderProgram
-    _normalMapShaderProgram.getUniformLocation("maxHeight");
-    _normalMapShaderProgram.getUniformLocation("imageSize");
+    _gradientMapShaderProgram.getUniformLocation("imageSize");
+
+    _gradientMapShaderProgram.use();
+
+    glUniform1i(_gradientMapShaderProgram.getUniformLocation("heightMap"), 0);
 
     _mainShaderProgram.use();
 
     glUniform1i(_mainShaderProgram.getUniformLocation("heightMap"), 0);
-    glUniform1i(_mainShaderProgram.getUniformLocation("normalMap"), 1);
+    glUniform1i(_mainShaderProgram.getUniformLocation("gradientMap"), 1);
+
+    return true;
+}
+
+bool Renderer::initScreenTriangleBuffer() {
+    Graphics::API::Builder::Buffer bufferBuilder;
+
+    if (!bufferBuilder.build(_screenTriangleBuffer)) {
+        // TODO: replace this with logger
+        std::cerr << "Renderer::init: Can't create screen triangle VAO" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool Renderer::initGradientMapFramebuffer() {
+    Graphics::API::Builder::Framebuffer framebufferBuilder;
+
+    if (!framebufferBuilder.build(_gradientMapFramebuffer)) {
+        // TODO: replace this with logger
+        std::cerr << "Renderer::init: Can't create gradient map framebuffer" << std::endl;
+        return false;
+    }
 
     return true;
 }
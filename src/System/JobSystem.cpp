@@ -0,0 +1,206 @@
+#include <algorithm> // std::max
+#include <string> // std::to_string
+#include <utility> // std::move
+
+#if defined(__linux__)
+    #include <pthread.h> // pthread_setaffinity_np, pthread_setname_np
+    #include <sched.h> // cpu_set_t, CPU_ZERO, CPU_SET
+#endif
+
+#include <System/Profiler.hpp> // System::Profiler
+
+#include <System/JobSystem.hpp> // System::JobSystem
+
+namespace System {
+
+// Job system and queue of the calling thread, if it's a worker
+static thread_local const JobSystem* currentJobSystem = nullptr;
+static thread_local uint32_t currentQueueIndex = 0;
+
+bool JobSystem::Counter::isDone() const {
+    return _jobsNb.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem(uint32_t threadsNb) {
+    Options options;
+    options.threadsNb = threadsNb;
+
+    init(options);
+}
+
+JobSystem::JobSystem(const Options& options) {
+    init(options);
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto& worker: _workers) {
+        worker.join();
+    }
+}
+
+uint32_t JobSystem::getThreadsNb() const {
+    return static_cast<uint32_t>(_workers.size()) + 1;
+}
+
+void JobSystem::run(Job job, Counter& counter) {
+    counter._jobsNb.fetch_add(1, std::memory_order_relaxed);
+
+    Queue& queue = *_queues[getQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back({std::move(job), &counter});
+        _queuedJobsNb.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // The workers check _queuedJobsNb with _sleepMutex locked, so they can't miss the notification
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+void JobSystem::wait(Counter& counter) {
+    uint32_t queueIndex = getQueueIndex();
+
+    while (!counter.isDone()) {
+        if (!runJob(queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(uint32_t jobsNb, const std::function<void(uint32_t)>& job, uint32_t grainSize) {
+    grainSize = std::max(grainSize, 1u);
+
+    if (_workers.empty() || jobsNb <= grainSize) {
+        for (uint32_t i = 0; i < jobsNb; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    Counter counter;
+    runRange(0, jobsNb, job, grainSize, counter);
+    wait(counter);
+}
+
+void JobSystem::init(const Options& options) {
+    uint32_t threadsNb = options.threadsNb;
+    if (threadsNb == 0) {
+        threadsNb = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    for (uint32_t i = 0; i < threadsNb; ++i) {
+        _queues.push_back(std::unique_ptr<Queue>(new Queue()));
+    }
+
+    for (uint32_t i = 0; i + 1 < threadsNb; ++i) {
+        _workers.emplace_back(&JobSystem::work, this, i, options);
+    }
+}
+
+void JobSystem::work(uint32_t workerId, const Options& options) {
+    std::string name = options.name + " " + std::to_string(workerId);
+    Profiler::setThreadName(name);
+
+#if defined(__linux__)
+    // The names are limited to 15 characters
+    pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+
+    if (options.affinity) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET((workerId + 1) % std::max(std::thread::hardware_concurrency(), 1u), &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#endif
+
+    currentJobSystem = this;
+    currentQueueIndex = workerId + 1;
+
+    while (true) {
+        if (runJob(currentQueueIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this]() { return _stop || _queuedJobsNb.load(std::memory_order_relaxed) > 0; });
+
+        if (_stop) {
+            return;
+        }
+    }
+}
+
+uint32_t JobSystem::getQueueIndex() const {
+    return currentJobSystem == this ? currentQueueIndex : 0;
+}
+
+bool JobSystem::popJob(uint32_t queueIndex, QueuedJob& job) {
+    // Last pushed job of the thread queue, its data is still in the cache
+    {
+        Queue& queue = *_queues[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            _queuedJobsNb.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // Oldest job of an other queue, the biggest one for a parallelFor
+    uint32_t queuesNb = static_cast<uint32_t>(_queues.size());
+    for (uint32_t i = 1; i < queuesNb; ++i) {
+        Queue& queue = *_queues[(queueIndex + i) % queuesNb];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            _queuedJobsNb.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool JobSystem::runJob(uint32_t queueIndex) {
+    QueuedJob job;
+    if (!popJob(queueIndex, job)) {
+        return false;
+    }
+
+    job.job();
+    // Release the writes of the job to the thread waiting for the counter
+    job.counter->_jobsNb.fetch_sub(1, std::memory_order_release);
+
+    return true;
+}
+
+void JobSystem::runRange(uint32_t begin, uint32_t end, const std::function<void(uint32_t)>& job, uint32_t grainSize, Counter& counter) {
+    // Give the second half to the other threads until the range is small enough
+    while (end - begin > grainSize) {
+        uint32_t middle = begin + (end - begin) / 2;
+
+        run([this, middle, end, &job, grainSize, &counter]() {
+            runRange(middle, end, job, grainSize, counter);
+        }, counter);
+
+        end = middle;
+    }
+
+    for (uint32_t i = begin; i < end; ++i) {
+        job(i);
+    }
+}
+
+} // Namespace System
@@ -0,0 +1,110 @@
+#include <iostream> // std::cerr
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h> // CreateFileA, CreateFileMappingA, MapViewOfFile
+#else
+    #include <fcntl.h> // open
+    #include <sys/mman.h> // mmap, munmap
+    #include <sys/stat.h> // fstat
+    #include <unistd.h> // close
+#endif
+
+#include <System/MappedFile.hpp> // System::MappedFile
+
+namespace System {
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+    if (_data != nullptr) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mapping != nullptr) {
+        CloseHandle(_mapping);
+    }
+    if (_file != nullptr) {
+        CloseHandle(_file);
+    }
+#else
+    if (_data != nullptr) {
+        munmap(const_cast<void*>(_data), _size);
+    }
+#endif
+}
+
+std::unique_ptr<MappedFile> MappedFile::create(const std::string& fileName) {
+    // Don't use std::make_unique because the constructor is private
+    std::unique_ptr<MappedFile> file(new MappedFile());
+
+    if (!file->init(fileName)) {
+        return nullptr;
+    }
+
+    return file;
+}
+
+const void* MappedFile::getData() const {
+    return _data;
+}
+
+size_t MappedFile::getSize() const {
+    return _size;
+}
+
+bool MappedFile::init(const std::string& fileName) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        // TODO: replace this with logger
+        std::cerr << "MappedFile::init: Can't open \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+    _file = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        // TODO: replace this with logger
+        std::cerr << "MappedFile::init: \"" << fileName << "\" is empty" << std::endl;
+        return false;
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+
+    _mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (_mapping != nullptr) {
+        _data = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+#else
+    int file = open(fileName.c_str(), O_RDONLY);
+    if (file < 0) {
+        // TODO: replace this with logger
+        std::cerr << "MappedFile::init: Can't open \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(file, &fileStat) != 0 || fileStat.st_size == 0) {
+        // TODO: replace this with logger
+        std::cerr << "MappedFile::init: \"" << fileName << "\" is empty" << std::endl;
+        close(file);
+        return false;
+    }
+    _size = static_cast<size_t>(fileStat.st_size);
+
+    // The mapping stays valid after the file is closed
+    void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    _data = data != MAP_FAILED ? data : nullptr;
+#endif
+
+    if (_data == nullptr) {
+        // TODO: replace this with logger
+        std::cerr << "MappedFile::init: Can't map \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+} // Namespace System
@@ -0,0 +1,228 @@
+#include <algorithm> // std::sort
+#include <array> // std::array
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::steady_clock
+#include <fstream> // std::ofstream
+#include <iostream> // std::cerr
+#include <mutex> // std::mutex, std::lock_guard
+
+#include <System/Profiler.hpp> // System::Profiler
+
+namespace System {
+
+/*
+ * Ring buffer of one thread
+ * Only the owner thread writes the zones, the fields are atomics so they can be read by other threads
+ * A zone is valid for the readers once writeIndex is incremented
+*/
+struct Profiler::ThreadBuffer {
+    struct Entry {
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> start{0};
+        std::atomic<uint64_t> end{0};
+        std::atomic<uint32_t> depth{0};
+    };
+
+    std::array<Entry, zonesCapacity> entries;
+    std::atomic<uint64_t> writeIndex{0};
+
+    // Only used by the owner thread
+    uint32_t depth = 0;
+
+    uint32_t id = 0;
+    std::string name;
+};
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+static std::mutex threadBuffersMutex;
+
+static std::array<std::atomic<uint64_t>, Profiler::framesCapacity> framesStart;
+static std::atomic<uint64_t> framesNb{0};
+
+Profiler::ScopedZone::ScopedZone(const char* name): _name(name), _start(getTime()) {
+    ++getThreadBuffer().depth;
+}
+
+Profiler::ScopedZone::~ScopedZone() {
+    uint64_t end = getTime();
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    --buffer.depth;
+
+    uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+    ThreadBuffer::Entry& entry = buffer.entries[index % zonesCapacity];
+
+    entry.name.store(_name, std::memory_order_relaxed);
+    entry.start.store(_start, std::memory_order_relaxed);
+    entry.end.store(end, std::memory_order_relaxed);
+    entry.depth.store(buffer.depth, std::memory_order_relaxed);
+
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+uint64_t Profiler::getTime() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - startTime
+    ).count();
+}
+
+void Profiler::newFrame() {
+    uint64_t frame = framesNb.load(std::memory_order_relaxed);
+
+    framesStart[frame % framesCapacity].store(getTime(), std::memory_order_relaxed);
+    framesNb.store(frame + 1, std::memory_order_release);
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+    buffer.name = name;
+}
+
+void Profiler::getFrames(uint32_t framesNbRequested, std::vector<uint64_t>& framesTimes, std::vector<Zone>& zones) {
+    framesTimes.clear();
+    zones.clear();
+
+    uint64_t lastFrame = framesNb.load(std::memory_order_acquire);
+    if (lastFrame < 2) {
+        return;
+    }
+
+    // The frame started by the last newFrame is not finished
+    uint64_t finishedFramesNb = std::min<uint64_t>(lastFrame - 1, framesCapacity - 1);
+    uint64_t requestedFramesNb = std::min<uint64_t>(framesNbRequested, finishedFramesNb);
+
+    for (uint64_t frame = lastFrame - requestedFramesNb - 1; frame < lastFrame; ++frame) {
+        framesTimes.push_back(framesStart[frame % framesCapacity].load(std::memory_order_relaxed));
+    }
+
+    getZones(framesTimes.front(), framesTimes.back(), zones);
+}
+
+std::vector<Profiler::Thread> Profiler::getThreads() {
+    std::vector<Thread> threads;
+
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+    for (const auto& buffer: getThreadBuffers()) {
+        threads.push_back({buffer->id, buffer->name});
+    }
+
+    return threads;
+}
+
+bool Profiler::exportChromeTrace(const std::string& fileName) {
+    std::ofstream file(fileName);
+    if (!file.good()) {
+        // TODO: replace this with logger
+        std::cerr << "Profiler::exportChromeTrace: Can't open \"" << fileName << "\"" << std::endl;
+        return false;
+    }
+
+    std::vector<Zone> zones;
+    getZones(0, UINT64_MAX, zones);
+
+    bool first = true;
+    auto separator = [&file, &first]() {
+        file << (first ? "\n" : ",\n");
+        first = false;
+    };
+
+    // Timestamps are in microseconds
+    file << "{\"traceEvents\": [";
+
+    for (const auto& thread: getThreads()) {
+        separator();
+        file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << thread.id
+            << ", \"args\": {\"name\": \"" << (thread.name.empty() ? "Thread " + std::to_string(thread.id) : thread.name) << "\"}}";
+    }
+
+    uint64_t lastFrame = framesNb.load(std::memory_order_acquire);
+    uint64_t firstFrame = lastFrame > framesCapacity ? lastFrame - framesCapacity : 0;
+    for (uint64_t frame = firstFrame; frame < lastFrame; ++frame) {
+        separator();
+        file << "{\"name\": \"Frame\", \"ph\": \"i\", \"s\": \"g\", \"pid\": 0, \"tid\": 0, \"ts\": "
+            << framesStart[frame % framesCapacity].load(std::memory_order_relaxed) / 1000.0 << "}";
+    }
+
+    for (const auto& zone: zones) {
+        separator();
+        file << "{\"name\": \"" << zone.name << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << zone.threadId
+            << ", \"ts\": " << zone.start / 1000.0
+            << ", \"dur\": " << (zone.end - zone.start) / 1000.0 << "}";
+    }
+
+    file << "\n]}" << std::endl;
+
+    return file.good();
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer() {
+    thread_local ThreadBuffer* threadBuffer = nullptr;
+
+    if (threadBuffer == nullptr) {
+        std::unique_ptr<ThreadBuffer> buffer(new ThreadBuffer());
+
+        std::lock_guard<std::mutex> lock(threadBuffersMutex);
+        auto& threadBuffers = getThreadBuffers();
+
+        buffer->id = static_cast<uint32_t>(threadBuffers.size());
+        threadBuffer = buffer.get();
+        threadBuffers.push_back(std::move(buffer));
+    }
+
+    return *threadBuffer;
+}
+
+// The thread buffers are never destroyed, the zones of finished threads can still be exported
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>>& Profiler::getThreadBuffers() {
+    static std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+    return threadBuffers;
+}
+
+void Profiler::getZones(uint64_t start, uint64_t end, std::vector<Zone>& zones) {
+    std::lock_guard<std::mutex> lock(threadBuffersMutex);
+
+    for (const auto& buffer: getThreadBuffers()) {
+        size_t threadZonesBegin = zones.size();
+
+        uint64_t writeIndex = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t firstIndex = writeIndex > zonesCapacity ? writeIndex - zonesCapacity : 0;
+
+        std::vector<uint64_t> indices;
+        for (uint64_t index = firstIndex; index < writeIndex; ++index) {
+            const ThreadBuffer::Entry& entry = buffer->entries[index % zonesCapacity];
+
+            Zone zone;
+            zone.name = entry.name.load(std::memory_order_relaxed);
+            zone.start = entry.start.load(std::memory_order_relaxed);
+            zone.end = entry.end.load(std::memory_order_relaxed);
+            zone.depth = entry.depth.load(std::memory_order_relaxed);
+            zone.threadId = buffer->id;
+
+            if (zone.end >= start && zone.start <= end) {
+                zones.push_back(zone);
+                indices.push_back(index);
+            }
+        }
+
+        // Remove the zones overwritten by the owner thread while they were read
+        // (the entry at writeIndex - zonesCapacity can be in the middle of a write)
+        uint64_t newWriteIndex = buffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t firstValidIndex = newWriteIndex + 1 > zonesCapacity ? newWriteIndex + 1 - zonesCapacity : 0;
+
+        size_t validZonesBegin = threadZonesBegin;
+        while (validZonesBegin < zones.size() && indices[validZonesBegin - threadZonesBegin] < firstValidIndex) {
+            ++validZonesBegin;
+        }
+        zones.erase(zones.begin() + threadZonesBegin, zones.begin() + validZonesBegin);
+
+        // Zones are written when they end, so children are written before their parent
+        std::sort(zones.begin() + threadZonesBegin, zones.end(), [](const Zone& a, const Zone& b) {
+            return a.start < b.start || (a.start == b.start && a.depth < b.depth);
+        });
+    }
+}
+
+} // Namespace System
@@ -1,5 +1,3 @@
-#include <SDL.h> // SDL_GetPerformanceCounter
-
 #include <System/Timer.hpp> // System::Timer
 
 namespace System {
@@ -29,12 +27,12 @@ Timer& Timer::operator=(Timer&& timer) {
 }
 
 void    Timer::reset() {
-    _lastReset = SDL_GetPerformanceCounter();
+    _lastReset = std::chrono::steady_clock::now();
 }
 
 float   Timer::getElapsedTime() const {
-    uint64_t freq = SDL_GetPerformanceFrequency();
-    return static_cast<float>(SDL_GetPerformanceCounter() - _lastReset) / static_cast<float>(freq);
+    std::chrono::duration<float> elapsedTime = std::chrono::steady_clock::now() - _lastReset;
+    return elapsedTime.count();
 }
 
 } // Namespace System
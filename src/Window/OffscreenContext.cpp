@@ -0,0 +1,202 @@
+#include <cstring> // std::strstr
+#include <iostream> // std::cerr
+
+#include <GL/glew.h> // OpenGL functions
+
+#if defined(PLANET_EGL)
+    #include <EGL/egl.h> // EGL functions
+    #include <EGL/eglext.h> // EGL extensions
+
+    // Not defined by old eglext.h
+    #ifndef EGL_PLATFORM_SURFACELESS_MESA
+        #define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+    #endif
+#endif
+
+#include <Window/OffscreenContext.hpp> // Window::OffscreenContext
+
+namespace Window {
+
+OffscreenContext::~OffscreenContext() {
+    destroy();
+}
+
+std::unique_ptr<OffscreenContext> OffscreenContext::create(const glm::ivec2& size) {
+    // Don't use std::make_unique because the constructor is private
+    std::unique_ptr<OffscreenContext> context(new OffscreenContext());
+
+    if (!context->init(size)) {
+        return nullptr;
+    }
+
+    return context;
+}
+
+const glm::ivec2& OffscreenContext::getSize() const {
+    return _size;
+}
+
+bool OffscreenContext::init(const glm::ivec2& size) {
+    _size = size;
+
+#if defined(PLANET_EGL)
+    return initDisplay() && initOpenGL();
+#else
+    // TODO: replace this with logger
+    std::cerr << "OffscreenContext::init: Headless rendering needs EGL, which was not found when building" << std::endl;
+    return false;
+#endif
+}
+
+bool OffscreenContext::initDisplay() {
+#if defined(PLANET_EGL)
+    EGLDisplay display = EGL_NO_DISPLAY;
+
+    // Prefer the surfaceless platform, it does not need any X or wayland server
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions != nullptr &&
+        std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless") != nullptr) {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT")
+        );
+
+        if (getPlatformDisplay != nullptr) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+    }
+
+    if (display == EGL_NO_DISPLAY) {
+        display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        // TODO: replace this with logger
+        std::cerr << "OffscreenContext::initDisplay: Can't init EGL display: error " << eglGetError() << std::endl;
+        return false;
+    }
+
+    _display = display;
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool OffscreenContext::initOpenGL() {
+#if defined(PLANET_EGL)
+    EGLDisplay display = static_cast<EGLDisplay>(_display);
+
+    const EGLint configAttributes[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE
+    };
+
+    EGLConfig config = nullptr;
+    EGLint configsNb = 0;
+    if (!eglChooseConfig(display, configAttributes, &config, 1, &configsNb) || configsNb == 0) {
+        // TODO: replace this with logger
+        std::cerr << "OffscreenContext::initOpenGL: Can't find EGL config: error " << eglGetError() << std::endl;
+        return false;
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        // TODO: replace this with logger
+        std::cerr << "OffscreenContext::initOpenGL: Can't bind OpenGL API: error " << eglGetError() << std::endl;
+        return false;
+    }
+
+    // The shaders use "#version 420 core"
+    const EGLint contextAttributes[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 2,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+
+    _context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+    if (_context == EGL_NO_CONTEXT) {
+        // TODO: replace this with logger
+        std::cerr << "OffscreenContext::initOpenGL: Can't create OpenGL context: error " << eglGetError() << std::endl;
+        return false;
+    }
+
+    // Everything is rendered in framebuffers, so a surface is only needed
+    // if the driver does not support surfaceless contexts
+    const char* displayExtensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (displayExtensions == nullptr ||
+        std::strstr(displayExtensions, "EGL_KHR_surfaceless_context") == nullptr) {
+        const EGLint surfaceAttributes[] = {
+            EGL_WIDTH, 1,
+            EGL_HEIGHT, 1,
+            EGL_NONE
+        };
+
+        _surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+        if (_surface == EGL_NO_SURFACE) {
+            // TODO: replace this with logger
+            std::cerr << "OffscreenContext::initOpenGL: Can't create pbuffer surface: error " << eglGetError() << std::endl;
+            return false;
+        }
+    }
+
+    EGLSurface surface = _surface != nullptr ? static_cast<EGLSurface>(_surface) : EGL_NO_SURFACE;
+    if (!eglMakeCurrent(display, surface, surface, static_cast<EGLContext>(_context))) {
+        // TODO: replace this with logger
+        std::cerr << "OffscreenContext::initOpenGL: Can't make context current: error " << eglGetError() << std::endl;
+        return false;
+    }
+
+    // Init glew
+    // glewInit can't query GLX without display, but the OpenGL functions are still loaded
+    glewExperimental = GL_TRUE;
+    GLenum glewError = glewInit();
+#if defined(GLEW_ERROR_NO_GLX_DISPLAY)
+    if (glewError == GLEW_ERROR_NO_GLX_DISPLAY) {
+        glewError = GLEW_OK;
+    }
+#endif
+    if (glewError != GLEW_OK) {
+        // TODO: replace this with logger
+        std::cerr << "OffscreenContext::initOpenGL: Can't init glew: " << glewGetErrorString(glewError) << std::endl;
+        return false;
+    }
+
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void OffscreenContext::destroy() {
+#if defined(PLANET_EGL)
+    if (_display == nullptr) {
+        return;
+    }
+
+    EGLDisplay display = static_cast<EGLDisplay>(_display);
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if (_context != nullptr) {
+        eglDestroyContext(display, static_cast<EGLContext>(_context));
+        _context = nullptr;
+    }
+
+    if (_surface != nullptr) {
+        eglDestroySurface(display, static_cast<EGLSurface>(_surface));
+        _surface = nullptr;
+    }
+
+    eglTerminate(display);
+    _display = nullptr;
+#endif
+}
+
+} // Namespace Window
@@ -2,7 +2,7 @@
 
 #include <imgui.h> // Imgui functions
 #include <imgui_impl_sdl_gl3.h> // Imgui SDL abstraction functions
-#include <gl/glew.h> // OpenGL functions
+#include <GL/glew.h> // OpenGL functions
 #include <SDL.h> // SDL_Window
 
 #include <Window/Window.hpp> // Window::Window
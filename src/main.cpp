@@ -1,9 +1,21 @@
 #include <Core/Application.hpp> // Core::Application
+#include <Core/BatchApplication.hpp> // Core::BatchApplication
+
+int main(int argc, char** argv){
+    // Headless rendering of planet previews
+    if (Core::BatchApplication::isRequested(argc, argv)) {
+        Core::BatchApplication batchApp;
+
+        if (!batchApp.init(argc, argv)) {
+            return 1;
+        }
+
+        return batchApp.run() ? 0 : 1;
+    }
 
-int main(int, char**){
     Core::Application app;
 
-    if (!app.init()) {
+    if (!app.init(argc, argv)) {
         return 1;
     }
 
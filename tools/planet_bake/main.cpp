@@ -0,0 +1,230 @@
+#include <atomic> // std::atomic
+#include <cstdio> // std::sscanf
+#include <iostream> // std::cerr, std::cout
+#include <memory> // std::unique_ptr
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <glm/geometric.hpp> // glm::normalize
+
+#include <Core/HeightTileCodec.hpp> // Core::HeightTileCodec
+#include <Core/HeightTileSet.hpp> // Core::HeightTileSet
+#include <Core/PlanetPackage.hpp> // Core::PlanetPackage
+#include <Core/TexelFormat.hpp> // Core::TexelFormat
+#include <System/JobSystem.hpp> // System::JobSystem
+#include <System/Timer.hpp> // System::Timer
+
+/*
+ * Bakes a planet package: generates the height map, the gradient map and the min/max pyramid once,
+ * so the application loads them with planet_generator --package FILE
+ * With --tiles, bakes the height tiles of the streamed height map instead (planet_generator --tiles FILE),
+ * each tile is generated at its level so the finest level can be much larger than a package
+ *
+ * Usage:
+ * planet_bake --out FILE [--size SIZE] [--maxHeight HEIGHT] [--faceSize SIZE] [--seed SEED] [--noise fbm|ridged]
+ *             [--octaves OCTAVES] [--frequency FREQUENCY] [--lacunarity LACUNARITY] [--gain GAIN] [--warp STRENGTH]
+ *             [--threads THREADS]
+ * planet_bake --tiles FILE [--tileSize SIZE] [--tileLevels LEVELS] [--tileFormat raw|packed] [--maxError ERROR]
+ *             [height map arguments] [--threads THREADS]
+*/
+
+struct Options {
+    Core::PlanetPackage::Description description;
+    // 0 uses one thread per core
+    uint32_t threadsNb = 0;
+    std::string output;
+
+    Core::HeightTileSet::Description tileSetDescription;
+    std::string tilesOutput;
+};
+
+static bool parseFloat(const char* value, float& number) {
+    return std::sscanf(value, "%f", &number) == 1;
+}
+
+static bool parseUint(const char* value, uint32_t& number) {
+    return std::sscanf(value, "%u", &number) == 1;
+}
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    auto& description = options.description;
+    auto& parameters = description.heightMapParameters;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++i];
+        bool valid = true;
+
+        if (argument == "--size") {
+            valid = parseFloat(value, description.size) && description.size > 0.0f;
+        }
+        else if (argument == "--maxHeight") {
+            valid = parseFloat(value, description.maxHeight);
+        }
+        else if (argument == "--faceSize") {
+            valid = parseUint(value, parameters.size) && parameters.size > 0;
+        }
+        else if (argument == "--seed") {
+            valid = parseUint(value, parameters.seed);
+        }
+        else if (argument == "--noise") {
+            std::string noise = value;
+            valid = noise == "fbm" || noise == "ridged";
+            parameters.noiseType = noise == "ridged" ? Core::HeightMapGenerator::NoiseType::RIDGED : Core::HeightMapGenerator::NoiseType::FBM;
+        }
+        else if (argument == "--octaves") {
+            valid = parseUint(value, parameters.octaves) && parameters.octaves > 0;
+        }
+        else if (argument == "--frequency") {
+            valid = parseFloat(value, parameters.frequency);
+        }
+        else if (argument == "--lacunarity") {
+            valid = parseFloat(value, parameters.lacunarity);
+        }
+        else if (argument == "--gain") {
+            valid = parseFloat(value, parameters.gain);
+        }
+        else if (argument == "--warp") {
+            valid = parseFloat(value, parameters.warpStrength);
+        }
+        else if (argument == "--threads") {
+            valid = parseUint(value, options.threadsNb);
+        }
+        else if (argument == "--out") {
+            options.output = value;
+        }
+        else if (argument == "--tiles") {
+            options.tilesOutput = value;
+        }
+        else if (argument == "--tileSize") {
+            valid = parseUint(value, options.tileSetDescription.tileSize) && options.tileSetDescription.tileSize > 0;
+        }
+        else if (argument == "--tileFormat") {
+            std::string format = value;
+            valid = format == "raw" || format == "packed";
+            options.tileSetDescription.format = format == "raw" ? Core::HeightTileSet::Format::R16 : Core::HeightTileSet::Format::R16_PACKED;
+        }
+        else if (argument == "--maxError") {
+            valid = parseUint(value, options.tileSetDescription.maxError) && options.tileSetDescription.maxError <= Core::HeightTileCodec::maxMaxError;
+        }
+        else if (argument == "--tileLevels") {
+            valid = parseUint(value, options.tileSetDescription.levelsNb) && options.tileSetDescription.levelsNb > 0;
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    if (options.output.empty() && options.tilesOutput.empty()) {
+        std::cerr << "Missing output file (--out FILE or --tiles FILE)" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// The border texels are outside of the face, the noise is evaluated on the sphere so they match the neighbor faces
+static bool bakeTiles(const Options& options, System::JobSystem& jobSystem) {
+    std::unique_ptr<Core::HeightTileSet::Writer> writer = Core::HeightTileSet::Writer::create(options.tilesOutput, options.tileSetDescription);
+    if (writer == nullptr) {
+        return false;
+    }
+
+    Core::HeightMapGenerator generator(options.description.heightMapParameters);
+    const auto& description = writer->getDescription();
+    uint32_t tileTexelsSize = description.tileSize + 2 * description.border;
+    uint32_t texelsNb = writer->getTexelsNb();
+
+    std::atomic<bool> failed(false);
+
+    for (uint32_t level = 0; level < description.levelsNb; ++level) {
+        uint32_t tilesNb = 1u << level;
+        float faceSize = static_cast<float>(description.tileSize << level);
+
+        jobSystem.parallelFor(Core::CubeMap::facesNb * tilesNb * tilesNb, [&](uint32_t job) {
+            Core::CubeMap::Face face = static_cast<Core::CubeMap::Face>(job / (tilesNb * tilesNb));
+            uint32_t x = job % tilesNb;
+            uint32_t y = job / tilesNb % tilesNb;
+
+            std::vector<float> directionsX(texelsNb);
+            std::vector<float> directionsY(texelsNb);
+            std::vector<float> directionsZ(texelsNb);
+            std::vector<float> heights(texelsNb);
+            std::vector<uint16_t> texels(texelsNb);
+
+            for (uint32_t i = 0; i < texelsNb; ++i) {
+                float faceX = static_cast<float>(x * description.tileSize + i % tileTexelsSize) - description.border;
+                float faceY = static_cast<float>(y * description.tileSize + i / tileTexelsSize) - description.border;
+
+                glm::vec3 direction = glm::normalize(Core::CubeMap::getDirection(
+                    face,
+                    2.0f * (faceX + 0.5f) / faceSize - 1.0f,
+                    2.0f * (faceY + 0.5f) / faceSize - 1.0f
+                ));
+
+                directionsX[i] = direction.x;
+                directionsY[i] = direction.y;
+                directionsZ[i] = direction.z;
+            }
+
+            generator.generate(directionsX.data(), directionsY.data(), directionsZ.data(), heights.data(), texelsNb);
+            Core::TexelFormat::encodeHeights(heights.data(), texelsNb, Core::TexelFormat::Height::R16, texels.data());
+
+            if (!writer->writeTile(face, level, x, y, texels.data())) {
+                failed = true;
+            }
+        });
+    }
+
+    return !failed && writer->finish();
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    System::JobSystem jobSystem(options.threadsNb);
+
+    if (!options.tilesOutput.empty()) {
+        System::Timer timer;
+        if (!bakeTiles(options, jobSystem)) {
+            return 1;
+        }
+
+        std::cout << "tiles: " << timer.getElapsedTime() * 1000.0f << " ms" << std::endl;
+
+        if (options.output.empty()) {
+            return 0;
+        }
+    }
+    Core::PlanetPackage::Content content;
+
+    System::Timer timer;
+    Core::PlanetPackage::generate(options.description, jobSystem, content);
+    float generationTime = timer.getElapsedTime();
+
+    timer.reset();
+    if (!Core::PlanetPackage::write(options.output, options.description, content)) {
+        return 1;
+    }
+    float writeTime = timer.getElapsedTime();
+
+    std::cout << "generation: " << generationTime * 1000.0f << " ms" << std::endl;
+    std::cout << "write: " << writeTime * 1000.0f << " ms" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <cstdio> // std::sscanf
+#include <fstream> // std::ofstream
+#include <iomanip> // std::hex, std::setw, std::setfill
+#include <iostream> // std::cerr, std::cout
+#include <string> // std::string
+
+#include <Core/HeightMapGenerator.hpp> // Core::HeightMapGenerator
+#include <System/JobSystem.hpp> // System::JobSystem
+#include <System/Timer.hpp> // System::Timer
+
+/*
+ * Generates the six faces of a procedural height map and prints the generation time
+ *
+ * Usage:
+ * planet_heightmap [--seed SEED] [--size SIZE] [--noise fbm|ridged] [--octaves OCTAVES] [--frequency FREQUENCY]
+ *                  [--lacunarity LACUNARITY] [--gain GAIN] [--warp STRENGTH] [--threads THREADS] [--avx2 0|1]
+ *                  [--out FILE]
+ *
+ * The printed hash of the heights must not change with --threads and --avx2
+ * --out writes the six faces in the cube map order, as raw 32 bits floats
+*/
+
+struct Options {
+    Core::HeightMapGenerator::Parameters parameters;
+    // 0 uses one thread per core
+    uint32_t threadsNb = 0;
+    uint32_t avx2 = 1;
+    std::string output;
+};
+
+static bool parseFloat(const char* value, float& number) {
+    return std::sscanf(value, "%f", &number) == 1;
+}
+
+static bool parseUint(const char* value, uint32_t& number) {
+    return std::sscanf(value, "%u", &number) == 1;
+}
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    auto& parameters = options.parameters;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++i];
+        bool valid = true;
+
+        if (argument == "--seed") {
+            valid = parseUint(value, parameters.seed);
+        }
+        else if (argument == "--size") {
+            valid = parseUint(value, parameters.size) && parameters.size > 0;
+        }
+        else if (argument == "--noise") {
+            std::string noise = value;
+            valid = noise == "fbm" || noise == "ridged";
+            parameters.noiseType = noise == "ridged" ? Core::HeightMapGenerator::NoiseType::RIDGED : Core::HeightMapGenerator::NoiseType::FBM;
+        }
+        else if (argument == "--octaves") {
+            valid = parseUint(value, parameters.octaves) && parameters.octaves > 0;
+        }
+        else if (argument == "--frequency") {
+            valid = parseFloat(value, parameters.frequency);
+        }
+        else if (argument == "--lacunarity") {
+            valid = parseFloat(value, parameters.lacunarity);
+        }
+        else if (argument == "--gain") {
+            valid = parseFloat(value, parameters.gain);
+        }
+        else if (argument == "--warp") {
+            valid = parseFloat(value, parameters.warpStrength);
+        }
+        else if (argument == "--threads") {
+            valid = parseUint(value, options.threadsNb);
+        }
+        else if (argument == "--avx2") {
+            valid = parseUint(value, options.avx2);
+        }
+        else if (argument == "--out") {
+            options.output = value;
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// FNV-1a of the heights bytes
+static uint64_t getHash(const Core::HeightMapGenerator::Faces& faces) {
+    uint64_t hash = 14695981039346656037ull;
+
+    for (const auto& face: faces) {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(face.data());
+        for (size_t i = 0; i < face.size() * sizeof(float); ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    }
+
+    return hash;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    System::JobSystem jobSystem(options.threadsNb);
+    Core::HeightMapGenerator generator(options.parameters);
+    generator.setAVX2Enabled(options.avx2 != 0);
+
+    Core::HeightMapGenerator::Faces faces;
+
+    System::Timer timer;
+    generator.generate(faces, jobSystem);
+    float elapsedTime = timer.getElapsedTime();
+
+    uint64_t texelsNb = static_cast<uint64_t>(options.parameters.size) * options.parameters.size * Core::CubeMap::facesNb;
+
+    std::cout << "faces: 6x" << options.parameters.size << "x" << options.parameters.size << std::endl;
+    std::cout << "threads: " << jobSystem.getThreadsNb() << std::endl;
+    std::cout << "avx2: " << (generator.isAVX2Enabled() ? "yes" : "no") << std::endl;
+    std::cout << "generation: " << elapsedTime * 1000.0f << " ms" << std::endl;
+    std::cout << "texels/s: " << texelsNb / elapsedTime << std::endl;
+    std::cout << "hash: " << std::hex << std::setw(16) << std::setfill('0') << getHash(faces) << std::endl;
+
+    if (options.output.empty()) {
+        return 0;
+    }
+
+    std::ofstream file(options.output, std::ios::binary);
+    if (!file.good()) {
+        std::cerr << "Can't open \"" << options.output << "\"" << std::endl;
+        return 1;
+    }
+
+    for (const auto& face: faces) {
+        file.write(reinterpret_cast<const char*>(face.data()), face.size() * sizeof(float));
+    }
+
+    return file.good() ? 0 : 1;
+}
@@ -0,0 +1,437 @@
+#include <algorithm> // std::min, std::max
+#include <atomic> // std::atomic
+#include <cmath> // std::atan2, std::asin, std::floor
+#include <cstdio> // std::sscanf
+#include <iostream> // std::cerr, std::cout
+#include <memory> // std::unique_ptr
+#include <mutex> // std::mutex, std::lock_guard
+#include <string> // std::string
+#include <vector> // std::vector
+
+#include <glm/geometric.hpp> // glm::normalize
+#include <glm/gtc/constants.hpp> // glm::pi
+
+#include <Core/HeightTileCodec.hpp> // Core::HeightTileCodec
+#include <Core/HeightTileSet.hpp> // Core::HeightTileSet
+#include <System/MappedFile.hpp> // System::MappedFile
+#include <System/JobSystem.hpp> // System::JobSystem
+#include <System/Timer.hpp> // System::Timer
+
+/*
+ * Builds the height tiles of the streamed height map (planet_generator --tiles FILE) from a raw 16 bits raster
+ * larger than the memory
+ *
+ * The raster is an equirectangular projection of the whole planet: the first row is the north pole,
+ * the first column is the longitude -180°. It's memory mapped, so only the rows being sampled are read.
+ * The heights are normalized with the min and max heights of the raster
+ *
+ * The tiles of the finest level are sampled from the raster, border included, and the coarser levels are
+ * downsampled from them. Each thread builds a subtree depth first, so it only keeps 4 tiles per level in memory
+ * The borders of the coarser levels are clamped
+ *
+ * Usage:
+ * planet_ingest --in FILE --width WIDTH --height HEIGHT --out FILE [--signed 0|1] [--bigEndian 0|1]
+ *               [--tileSize SIZE] [--tileLevels LEVELS] [--tileFormat raw|packed] [--maxError ERROR] [--threads THREADS]
+ *
+ * The tiles are compressed with Core::HeightTileCodec by default, --maxError is the max error of the 16 bits heights
+ * Without --tileLevels, the finest level has at least the resolution of the raster at the equator
+*/
+
+struct Options {
+    std::string input;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t isSigned = 0;
+    uint32_t bigEndian = 0;
+
+    // 0 levels are computed from the raster width
+    Core::HeightTileSet::Description description = {256, 1, 0, Core::HeightTileSet::Format::R16_PACKED, 0};
+    // 0 uses one thread per core
+    uint32_t threadsNb = 0;
+    std::string output;
+};
+
+struct Raster {
+    const uint16_t* texels;
+    uint32_t width;
+    uint32_t height;
+    bool isSigned;
+    bool bigEndian;
+
+    float minHeight;
+    float maxHeight;
+};
+
+// Tiles built by the subtrees and kept to build the coarser levels
+struct Level {
+    uint32_t tilesNb;
+    std::vector<std::vector<uint16_t>> tiles;
+};
+
+static bool parseUint(const char* value, uint32_t& number) {
+    return std::sscanf(value, "%u", &number) == 1;
+}
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++i];
+        bool valid = true;
+
+        if (argument == "--in") {
+            options.input = value;
+        }
+        else if (argument == "--width") {
+            valid = parseUint(value, options.width) && options.width > 0;
+        }
+        else if (argument == "--height") {
+            valid = parseUint(value, options.height) && options.height > 0;
+        }
+        else if (argument == "--signed") {
+            valid = parseUint(value, options.isSigned);
+        }
+        else if (argument == "--bigEndian") {
+            valid = parseUint(value, options.bigEndian);
+        }
+        else if (argument == "--tileSize") {
+            // Even, so a tile is downsampled in a quarter of its parent
+            valid = parseUint(value, options.description.tileSize) && options.description.tileSize >= 2 &&
+                options.description.tileSize % 2 == 0;
+        }
+        else if (argument == "--tileFormat") {
+            std::string format = value;
+            valid = format == "raw" || format == "packed";
+            options.description.format = format == "raw" ? Core::HeightTileSet::Format::R16 : Core::HeightTileSet::Format::R16_PACKED;
+        }
+        else if (argument == "--maxError") {
+            valid = parseUint(value, options.description.maxError) && options.description.maxError <= Core::HeightTileCodec::maxMaxError;
+        }
+        else if (argument == "--tileLevels") {
+            valid = parseUint(value, options.description.levelsNb) && options.description.levelsNb > 0;
+        }
+        else if (argument == "--threads") {
+            valid = parseUint(value, options.threadsNb);
+        }
+        else if (argument == "--out") {
+            options.output = value;
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    if (options.input.empty() || options.output.empty() || options.width == 0 || options.height == 0) {
+        std::cerr << "Missing argument (--in FILE --width WIDTH --height HEIGHT --out FILE)" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+static float getRasterHeight(const Raster& raster, uint32_t x, uint32_t y) {
+    uint16_t value = raster.texels[static_cast<size_t>(y) * raster.width + x];
+
+    if (raster.bigEndian) {
+        value = static_cast<uint16_t>((value >> 8) | (value << 8));
+    }
+
+    return raster.isSigned ? static_cast<float>(static_cast<int16_t>(value)) : static_cast<float>(value);
+}
+
+// The rows are read in parallel by blocks of 16, the pages are released by the OS when the memory is needed
+static void computeHeightRange(Raster& raster, System::JobSystem& jobSystem) {
+    std::mutex mutex;
+    raster.minHeight = 65535.0f;
+    raster.maxHeight = -65535.0f;
+
+    jobSystem.parallelFor(raster.height, [&raster, &mutex](uint32_t y) {
+        float minHeight = 65535.0f;
+        float maxHeight = -65535.0f;
+
+        for (uint32_t x = 0; x < raster.width; ++x) {
+            float height = getRasterHeight(raster, x, y);
+            minHeight = std::min(minHeight, height);
+            maxHeight = std::max(maxHeight, height);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        raster.minHeight = std::min(raster.minHeight, minHeight);
+        raster.maxHeight = std::max(raster.maxHeight, maxHeight);
+    }, 16);
+}
+
+// Bilinear sample of the raster, normalized to [0, 65535]
+static uint16_t sampleRaster(const Raster& raster, const glm::vec3& direction) {
+    float longitude = std::atan2(direction.z, direction.x);
+    float latitude = std::asin(std::min(std::max(direction.y, -1.0f), 1.0f));
+
+    float u = (longitude / (2.0f * glm::pi<float>()) + 0.5f) * raster.width - 0.5f;
+    float v = (0.5f - latitude / glm::pi<float>()) * raster.height - 0.5f;
+    v = std::min(std::max(v, 0.0f), static_cast<float>(raster.height - 1));
+
+    float u0 = std::floor(u);
+    float v0 = std::floor(v);
+    float fu = u - u0;
+    float fv = v - v0;
+
+    // The longitude wraps, the latitude is clamped
+    int32_t width = static_cast<int32_t>(raster.width);
+    uint32_t x0 = static_cast<uint32_t>((static_cast<int32_t>(u0) % width + width) % width);
+    uint32_t x1 = (x0 + 1) % raster.width;
+    uint32_t y0 = static_cast<uint32_t>(v0);
+    uint32_t y1 = std::min(y0 + 1, raster.height - 1);
+
+    float top = getRasterHeight(raster, x0, y0) * (1.0f - fu) + getRasterHeight(raster, x1, y0) * fu;
+    float bottom = getRasterHeight(raster, x0, y1) * (1.0f - fu) + getRasterHeight(raster, x1, y1) * fu;
+    float height = top * (1.0f - fv) + bottom * fv;
+
+    float range = std::max(raster.maxHeight - raster.minHeight, 1.0f);
+    return static_cast<uint16_t>((height - raster.minHeight) / range * 65535.0f + 0.5f);
+}
+
+// Tile of the finest level, the border is sampled too so the tiles match on the edges, even between faces
+static void sampleTile(
+    const Raster& raster,
+    const Core::HeightTileSet::Description& description,
+    Core::CubeMap::Face face,
+    uint32_t level,
+    uint32_t x,
+    uint32_t y,
+    std::vector<uint16_t>& texels
+) {
+    uint32_t tileTexelsSize = description.tileSize + 2 * description.border;
+    float faceSize = static_cast<float>(description.tileSize << level);
+
+    texels.resize(static_cast<size_t>(tileTexelsSize) * tileTexelsSize);
+
+    for (uint32_t i = 0; i < tileTexelsSize * tileTexelsSize; ++i) {
+        float faceX = static_cast<float>(x * description.tileSize + i % tileTexelsSize) - description.border;
+        float faceY = static_cast<float>(y * description.tileSize + i / tileTexelsSize) - description.border;
+
+        glm::vec3 direction = glm::normalize(Core::CubeMap::getDirection(
+            face,
+            2.0f * (faceX + 0.5f) / faceSize - 1.0f,
+            2.0f * (faceY + 0.5f) / faceSize - 1.0f
+        ));
+
+        texels[i] = sampleRaster(raster, direction);
+    }
+}
+
+// Box filter of the child in its quarter of the parent interior
+static void downsample(
+    const Core::HeightTileSet::Description& description,
+    const std::vector<uint16_t>& child,
+    uint32_t childX,
+    uint32_t childY,
+    std::vector<uint16_t>& parent
+) {
+    uint32_t size = description.tileSize;
+    uint32_t halfSize = size / 2;
+
+    for (uint32_t y = 0; y < halfSize; ++y) {
+        const uint16_t* row0 = child.data() + static_cast<size_t>(2 * y) * size;
+        const uint16_t* row1 = row0 + size;
+        uint16_t* dst = parent.data() + static_cast<size_t>(childY * halfSize + y) * size + childX * halfSize;
+
+        for (uint32_t x = 0; x < halfSize; ++x) {
+            uint32_t sum = row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1];
+            dst[x] = static_cast<uint16_t>((sum + 2) / 4);
+        }
+    }
+}
+
+// Add the clamped border to the interior and write the tile
+static bool writeInterior(
+    Core::HeightTileSet::Writer& writer,
+    Core::CubeMap::Face face,
+    uint32_t level,
+    uint32_t x,
+    uint32_t y,
+    const std::vector<uint16_t>& interior,
+    std::vector<uint16_t>& texels
+) {
+    const auto& description = writer.getDescription();
+    uint32_t tileTexelsSize = description.tileSize + 2 * description.border;
+    int32_t last = static_cast<int32_t>(description.tileSize) - 1;
+
+    texels.resize(static_cast<size_t>(tileTexelsSize) * tileTexelsSize);
+
+    for (uint32_t j = 0; j < tileTexelsSize; ++j) {
+        int32_t interiorY = std::min(std::max(static_cast<int32_t>(j) - static_cast<int32_t>(description.border), 0), last);
+
+        for (uint32_t i = 0; i < tileTexelsSize; ++i) {
+            int32_t interiorX = std::min(std::max(static_cast<int32_t>(i) - static_cast<int32_t>(description.border), 0), last);
+            texels[static_cast<size_t>(j) * tileTexelsSize + i] = interior[static_cast<size_t>(interiorY) * description.tileSize + interiorX];
+        }
+    }
+
+    return writer.writeTile(face, level, x, y, texels.data());
+}
+
+// Build and write the tile and its subtree, depth first, interior receives the tile without its border
+static bool buildSubtree(
+    const Raster& raster,
+    Core::HeightTileSet::Writer& writer,
+    Core::CubeMap::Face face,
+    uint32_t level,
+    uint32_t x,
+    uint32_t y,
+    std::vector<uint16_t>& interior
+) {
+    const auto& description = writer.getDescription();
+    size_t interiorTexelsNb = static_cast<size_t>(description.tileSize) * description.tileSize;
+    interior.resize(interiorTexelsNb);
+
+    std::vector<uint16_t> texels;
+
+    if (level + 1 == description.levelsNb) {
+        sampleTile(raster, description, face, level, x, y, texels);
+
+        uint32_t tileTexelsSize = description.tileSize + 2 * description.border;
+        for (uint32_t j = 0; j < description.tileSize; ++j) {
+            const uint16_t* src = texels.data() + static_cast<size_t>(j + description.border) * tileTexelsSize + description.border;
+            std::copy(src, src + description.tileSize, interior.begin() + static_cast<size_t>(j) * description.tileSize);
+        }
+
+        return writer.writeTile(face, level, x, y, texels.data());
+    }
+
+    std::vector<uint16_t> child;
+    for (uint32_t i = 0; i < 4; ++i) {
+        if (!buildSubtree(raster, writer, face, level + 1, 2 * x + i % 2, 2 * y + i / 2, child)) {
+            return false;
+        }
+
+        downsample(description, child, i % 2, i / 2, interior);
+    }
+
+    return writeInterior(writer, face, level, x, y, interior, texels);
+}
+
+static bool ingest(const Raster& raster, Core::HeightTileSet::Writer& writer, System::JobSystem& jobSystem) {
+    const auto& description = writer.getDescription();
+
+    // Enough subtrees to keep the threads busy, their roots are kept to build the coarser levels
+    uint32_t splitLevel = 0;
+    while (splitLevel + 1 < description.levelsNb && Core::CubeMap::facesNb * (1u << (2 * splitLevel)) < 4 * jobSystem.getThreadsNb()) {
+        ++splitLevel;
+    }
+
+    Level level;
+    level.tilesNb = 1u << splitLevel;
+    level.tiles.resize(Core::CubeMap::facesNb * level.tilesNb * level.tilesNb);
+
+    std::atomic<bool> failed(false);
+    jobSystem.parallelFor(static_cast<uint32_t>(level.tiles.size()), [&](uint32_t job) {
+        Core::CubeMap::Face face = static_cast<Core::CubeMap::Face>(job / (level.tilesNb * level.tilesNb));
+        uint32_t x = job % level.tilesNb;
+        uint32_t y = job / level.tilesNb % level.tilesNb;
+
+        if (!buildSubtree(raster, writer, face, splitLevel, x, y, level.tiles[job])) {
+            failed = true;
+        }
+    });
+
+    // Levels above the subtrees
+    std::vector<uint16_t> texels;
+    for (uint32_t levelId = splitLevel; levelId-- > 0 && !failed;) {
+        Level parentLevel;
+        parentLevel.tilesNb = level.tilesNb / 2;
+        parentLevel.tiles.resize(Core::CubeMap::facesNb * parentLevel.tilesNb * parentLevel.tilesNb);
+
+        for (uint32_t tile = 0; tile < parentLevel.tiles.size(); ++tile) {
+            uint32_t face = tile / (parentLevel.tilesNb * parentLevel.tilesNb);
+            uint32_t x = tile % parentLevel.tilesNb;
+            uint32_t y = tile / parentLevel.tilesNb % parentLevel.tilesNb;
+
+            std::vector<uint16_t>& interior = parentLevel.tiles[tile];
+            interior.resize(static_cast<size_t>(description.tileSize) * description.tileSize);
+
+            for (uint32_t i = 0; i < 4; ++i) {
+                uint32_t childX = 2 * x + i % 2;
+                uint32_t childY = 2 * y + i / 2;
+                const auto& child = level.tiles[(face * level.tilesNb + childY) * level.tilesNb + childX];
+
+                downsample(description, child, i % 2, i / 2, interior);
+            }
+
+            if (!writeInterior(writer, static_cast<Core::CubeMap::Face>(face), levelId, x, y, interior, texels)) {
+                failed = true;
+            }
+        }
+
+        level = std::move(parentLevel);
+    }
+
+    return !failed && writer.finish();
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    std::unique_ptr<System::MappedFile> file = System::MappedFile::create(options.input);
+    if (file == nullptr) {
+        return 1;
+    }
+
+    if (file->getSize() < static_cast<size_t>(options.width) * options.height * sizeof(uint16_t)) {
+        std::cerr << "\"" << options.input << "\" is smaller than " << options.width << "x" << options.height << " 16 bits texels" << std::endl;
+        return 1;
+    }
+
+    Raster raster;
+    raster.texels = static_cast<const uint16_t*>(file->getData());
+    raster.width = options.width;
+    raster.height = options.height;
+    raster.isSigned = options.isSigned != 0;
+    raster.bigEndian = options.bigEndian != 0;
+
+    // The equator of the raster is 4 faces wide
+    auto& description = options.description;
+    if (description.levelsNb == 0) {
+        description.levelsNb = 1;
+        while ((description.tileSize << (description.levelsNb - 1)) * 4 < raster.width && description.levelsNb < 16) {
+            ++description.levelsNb;
+        }
+    }
+
+    std::unique_ptr<Core::HeightTileSet::Writer> writer = Core::HeightTileSet::Writer::create(options.output, description);
+    if (writer == nullptr) {
+        return 1;
+    }
+
+    System::JobSystem jobSystem(options.threadsNb);
+
+    System::Timer timer;
+    computeHeightRange(raster, jobSystem);
+    float rangeTime = timer.getElapsedTime();
+
+    timer.reset();
+    if (!ingest(raster, *writer, jobSystem)) {
+        return 1;
+    }
+    float ingestTime = timer.getElapsedTime();
+
+    std::cout << "heights: [" << raster.minHeight << ", " << raster.maxHeight << "]" << std::endl;
+    std::cout << "levels: " << description.levelsNb << ", finest face size: " << (description.tileSize << (description.levelsNb - 1)) << std::endl;
+    std::cout << "height range: " << rangeTime * 1000.0f << " ms" << std::endl;
+    std::cout << "tiles: " << ingestTime * 1000.0f << " ms" << std::endl;
+
+    return 0;
+}
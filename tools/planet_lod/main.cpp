@@ -0,0 +1,116 @@
+#include <cstdio> // std::sscanf
+#include <memory> // std::unique_ptr
+#include <iostream> // std::cerr, std::cout
+#include <string> // std::string
+
+#include <glm/vec3.hpp> // glm::vec3
+
+#include <Core/SphereQuadTree.hpp> // Core::SphereQuadTree
+#include <Graphics/Camera.hpp> // Graphics::Camera
+#include <System/Timer.hpp> // System::Timer
+
+/*
+ * Runs the level of detail selection of a planet for one camera, without OpenGL
+ *
+ * Usage:
+ * planet_lod [--size SIZE] [--maxHeight HEIGHT] [--pos X,Y,Z] [--lookAt X,Y,Z] [--fov FOV] [--aspect ASPECT]
+*/
+
+struct Options {
+    float size = 100.0f;
+    float maxHeight = 20.0f;
+
+    glm::vec3 pos = {0.0f, 0.0f, 150.0f};
+    glm::vec3 lookAt = {0.0f, 0.0f, 0.0f};
+    float fov = 45.0f;
+    float aspect = 16.0f / 9.0f;
+};
+
+static bool parseVec3(const char* value, glm::vec3& vec) {
+    return std::sscanf(value, "%f,%f,%f", &vec.x, &vec.y, &vec.z) == 3;
+}
+
+static bool parseFloat(const char* value, float& number) {
+    return std::sscanf(value, "%f", &number) == 1;
+}
+
+static bool parseArguments(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        const char* value = argv[++i];
+        bool valid = true;
+
+        if (argument == "--size") {
+            valid = parseFloat(value, options.size) && options.size > 0.0f;
+        }
+        else if (argument == "--maxHeight") {
+            valid = parseFloat(value, options.maxHeight);
+        }
+        else if (argument == "--pos") {
+            valid = parseVec3(value, options.pos);
+        }
+        else if (argument == "--lookAt") {
+            valid = parseVec3(value, options.lookAt);
+        }
+        else if (argument == "--fov") {
+            valid = parseFloat(value, options.fov);
+        }
+        else if (argument == "--aspect") {
+            valid = parseFloat(value, options.aspect) && options.aspect > 0.0f;
+        }
+        else {
+            std::cerr << "Unknown argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+
+        if (!valid) {
+            std::cerr << "Invalid value \"" << value << "\" for argument \"" << argument << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    if (options.pos == options.lookAt) {
+        std::cerr << "Camera position and look at position can't be the same" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        return 1;
+    }
+
+    Graphics::Camera camera;
+    camera.setNear(1.0f);
+    camera.setFar(9999999.0f);
+    camera.setFov(options.fov);
+    camera.setAspect(options.aspect);
+    camera.setPos(options.pos);
+    camera.lookAt(options.lookAt);
+
+    std::unique_ptr<Core::SphereQuadTree> planet = Core::SphereQuadTree::create(options.size, options.maxHeight);
+    if (planet == nullptr) {
+        std::cerr << "Failed to create planet" << std::endl;
+        return 1;
+    }
+
+    System::Timer timer;
+    planet->update(camera);
+    float elapsedTime = timer.getElapsedTime();
+
+    const auto& mesh = planet->getMesh();
+    std::cout << "vertices: " << mesh.vertices.size() << std::endl;
+    std::cout << "triangles: " << mesh.indices.size() / 3 << std::endl;
+    std::cout << "update: " << elapsedTime * 1000.0f << " ms" << std::endl;
+
+    return 0;
+}